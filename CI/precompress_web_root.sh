@@ -0,0 +1,74 @@
+#!/bin/bash
+
+# Precompresses the static files in a web root so that HTTPServer can send them compressed,
+# i.e. 'app.js.gz' and 'app.js.br' are created next to 'app.js'. Run it on the web root before
+# building the file system image.
+#
+# Usage: precompress_web_root.sh <web_root> [extension ...]
+#
+# Only files with the given extensions, or a default set of text based formats, are compressed.
+# Files containing template keys ('{{') are skipped as their content is only known when served.
+# Compressed versions that aren't smaller than the original are removed again.
+# Brotli versions are only created when the 'brotli' tool is available.
+
+set -e
+
+if [ -z "$1" ] || [ ! -d "$1" ]; then
+    echo "Usage: $0 <web_root> [extension ...]" >&2
+    exit 1
+fi
+
+web_root="$1"
+shift
+
+extensions=("$@")
+
+if [ ${#extensions[@]} -eq 0 ]; then
+    extensions=(html htm css js mjs json map svg txt xml csv wasm)
+fi
+
+has_brotli=0
+command -v brotli > /dev/null && has_brotli=1
+
+keep_if_smaller() {
+    if [ "$(stat -c %s "$2")" -ge "$(stat -c %s "$1")" ]; then
+        rm "$2"
+    fi
+}
+
+original=0
+compressed=0
+
+for ext in "${extensions[@]}"; do
+    while IFS= read -r -d '' file; do
+        rm -f "$file.gz" "$file.br"
+
+        if grep -q '{{' "$file"; then
+            echo "Skipping template: $file"
+            continue
+        fi
+
+        gzip -9 -n -c "$file" > "$file.gz"
+        keep_if_smaller "$file" "$file.gz"
+
+        if [ $has_brotli -eq 1 ]; then
+            brotli -q 11 -c "$file" > "$file.br"
+            keep_if_smaller "$file" "$file.br"
+        fi
+
+        size=$(stat -c %s "$file")
+        smallest=$size
+
+        for encoded in "$file.br" "$file.gz"; do
+            if [ -f "$encoded" ] && [ "$(stat -c %s "$encoded")" -lt $smallest ]; then
+                smallest=$(stat -c %s "$encoded")
+            fi
+        done
+
+        original=$((original + size))
+        compressed=$((compressed + smallest))
+        echo "$file: $size -> $smallest bytes"
+    done < <(find "$web_root" -type f -name "*.$ext" -print0)
+done
+
+echo "Total: $original -> $compressed bytes"
@@ -21,15 +21,20 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/application/network/http/HTTPProtocol.cpp
         ${smooth_dir}/application/network/http/HTTPServerClient.cpp
         ${smooth_dir}/application/network/http/http_utils.cpp
+        ${smooth_dir}/application/network/http/ResponseBody.cpp
         ${smooth_dir}/application/network/http/regular/HTTPHeaderDef.cpp
+        ${smooth_dir}/application/network/http/regular/HTTPHeaderParser.cpp
         ${smooth_dir}/application/network/http/regular/HTTPPacket.cpp
         ${smooth_dir}/application/network/http/regular/HTTPRequestHandler.cpp
         ${smooth_dir}/application/network/http/regular/MIMEParser.cpp
         ${smooth_dir}/application/network/http/regular/RegularHTTPProtocol.cpp
+        ${smooth_dir}/application/network/http/regular/responses/ChunkedResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/ErrorResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/FileContentResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/HeaderOnlyResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/StringResponse.cpp
+        ${smooth_dir}/application/network/http/regular/responses/TemplateResponse.cpp
+        ${smooth_dir}/application/network/http/regular/StaticFileCache.cpp
         ${smooth_dir}/application/network/http/regular/TemplateProcessor.cpp
         ${smooth_dir}/application/network/http/URLEncoding.cpp
         ${smooth_dir}/application/network/http/websocket/responses/WSResponse.cpp
@@ -66,6 +71,7 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/application/security/PasswordHash.cpp
         ${smooth_dir}/core/Application.cpp
         ${smooth_dir}/core/filesystem/File.cpp
+        ${smooth_dir}/core/filesystem/FileReader.cpp
         ${smooth_dir}/core/filesystem/filesystem.cpp
         ${smooth_dir}/core/filesystem/FSLock.cpp
         ${smooth_dir}/core/filesystem/MMCSDCard.cpp
@@ -86,10 +92,17 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/core/json/JsonFile.cpp
         ${smooth_dir}/core/logging/log.cpp
         ${smooth_dir}/core/network/CommonSocket.cpp
+        ${smooth_dir}/core/network/DatagramBatch.cpp
+        ${smooth_dir}/core/network/DnsCache.cpp
+        ${smooth_dir}/core/network/DnsResolver.cpp
+        ${smooth_dir}/core/network/FileRegion.cpp
         ${smooth_dir}/core/network/IPv4.cpp
         ${smooth_dir}/core/network/IPv6.cpp
         ${smooth_dir}/core/network/MbedTLSContext.cpp
+        ${smooth_dir}/core/network/MbedTLSShared.cpp
         ${smooth_dir}/core/network/SocketDispatcher.cpp
+        ${smooth_dir}/core/network/TlsBio.cpp
+        ${smooth_dir}/core/network/TlsHandshakeWorker.cpp
         ${smooth_dir}/core/network/Wifi.cpp
         ${smooth_dir}/core/sntp/Sntp.cpp
         ${smooth_dir}/core/SystemStatistics.cpp
@@ -119,11 +132,15 @@ set(SMOOTH_SOURCES
         ${smooth_inc_dir}/application/network/http/HTTPServerConfig.h
         ${smooth_inc_dir}/application/network/http/http_utils.h
         ${smooth_inc_dir}/application/network/http/IResponseOperation.h
+        ${smooth_inc_dir}/application/network/http/ResponseBody.h
         ${smooth_inc_dir}/application/network/http/regular/ITemplateDataRetriever.h
         ${smooth_inc_dir}/application/network/http/regular/RegularHTTPProtocol.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/ChunkedResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/ErrorResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/FileContentResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/StringResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/TemplateResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/StaticFileCache.h
         ${smooth_inc_dir}/application/network/http/regular/TemplateProcessor.h
         ${smooth_inc_dir}/application/network/http/URLEncoding.h
         ${smooth_inc_dir}/application/network/http/websocket/WebsocketProtocol.h
@@ -168,6 +185,7 @@ set(SMOOTH_SOURCES
         ${smooth_inc_dir}/application/network/mqtt/state/StartupState.h
         ${smooth_inc_dir}/application/network/mqtt/Subscription.h
         ${smooth_inc_dir}/application/security/PasswordHash.h
+        ${smooth_inc_dir}/core/filesystem/FileReader.h
         ${smooth_inc_dir}/core/filesystem/MMCSDCard.h
         ${smooth_inc_dir}/core/filesystem/MountPoint.h
         ${smooth_inc_dir}/core/filesystem/Path.h
@@ -95,6 +95,16 @@ namespace smooth::application::network::http
                                                         *this);
     }
 
+    int HTTPProtocol::read_buffered(uint8_t* target, int max_length)
+    {
+        return regular ? regular->read_buffered(target, max_length) : websocket->read_buffered(target, max_length);
+    }
+
+    bool HTTPProtocol::has_buffered_data() const
+    {
+        return regular ? regular->has_buffered_data() : websocket->has_buffered_data();
+    }
+
     void HTTPProtocol::upgrade_to_websocket()
     {
         regular.reset();
@@ -63,13 +63,19 @@ namespace smooth::application::network::http
             {
                 HTTPPacket p{ data };
                 auto& tx = this->container->get_tx_buffer();
-                tx.put(p);
+
+                if (tx.put(p) && res == ResponseStatus::HasMoreData)
+                {
+                    current_operation->prepare_next(content_chunk_size);
+                }
             }
         }
         else
         {
             send_first_part();
         }
+
+        handle_deferred_requests();
     }
 
     void HTTPServerClient::disconnected()
@@ -85,6 +91,7 @@ namespace smooth::application::network::http
     {
         operations.clear();
         current_operation.reset();
+        deferred_requests = 0;
         mode = Mode::HTTP;
         ws_server.reset();
     }
@@ -204,7 +211,8 @@ namespace smooth::application::network::http
 
         do
         {
-            if (!operations.empty())
+            // When the transmit buffer is full, wait for it to empty rather than losing the response.
+            if (!operations.empty() && !this->container->get_tx_buffer().is_full())
             {
                 current_operation = std::move(operations.front());
                 operations.pop_front();
@@ -212,7 +220,15 @@ namespace smooth::application::network::http
                 const auto& headers = current_operation->get_headers();
 
                 std::vector<uint8_t> data{};
-                res = current_operation->get_data(content_chunk_size, data);
+                std::shared_ptr<core::network::FileRegion> file{};
+
+                if (mode == Mode::HTTP && this->socket->can_send_file())
+                {
+                    // Let the socket send the file content, if any, directly from the file system.
+                    file = current_operation->get_file_region();
+                }
+
+                res = file ? ResponseStatus::LastData : current_operation->get_data(content_chunk_size, data);
 
                 if (res == ResponseStatus::Error)
                 {
@@ -228,6 +244,7 @@ namespace smooth::application::network::http
                     {
                         // Whether or not everything is sent, send the current (possibly header-only) packet.
                         HTTPPacket p{ current_operation->get_response_code(), "1.1", headers, data };
+                        p.set_file_region(std::move(file));
                         buffer_consumed_data = tx.put(p);
                     }
                     else
@@ -241,110 +258,112 @@ namespace smooth::application::network::http
                     {
                         current_operation.reset();
                     }
+                    else if (res == ResponseStatus::HasMoreData)
+                    {
+                        current_operation->prepare_next(content_chunk_size);
+                    }
+                    else if (res == ResponseStatus::LastData && !tx.is_full())
+                    {
+                        // The response has been fully queued, so responses to pipelined requests can follow
+                        // right away instead of waiting for the transmit buffer to empty.
+                        current_operation.reset();
+                        res = ResponseStatus::NoData;
+                    }
                 }
             }
         }
         while (!operations.empty()
-               && res == ResponseStatus::NoData); // Process next operation as long as no data is sent.
+               && res == ResponseStatus::NoData); // Process next operation as long as nothing is left to send.
     }
 
-    bool HTTPServerClient::translate_method(
-        const smooth::application::network::http::HTTPPacket& packet,
-        smooth::application::network::http::HTTPMethod& method) const
+    void HTTPServerClient::set_keep_alive()
     {
-        auto res = true;
-
-        // HTTP verbs are case sensitive: https://tools.ietf.org/html/rfc7230#section-3.1.1
-        if (packet.get_request_method() == "POST")
-        {
-            method = HTTPMethod::POST;
-        }
-        else if (packet.get_request_method() == "GET")
-        {
-            method = HTTPMethod::GET;
-        }
-        else if (packet.get_request_method() == "DELETE")
+        if (string_util::icontains(request_headers.get(CONNECTION), "keep-alive"))
         {
-            method = HTTPMethod::DELETE;
+            this->socket->set_receive_timeout(DefaultKeepAlive);
         }
-        else if (packet.get_request_method() == "HEAD")
-        {
-            method = HTTPMethod::HEAD;
-        }
-        else if (packet.get_request_method() == "PUT")
+    }
+
+    void HTTPServerClient::http_event(const core::network::event::DataAvailableEvent<HTTPProtocol>& event)
+    {
+        if (deferred_requests > 0 || !operations.empty())
         {
-            method = HTTPMethod::PUT;
+            // Responses are waiting for the transmit buffer, i.e. the client is pipelining requests faster
+            // than the responses can be sent. Leave the request in the receive buffer, which in turn stops
+            // reading from the socket once full, rather than queuing up responses.
+            ++deferred_requests;
         }
         else
         {
-            res = false;
-        }
+            typename HTTPProtocol::packet_type packet;
 
-        return res;
+            if (event.get(packet))
+            {
+                handle_request(packet);
+            }
+        }
     }
 
-    void HTTPServerClient::set_keep_alive()
+    void HTTPServerClient::handle_deferred_requests()
     {
-        auto connection = request_headers.find("connection");
+        auto& rx = this->container->get_rx_buffer();
 
-        if (connection != request_headers.end())
+        while (mode == Mode::HTTP && deferred_requests > 0 && operations.empty())
         {
-            auto s = (*connection).second;
+            --deferred_requests;
+
+            // Packets are taken in the order they were received, regardless of which event announced them.
+            typename HTTPProtocol::packet_type packet;
 
-            if (string_util::icontains(s, "keep-alive"))
+            if (rx.get(packet))
             {
-                this->socket->set_receive_timeout(DefaultKeepAlive);
+                handle_request(packet);
             }
         }
     }
 
-    void HTTPServerClient::http_event(const core::network::event::DataAvailableEvent<HTTPProtocol>& event)
+    void HTTPServerClient::handle_request(HTTPPacket& packet)
     {
-        typename HTTPProtocol::packet_type packet;
+        bool first_packet = !packet.is_continuation();
+        bool last_packet = !packet.is_continued();
 
-        if (event.get(packet))
-        {
-            bool first_packet = !packet.is_continuation();
-            bool last_packet = !packet.is_continued();
+        bool res = true;
 
-            bool res = true;
+        if (first_packet)
+        {
+            // First packet, parse URL etc.
+            request_headers.clear();
+            std::swap(request_headers, packet.headers());
+            requested_url = packet.get_request_url();
+            res = parse_url(requested_url);
+            set_keep_alive();
+        }
 
-            if (first_packet)
-            {
-                // First packet, parse URL etc.
-                request_headers.clear();
-                std::swap(request_headers, packet.headers());
-                requested_url = packet.get_request_url();
-                res = parse_url(requested_url);
-                set_keep_alive();
-            }
+        if (res)
+        {
+            auto* context = this->get_client_context();
 
-            if (res)
+            if (context)
             {
-                auto* context = this->get_client_context();
+                auto method = packet.get_request_method();
 
-                if (context)
+                if (method)
                 {
-                    HTTPMethod method{};
-
-                    if (translate_method(packet, method))
-                    {
-                        context->handle(method,
-                                        *this,
-                                        *this,
-                                        requested_url,
-                                        request_headers,
-                                        request_parameters,
-                                        packet.get_buffer(),
-                                        first_packet,
-                                        last_packet);
-                    }
-                    else
-                    {
-                        // Unsupported method.
-                        reply(std::make_unique<regular::responses::StringResponse>(ResponseCode::Method_Not_Allowed),
-                              false);
-                    }
+                    context->handle(*method,
+                                    *this,
+                                    *this,
+                                    requested_url,
+                                    request_headers,
+                                    request_parameters,
+                                    packet.get_buffer(),
+                                    first_packet,
+                                    last_packet);
+                }
+                else
+                {
+                    // Unsupported method.
+                    reply(std::make_unique<regular::responses::StringResponse>(ResponseCode::Method_Not_Allowed),
+                          false);
                 }
             }
         }
@@ -0,0 +1,63 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/ResponseBody.h"
+#include <algorithm>
+
+namespace smooth::application::network::http
+{
+    ResponseBody::ResponseBody(std::string text)
+            : ResponseBody(std::make_shared<const std::string>(std::move(text)))
+    {
+    }
+
+    ResponseBody::ResponseBody(std::vector<uint8_t> data)
+            : ResponseBody(std::make_shared<const std::vector<uint8_t>>(std::move(data)))
+    {
+    }
+
+    ResponseBody::ResponseBody(std::shared_ptr<const std::string> text)
+            : ResponseBody(text, text ? text->data() : nullptr, text ? text->size() : 0)
+    {
+    }
+
+    ResponseBody::ResponseBody(std::shared_ptr<const std::vector<uint8_t>> data)
+            : ResponseBody(data, data ? data->data() : nullptr, data ? data->size() : 0)
+    {
+    }
+
+    ResponseBody::ResponseBody(std::shared_ptr<const void> owner, const void* data, std::size_t length)
+            : owner(std::move(owner)),
+              data(static_cast<const uint8_t*>(data)),
+              length(length)
+    {
+    }
+
+    ResponseBody ResponseBody::from_static(std::string_view data)
+    {
+        return ResponseBody{ nullptr, data.data(), data.size() };
+    }
+
+    std::size_t ResponseBody::take(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto amount = std::min(max_amount, remaining());
+        target.insert(target.end(), data + offset, data + offset + amount);
+        offset += amount;
+
+        return amount;
+    }
+}
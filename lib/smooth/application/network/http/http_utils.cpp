@@ -18,10 +18,10 @@ limitations under the License.
 #include "smooth/application/network/http/http_utils.h"
 #include "smooth/core/util/string_util.h"
 
+#include <algorithm>
 #include <array>
-#include <sstream>
-#include <iomanip>
-#include <mutex>
+#include <limits>
+#include <optional>
 
 using namespace smooth::application::network::http::regular;
 using namespace std::chrono;
@@ -32,6 +32,70 @@ namespace smooth::application::network::http::utils
     static const std::array<const char*, 12> month{ "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep",
                                                     "Oct", "Nov", "Dec" };
 
+    // Conversions between dates and days since 1970-01-01, in the proleptic Gregorian calendar, from
+    // http://howardhinnant.github.io/date_algorithms.html. Unlike mktime() and gmtime(), they don't
+    // depend on the time zone of the environment, and need neither locks nor system calls.
+    static int64_t days_from_civil(int64_t y, int64_t m, int64_t d)
+    {
+        y -= m <= 2 ? 1 : 0;
+        const auto era = (y >= 0 ? y : y - 399) / 400;
+        const auto yoe = y - era * 400;
+        const auto doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const auto doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+        return era * 146097 + doe - 719468;
+    }
+
+    static void civil_from_days(int64_t z, int64_t& y, int64_t& m, int64_t& d)
+    {
+        z += 719468;
+        const auto era = (z >= 0 ? z : z - 146096) / 146097;
+        const auto doe = z - era * 146097;
+        const auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const auto mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = yoe + era * 400 + (m <= 2 ? 1 : 0);
+    }
+
+    static void put_number(std::string& s, int64_t value, std::size_t digits)
+    {
+        auto end = s.size() + digits;
+        s.resize(end);
+
+        for (std::size_t i = end; i > end - digits; --i)
+        {
+            s[i - 1] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+
+    /// Parses a fixed number of digits.
+    static bool get_number(std::string_view s, std::size_t pos, std::size_t digits, int& value)
+    {
+        bool res = pos + digits <= s.size();
+        value = 0;
+
+        for (std::size_t i = pos; res && i < pos + digits; ++i)
+        {
+            res = s[i] >= '0' && s[i] <= '9';
+            value = value * 10 + (s[i] - '0');
+        }
+
+        return res;
+    }
+
+    /// Finds a name in a list of names.
+    template<typename List>
+    static bool get_index(std::string_view name, const List& names, int& index)
+    {
+        auto found = std::find(names.begin(), names.end(), name);
+        index = static_cast<int>(std::distance(names.begin(), found));
+
+        return found != names.end();
+    }
+
     std::string make_http_time(const std::chrono::system_clock::time_point& t)
     {
         auto tt = std::chrono::system_clock::to_time_t(t);
@@ -41,45 +105,62 @@ namespace smooth::application::network::http::utils
 
     std::string make_http_time(const time_t& t)
     {
-        tm time{};
-        gmtime_r(&t, &time);
-        std::stringstream ss;
-
         // https://developer.mozilla.org/en-US/docs/Web/HTTP/Headers/Last-Modified
         // GMT == UTC and the time read from disc is in UTC so no need to convert between timezones.
         // <day-name>, <day> <month> <year> <hour>:<minute>:<second> GMT
-        ss << day[static_cast<decltype(day)::size_type>(time.tm_wday)];
-        ss << ", " << std::setfill('0') << std::setw(2) << time.tm_mday;
-        ss << " " << month[static_cast<decltype(month)::size_type>(time.tm_mon)];
-        ss << " " << time.tm_year + 1900;
-        ss << " " << std::setfill('0') << std::setw(2) << time.tm_hour;
-        ss << ":" << std::setfill('0') << std::setw(2) << time.tm_min;
-        ss << ":" << std::setfill('0') << std::setw(2) << time.tm_sec;
-        ss << " GMT";
+        constexpr int64_t seconds_per_day = 24 * 60 * 60;
+        auto seconds = static_cast<int64_t>(t);
+        auto days = (seconds >= 0 ? seconds : seconds - seconds_per_day + 1) / seconds_per_day;
+        auto time_of_day = seconds - days * seconds_per_day;
+        int64_t year;
+        int64_t mon;
+        int64_t mday;
+        civil_from_days(days, year, mon, mday);
 
-        return ss.str();
+        // 1970-01-01 was a Thursday.
+        auto wday = (days % 7 + 11) % 7;
+
+        std::string res{};
+        res.reserve(29);
+        res.append(day[static_cast<std::size_t>(wday)]).append(", ");
+        put_number(res, mday, 2);
+        res.append(" ").append(month[static_cast<std::size_t>(mon - 1)]).append(" ");
+        put_number(res, year, 4);
+        res.append(" ");
+        put_number(res, time_of_day / 3600, 2);
+        res.append(":");
+        put_number(res, time_of_day / 60 % 60, 2);
+        res.append(":");
+        put_number(res, time_of_day % 60, 2);
+        res.append(" GMT");
+
+        return res;
     }
 
-    std::chrono::system_clock::time_point parse_http_time(const std::string& t)
+    std::chrono::system_clock::time_point parse_http_time(std::string_view t)
     {
+        // Only the preferred format, e.g. "Sun, 06 Nov 1994 08:49:37 GMT", is accepted.
         tm time{};
+        int wday = 0;
+        bool ok = t.size() == 29
+                  && get_index(t.substr(0, 3), day, wday)
+                  && t.compare(3, 2, ", ") == 0
+                  && get_number(t, 5, 2, time.tm_mday) && t[7] == ' '
+                  && get_index(t.substr(8, 3), month, time.tm_mon) && t[11] == ' '
+                  && get_number(t, 12, 4, time.tm_year) && t[16] == ' '
+                  && get_number(t, 17, 2, time.tm_hour) && t[19] == ':'
+                  && get_number(t, 20, 2, time.tm_min) && t[22] == ':'
+                  && get_number(t, 23, 2, time.tm_sec)
+                  && t.compare(25, 4, " GMT") == 0
+                  && time.tm_mday >= 1 && time.tm_mday <= 31
+                  && time.tm_hour < 24 && time.tm_min < 60 && time.tm_sec <= 60;
 
-        // Default locale is "C"
-        std::istringstream ss(t);
+        auto res = system_clock::time_point::min();
 
-        system_clock::time_point res{};
-
-        ss >> std::get_time(&time, "%a, %d %b %Y %H:%M:%S GMT");
-
-        if (ss.fail())
-        {
-            res = system_clock::time_point::min();
-        }
-        else
+        if (ok)
         {
-            time.tm_isdst = 0;
-            time_t time_to_use = timegm(time);
-            res = system_clock::from_time_t(time_to_use);
+            time.tm_year -= 1900;
+            res = system_clock::from_time_t(timegm(time));
         }
 
         return res;
@@ -132,29 +213,12 @@ namespace smooth::application::network::http::utils
 
     time_t timegm(tm& tm)
     {
-        static std::mutex timemg_lock{};
-        std::lock_guard<std::mutex> lock(timemg_lock);
-
-        time_t ret{};
-        char* tz = nullptr;
+        // Months outside 0-11 move into other years, like with mktime().
+        int64_t year = int64_t{ tm.tm_year } + 1900 + (tm.tm_mon >= 0 ? tm.tm_mon : tm.tm_mon - 11) / 12;
+        int64_t mon = (tm.tm_mon % 12 + 12) % 12;
+        auto days = days_from_civil(year, mon + 1, 1) + tm.tm_mday - 1;
 
-        tz = getenv("TZ");
-        setenv("TZ", "", 1);
-        tzset();
-        ret = std::mktime(&tm);
-
-        if (tz)
-        {
-            setenv("TZ", tz, 1);
-        }
-        else
-        {
-            unsetenv("TZ");
-        }
-
-        tzset();
-
-        return ret;
+        return static_cast<time_t>(((days * 24 + tm.tm_hour) * 60 + tm.tm_min) * 60 + tm.tm_sec);
     }
 
     std::string http_method_to_string(const HTTPMethod m)
@@ -182,4 +246,207 @@ namespace smooth::application::network::http::utils
 
         return "";
     }
+
+    bool string_to_http_method(std::string_view s, HTTPMethod& method)
+    {
+        auto res = true;
+
+        if (s == "GET")
+        {
+            method = HTTPMethod::GET;
+        }
+        else if (s == "POST")
+        {
+            method = HTTPMethod::POST;
+        }
+        else if (s == "HEAD")
+        {
+            method = HTTPMethod::HEAD;
+        }
+        else if (s == "PUT")
+        {
+            method = HTTPMethod::PUT;
+        }
+        else if (s == "DELETE")
+        {
+            method = HTTPMethod::DELETE;
+        }
+        else
+        {
+            res = false;
+        }
+
+        return res;
+    }
+
+    static std::string_view trim(std::string_view s)
+    {
+        constexpr std::string_view whitespace = " \t";
+        s.remove_prefix(std::min(s.find_first_not_of(whitespace), s.size()));
+        s.remove_suffix(s.size() - std::min(s.find_last_not_of(whitespace) + 1, s.size()));
+
+        return s;
+    }
+
+    /// Parses a non-empty string of digits. Values too large for std::size_t become its maximum value.
+    static bool parse_digits(std::string_view s, std::size_t& value)
+    {
+        constexpr auto max = std::numeric_limits<std::size_t>::max();
+        bool res = !s.empty();
+        value = 0;
+
+        for (auto it = s.begin(); res && it != s.end(); ++it)
+        {
+            res = *it >= '0' && *it <= '9';
+            auto digit = static_cast<std::size_t>(*it - '0');
+            value = value > (max - digit) / 10 ? max : value * 10 + digit;
+        }
+
+        return res;
+    }
+
+    bool accepts_encoding(std::string_view accept_encoding, std::string_view coding)
+    {
+        std::optional<bool> listed{};
+        bool wildcard = false;
+
+        while (!accept_encoding.empty() && !listed)
+        {
+            auto item = accept_encoding.substr(0, accept_encoding.find(','));
+            accept_encoding.remove_prefix(std::min(item.size() + 1, accept_encoding.size()));
+
+            auto params = item.find(';');
+            auto name = trim(item.substr(0, params));
+
+            // A quality of zero, i.e. only zeros and a dot, means "not acceptable".
+            bool acceptable = true;
+
+            if (params != std::string_view::npos)
+            {
+                auto q = trim(item.substr(params + 1));
+
+                if (q.size() > 2 && (q[0] == 'q' || q[0] == 'Q') && q[1] == '=')
+                {
+                    acceptable = q.find_first_not_of("0.", 2) != std::string_view::npos;
+                }
+            }
+
+            if (smooth::core::string_util::iequals(name, coding))
+            {
+                listed = acceptable;
+            }
+            else if (name == "*")
+            {
+                wildcard = acceptable;
+            }
+        }
+
+        return listed.value_or(wildcard);
+    }
+
+    bool parse_byte_ranges(std::string_view range, std::size_t size, std::vector<ByteRange>& ranges)
+    {
+        constexpr std::string_view unit = "bytes=";
+
+        ranges.clear();
+        bool res = range.size() > unit.size()
+                   && smooth::core::string_util::iequals(range.substr(0, unit.size()), unit);
+        range.remove_prefix(std::min(unit.size(), range.size()));
+        std::size_t count = 0;
+
+        while (res && !range.empty())
+        {
+            auto item = range.substr(0, range.find(','));
+            range.remove_prefix(std::min(item.size() + 1, range.size()));
+            item = trim(item);
+
+            // Empty list elements are allowed, e.g. "bytes=0-1,,5-6".
+            if (!item.empty())
+            {
+                auto dash = item.find('-');
+                res = dash != std::string_view::npos && ++count <= max_byte_ranges;
+
+                if (res && dash == 0)
+                {
+                    // The last N bytes, not satisfiable for N == 0.
+                    std::size_t suffix = 0;
+                    res = parse_digits(item.substr(1), suffix);
+
+                    if (res && suffix > 0 && size > 0)
+                    {
+                        ranges.push_back({ size - std::min(suffix, size), size - 1 });
+                    }
+                }
+                else if (res)
+                {
+                    std::size_t first = 0;
+                    auto last = std::numeric_limits<std::size_t>::max();
+                    auto last_pos = item.substr(dash + 1);
+                    res = parse_digits(item.substr(0, dash), first)
+                          && (last_pos.empty() || (parse_digits(last_pos, last) && last >= first));
+
+                    if (res && first < size)
+                    {
+                        ranges.push_back({ first, std::min(last, size - 1) });
+                    }
+                }
+            }
+        }
+
+        res = res && count > 0;
+
+        if (res)
+        {
+            std::sort(ranges.begin(), ranges.end(),
+                      [](const ByteRange& a, const ByteRange& b) { return a.first < b.first; });
+
+            std::vector<ByteRange> merged{};
+
+            for (const auto& r : ranges)
+            {
+                if (!merged.empty() && r.first <= merged.back().last + 1)
+                {
+                    merged.back().last = std::max(merged.back().last, r.last);
+                }
+                else
+                {
+                    merged.push_back(r);
+                }
+            }
+
+            ranges = std::move(merged);
+        }
+        else
+        {
+            ranges.clear();
+        }
+
+        return res;
+    }
+
+    bool etag_matches(std::string_view etags, std::string_view etag, bool weak)
+    {
+        auto is_weak = [](std::string_view tag) { return tag.size() >= 2 && tag[0] == 'W' && tag[1] == '/'; };
+        auto opaque = [&is_weak](std::string_view tag) { return is_weak(tag) ? tag.substr(2) : tag; };
+
+        bool res = trim(etags) == "*" && !etag.empty();
+
+        while (!res && !etags.empty())
+        {
+            auto item = etags.substr(0, etags.find(','));
+            etags.remove_prefix(std::min(item.size() + 1, etags.size()));
+            item = trim(item);
+
+            if (weak)
+            {
+                res = !item.empty() && opaque(item) == opaque(etag);
+            }
+            else
+            {
+                res = !item.empty() && !is_weak(item) && !is_weak(etag) && item == etag;
+            }
+        }
+
+        return res;
+    }
 }
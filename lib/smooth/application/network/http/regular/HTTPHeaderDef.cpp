@@ -20,8 +20,20 @@ namespace smooth::application::network::http::regular
     // Type all strings using lower-case; headers are all converted to lowercase in the response header maps.
     const char* CONTENT_LENGTH = "content-length";
     const char* CONTENT_TYPE = "content-type";
+    const char* CONTENT_ENCODING = "content-encoding";
+    const char* ACCEPT_ENCODING = "accept-encoding";
+    const char* VARY = "vary";
     const char* LAST_MODIFIED = "last-modified";
+    const char* IF_MODIFIED_SINCE = "if-modified-since";
+    const char* ETAG = "etag";
+    const char* IF_NONE_MATCH = "if-none-match";
+    const char* CACHE_CONTROL = "cache-control";
+    const char* RANGE = "range";
+    const char* IF_RANGE = "if-range";
+    const char* CONTENT_RANGE = "content-range";
+    const char* ACCEPT_RANGES = "accept-ranges";
     const char* CONNECTION = "connection";
+    const char* TRANSFER_ENCODING = "transfer-encoding";
     const char* KEEP_ALIVE = "keep-alive";
     const char* ORIGIN = "origin";
     const char* HOST = "host";
@@ -0,0 +1,150 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <charconv>
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+#include "smooth/application/network/http/http_utils.h"
+
+namespace smooth::application::network::http::regular
+{
+    namespace
+    {
+        bool is_whitespace(char c)
+        {
+            return c == ' ' || c == '\t';
+        }
+
+        std::string_view trim(std::string_view s)
+        {
+            while (!s.empty() && is_whitespace(s.front()))
+            {
+                s.remove_prefix(1);
+            }
+
+            while (!s.empty() && is_whitespace(s.back()))
+            {
+                s.remove_suffix(1);
+            }
+
+            return s;
+        }
+
+        /// Takes the next line from s, without line ending.
+        std::string_view next_line(std::string_view& s)
+        {
+            auto end = s.find('\n');
+            auto line = s.substr(0, end);
+            s.remove_prefix(end == std::string_view::npos ? s.size() : end + 1);
+
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+
+            return line;
+        }
+    }
+
+    bool HTTPHeaderParser::parse(std::string_view block, HeaderMap& headers)
+    {
+        request_method.reset();
+        request_url = {};
+        http_version = {};
+        status_code = 0;
+
+        auto start_line = next_line(block);
+        request = start_line.compare(0, 5, "HTTP/") != 0;
+
+        bool res = request ? parse_request_line(start_line) : parse_status_line(start_line);
+
+        while (res && !block.empty())
+        {
+            parse_header(next_line(block), headers);
+        }
+
+        return res;
+    }
+
+    bool HTTPHeaderParser::parse_request_line(std::string_view line)
+    {
+        // GET /index.html HTTP/1.1
+        auto first_space = line.find(' ');
+        auto last_space = line.rfind(' ');
+        bool res = first_space != std::string_view::npos
+                   && last_space > first_space + 1
+                   && parse_version(line.substr(last_space + 1), http_version);
+
+        if (res)
+        {
+            HTTPMethod m{};
+            request_method = utils::string_to_http_method(line.substr(0, first_space), m)
+                             ? std::optional<HTTPMethod>{ m } : std::nullopt;
+            request_url = line.substr(first_space + 1, last_space - first_space - 1);
+        }
+
+        return res;
+    }
+
+    bool HTTPHeaderParser::parse_status_line(std::string_view line)
+    {
+        // HTTP/1.1 200 OK, the reason phrase may be empty.
+        auto space = line.find(' ');
+        bool res = space != std::string_view::npos && parse_version(line.substr(0, space), http_version);
+
+        if (res)
+        {
+            auto code = line.substr(space + 1, 3);
+            auto [end, error] = std::from_chars(code.data(), code.data() + code.size(), status_code);
+            res = error == std::errc{}
+                  && end == code.data() + 3
+                  && (line.size() == space + 4 || line[space + 4] == ' ');
+        }
+
+        return res;
+    }
+
+    void HTTPHeaderParser::parse_header(std::string_view line, HeaderMap& headers)
+    {
+        // Lines without a colon, including obsolete line folding, and names with whitespace before the colon,
+        // are ignored, https://tools.ietf.org/html/rfc7230#section-3.2.4
+        auto colon = line.find(':');
+
+        if (colon != std::string_view::npos && colon > 0 && !is_whitespace(line[colon - 1])
+            && !is_whitespace(line[0]))
+        {
+            headers.add(line.substr(0, colon), trim(line.substr(colon + 1)));
+        }
+    }
+
+    bool HTTPHeaderParser::parse_version(std::string_view s, std::string_view& version)
+    {
+        auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+
+        bool res = s.size() == 8
+                   && s.compare(0, 5, "HTTP/") == 0
+                   && is_digit(s[5])
+                   && s[6] == '.'
+                   && is_digit(s[7]);
+
+        if (res)
+        {
+            version = s.substr(5);
+        }
+
+        return res;
+    }
+}
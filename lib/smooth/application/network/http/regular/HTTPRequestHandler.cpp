@@ -7,11 +7,14 @@ namespace smooth::application::network::http::regular
     {
         mime.reset();
 
-        // In case the expected headers don't exist, catch any exceptions.
+        // In case the expected headers don't exist or are invalid, catch any exceptions.
         try
         {
-            mime.detect_mode(headers().at(CONTENT_TYPE),
-                            std::stoul(headers().at(CONTENT_LENGTH)));
+            if (headers().contains(CONTENT_TYPE))
+            {
+                mime.detect_mode(std::string{ headers().get(CONTENT_TYPE) },
+                                 std::stoul(std::string{ headers().get(CONTENT_LENGTH) }));
+            }
         }
         catch (...)
         {
@@ -22,13 +25,15 @@ namespace smooth::application::network::http::regular
     void HTTPRequestHandler::update_call_params(bool first_part,
                                                 bool last_part,
                                                 IServerResponse& response,
-                                                const std::unordered_map<std::string, std::string>& headers,
-                                                const std::unordered_map<std::string, std::string>& request_parameters)
+                                                const HeaderMap& headers,
+                                                const std::unordered_map<std::string, std::string>& request_parameters,
+                                                const RouteParameters& path_parameters)
     {
         request_params.first_part = first_part;
         request_params.last_part = last_part;
         request_params.response = &response;
         request_params.headers = &headers;
         request_params.request_parameters = &request_parameters;
+        request_params.path_parameters = &path_parameters;
     }
 }
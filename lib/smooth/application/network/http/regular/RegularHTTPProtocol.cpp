@@ -16,10 +16,13 @@ limitations under the License.
 */
 
 #include <algorithm>
-#include "smooth/core/util/string_util.h"
+#include <charconv>
+#include <cstring>
 #include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
 #include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
 #include "smooth/application/network/http/regular/responses/ErrorResponse.h"
+#include "smooth/core/util/string_util.h"
 
 namespace smooth::application::network::http
 {
@@ -39,6 +42,15 @@ namespace smooth::application::network::http
             // Make sure there is room for what he have received and what we ask for.
             packet.expand_by(amount_to_request);
         }
+        else if (chunked)
+        {
+            // Where the content ends is only known once the last chunk has been decoded, so fill the packet.
+            // The framing is removed from what is read, leaving room for more, and anything read beyond the
+            // last chunk is kept for the next request.
+            amount_to_request = std::max(1, content_chunk_size - content_bytes_received_in_current_part);
+
+            packet.data().resize(static_cast<std::size_t>(content_bytes_received_in_current_part + amount_to_request));
+        }
         else
         {
             // Never ask for more than content_chunk_size
@@ -64,25 +76,59 @@ namespace smooth::application::network::http
                 // End of header found
                 state = State::reading_content;
                 actual_header_size = consume_headers(packet, end_of_header);
-                total_content_bytes_received = total_bytes_received - actual_header_size;
+                auto content_received = total_bytes_received - actual_header_size;
 
-                // content_bytes_received_in_current_part may be larger than content_chunk_size
-                content_bytes_received_in_current_part = total_content_bytes_received;
+                // Transfer-Encoding takes precedence over Content-Length.
+                chunked = is_chunked(packet.headers().get(TRANSFER_ENCODING));
 
-                try
+                if (chunked)
                 {
-                    incoming_content_length = packet.headers()[CONTENT_LENGTH].empty() ? 0 : std::stoi(
-                            packet.headers()[CONTENT_LENGTH]);
+                    chunked_data_received(packet, content_received);
+                }
+                else if (packet.headers().contains(TRANSFER_ENCODING))
+                {
+                    // The length of the body can't be determined, so the connection must be closed (RFC 7230, 3.3.3).
+                    error = true;
+                    Log::error("HTTPProtocol", "Unsupported {}: {}.", TRANSFER_ENCODING,
+                               packet.headers().get(TRANSFER_ENCODING));
+                }
+                else
+                {
+                    auto content_length = packet.headers().get(CONTENT_LENGTH);
+                    incoming_content_length = 0;
 
-                    if (incoming_content_length < 0)
+                    if (!packet.headers().contains(CONTENT_LENGTH))
+                    {
+                        // No body
+                    }
+                    else if (auto [end, err] = std::from_chars(content_length.data(),
+                                                               content_length.data() + content_length.size(),
+                                                               incoming_content_length);
+                             err != std::errc{} || end != content_length.data() + content_length.size())
+                    {
+                        // Invalid or, when the header has been repeated, conflicting values. Where the body ends
+                        // is unknown so the connection must be closed (RFC 7230, 3.3.3).
+                        error = true;
+                        Log::error("HTTPProtocol", "Invalid {}: {}.", CONTENT_LENGTH, content_length);
+                    }
+                    else if (incoming_content_length < 0)
                     {
                         error = true;
                         Log::error("HTTPProtocol", "{} is < 0: {}.", CONTENT_LENGTH, incoming_content_length);
                     }
-                }
-                catch (...)
-                {
-                    incoming_content_length = 0;
+
+                    if (!error && content_received > incoming_content_length)
+                    {
+                        // The client has pipelined requests, keep what belongs to the next one.
+                        const auto* content = packet.data().data();
+                        keep_surplus(content + incoming_content_length, content + content_received);
+                        total_bytes_received -= content_received - incoming_content_length;
+                    }
+
+                    total_content_bytes_received = total_bytes_received - actual_header_size;
+
+                    // content_bytes_received_in_current_part may be larger than content_chunk_size
+                    content_bytes_received_in_current_part = total_content_bytes_received;
                 }
             }
             else if (total_bytes_received >= max_header_size)
@@ -98,6 +144,10 @@ namespace smooth::application::network::http
                 reset();
             }
         }
+        else if (chunked)
+        {
+            chunked_data_received(packet, length);
+        }
         else
         {
             total_content_bytes_received += length;
@@ -113,7 +163,7 @@ namespace smooth::application::network::http
             packet.set_request_data(last_method, last_url, last_request_version);
 
             // When there are more data expected, then this packet is "to be continued"
-            if (total_content_bytes_received < incoming_content_length)
+            if (!all_content_received())
             {
                 packet.set_continued();
             }
@@ -121,9 +171,8 @@ namespace smooth::application::network::http
             // When still reading the headers, the packet can never be a continuation.
             if (state != State::reading_headers)
             {
-                // If we've already received more data than what fits in a single chunk, then this packet
-                // is a continuation of an earlier packet.
-                if (total_content_bytes_received - content_bytes_received_in_current_part > content_chunk_size)
+                // If content has been delivered in earlier packets, then this packet is a continuation of those.
+                if (total_content_bytes_received - content_bytes_received_in_current_part > 0)
                 {
                     // Packet continues a previous packet.
                     packet.set_continuation();
@@ -153,8 +202,7 @@ namespace smooth::application::network::http
         auto complete = state != State::reading_headers;
 
         bool content_received =
-            incoming_content_length == 0 // No content to read.
-            || total_content_bytes_received == incoming_content_length // All content received
+            all_content_received()
             || content_bytes_received_in_current_part >= content_chunk_size; // Packet filled, split into multiple
                                                                              // chunks.
 
@@ -169,16 +217,29 @@ namespace smooth::application::network::http
     int RegularHTTPProtocol::consume_headers(HTTPPacket& packet,
                                              std::vector<uint8_t>::const_iterator header_ending)
     {
-        std::stringstream ss;
+        // Parse the headers where they are, including the CRLF ending the last header.
+        auto header_length = static_cast<std::size_t>(std::distance(packet.data().cbegin(), header_ending)) + 2;
+        std::string_view block{ reinterpret_cast<const char*>(packet.data().data()), header_length };
+
+        HTTPHeaderParser parser{};
 
-        std::for_each(packet.data().cbegin(),
-                      header_ending,
-                      [&ss](auto& c) {
-                          if (c != '\n')
-                          {
-                              ss << static_cast<char>(c);
-                          }
-        });
+        if (!parser.parse(block, packet.headers()))
+        {
+            error = true;
+            Log::error("HTTPProtocol", "Invalid start line: {}", block.substr(0, block.find('\r')));
+        }
+        else if (parser.is_request())
+        {
+            // Store request data for use in continued packets.
+            last_method = parser.method();
+            last_url.assign(parser.url());
+            last_request_version.assign(parser.version());
+            packet.set_request_data(last_method, last_url, last_request_version);
+        }
+        else
+        {
+            packet.set_response_data(static_cast<ResponseCode>(parser.status()));
+        }
 
         // Get actual end of header
         header_ending += HTTPPacket::ending.size();
@@ -186,66 +247,9 @@ namespace smooth::application::network::http
         // Update actual header size
         auto actual_header_bytes_received = static_cast<int>(std::distance(packet.data().cbegin(), header_ending));
 
-        // Erase headers from buffer
+        // Erase headers from buffer, only moving what content was received with them.
         packet.data().erase(packet.data().begin(), header_ending);
 
-        std::string s;
-
-        while (std::getline(ss, s, '\r'))
-        {
-            if (!s.empty())
-            {
-                auto colon = std::find(s.begin(), s.end(), ':');
-
-                if (colon == s.end() && !s.empty())
-                {
-                    std::smatch m;
-
-                    if (std::regex_match(s, m, request_line))
-                    {
-                        // Store method for use in continued packets.
-                        last_method = m[1].str();
-                        last_url = m[2].str();
-                        last_request_version = m[3].str();
-                        packet.set_request_data(last_method, last_url, last_request_version);
-                    }
-                    else if (std::regex_match(s, m, response_line))
-                    {
-                        // Store response data for later use
-                        try
-                        {
-                            auto response_code = std::stoi(m[2].str());
-                            packet.set_response_data(static_cast<ResponseCode>(response_code));
-                        }
-                        catch (...)
-                        {
-                            error = true;
-
-                            Log::error("HTTPProtocol", "Invalid response code: {}", m[2].str());
-                        }
-                    }
-                }
-                else
-                {
-                    if (std::distance(colon, s.end()) > 2)
-                    {
-                        // Headers are case-insensitive: https://tools.ietf.org/html/rfc7230#section-3.2
-                        // Headers may be split on several lines, so append data if header isn't empty.
-                        auto& curr_header = packet.headers()[string_util::to_lower_copy({ s.begin(), colon })];
-
-                        if (curr_header.empty())
-                        {
-                            curr_header = { colon + 2, s.end() };
-                        }
-                        else
-                        {
-                            curr_header.append(", ").append({ colon + 2, s.end() });
-                        }
-                    }
-                }
-            }
-        }
-
         return actual_header_bytes_received;
     }
 
@@ -253,16 +257,27 @@ namespace smooth::application::network::http
     {
         content_bytes_received_in_current_part = 0;
 
-        if (error || total_content_bytes_received >= incoming_content_length)
+        if (error || all_content_received())
         {
             // All chunks of the current request has been received.
             total_bytes_received = 0;
             incoming_content_length = 0;
             total_content_bytes_received = 0;
             actual_header_size = 0;
+            chunked = false;
+            chunk_state = ChunkState::size;
+            chunk_remaining = 0;
+            chunk_line.clear();
             state = State::reading_headers;
         }
 
+        if (error)
+        {
+            // After a framing error, where the next request starts is unknown.
+            surplus.clear();
+            surplus_read = 0;
+        }
+
         error = false;
     }
 
@@ -272,4 +287,160 @@ namespace smooth::application::network::http
         error = true;
         packet_consumed();
     }
+
+    int RegularHTTPProtocol::read_buffered(uint8_t* target, int max_length)
+    {
+        auto amount = std::min(surplus.size() - surplus_read, static_cast<std::size_t>(std::max(0, max_length)));
+        std::copy_n(surplus.cbegin() + static_cast<std::ptrdiff_t>(surplus_read), amount, target);
+        surplus_read += amount;
+
+        if (surplus_read == surplus.size())
+        {
+            surplus.clear();
+            surplus_read = 0;
+        }
+
+        return static_cast<int>(amount);
+    }
+
+    bool RegularHTTPProtocol::has_buffered_data() const
+    {
+        return surplus_read < surplus.size();
+    }
+
+    void RegularHTTPProtocol::keep_surplus(const uint8_t* begin, const uint8_t* end)
+    {
+        // The data may have come from the surplus itself, in which case it goes back in front of what is left.
+        surplus.erase(surplus.begin(), surplus.begin() + static_cast<std::ptrdiff_t>(surplus_read));
+        surplus_read = 0;
+        surplus.insert(surplus.begin(), begin, end);
+    }
+
+    void RegularHTTPProtocol::chunked_data_received(HTTPPacket& packet, int length)
+    {
+        auto offset = static_cast<std::vector<uint8_t>::size_type>(content_bytes_received_in_current_part);
+        auto* data = &packet.data()[offset];
+        int consumed = 0;
+        auto content = decode_chunked(data, length, consumed);
+
+        if (content < 0)
+        {
+            error = true;
+            Log::error("HTTPProtocol", "Malformed chunked transfer-encoding.");
+        }
+        else
+        {
+            if (consumed < length)
+            {
+                // The client has pipelined requests, keep what belongs to the next one.
+                keep_surplus(data + consumed, data + length);
+            }
+
+            total_content_bytes_received += content;
+            content_bytes_received_in_current_part += content;
+        }
+    }
+
+    int RegularHTTPProtocol::decode_chunked(uint8_t* data, int length, int& consumed)
+    {
+        int content = 0;
+        int pos = 0;
+        bool ok = true;
+
+        while (ok && pos < length && chunk_state != ChunkState::done)
+        {
+            if (chunk_state == ChunkState::data)
+            {
+                auto amount = static_cast<int>(std::min(chunk_remaining, static_cast<std::size_t>(length - pos)));
+
+                // Content only ever moves towards the start of the data, overwriting framing already decoded.
+                std::memmove(data + content, data + pos, static_cast<std::size_t>(amount));
+                content += amount;
+                pos += amount;
+                chunk_remaining -= static_cast<std::size_t>(amount);
+
+                if (chunk_remaining == 0)
+                {
+                    chunk_state = ChunkState::data_end;
+                }
+            }
+            else
+            {
+                auto c = static_cast<char>(data[pos++]);
+
+                if (c == '\n')
+                {
+                    ok = chunk_line_received();
+                }
+                else if (chunk_line.size() < static_cast<std::size_t>(max_header_size))
+                {
+                    chunk_line.push_back(c);
+                }
+                else
+                {
+                    ok = false;
+                }
+            }
+        }
+
+        consumed = pos;
+
+        return ok ? content : -1;
+    }
+
+    bool RegularHTTPProtocol::chunk_line_received()
+    {
+        std::string_view line{ chunk_line };
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+
+        bool ok = true;
+
+        if (chunk_state == ChunkState::size)
+        {
+            // Chunk extensions, following the size, are ignored.
+            std::size_t size = 0;
+            auto [end, err] = std::from_chars(line.data(), line.data() + line.size(), size, 16);
+            auto rest = line.substr(static_cast<std::size_t>(end - line.data()));
+
+            ok = err == std::errc{} && (rest.empty() || rest[0] == ';' || rest[0] == ' ' || rest[0] == '\t');
+            chunk_remaining = size;
+            chunk_state = size == 0 ? ChunkState::trailer : ChunkState::data;
+        }
+        else if (chunk_state == ChunkState::data_end)
+        {
+            ok = line.empty();
+            chunk_state = ChunkState::size;
+        }
+        else if (line.empty())
+        {
+            // Trailer fields are ignored, an empty line ends the content.
+            chunk_state = ChunkState::done;
+        }
+
+        chunk_line.clear();
+
+        return ok;
+    }
+
+    bool RegularHTTPProtocol::all_content_received() const
+    {
+        return chunked ? chunk_state == ChunkState::done : total_content_bytes_received >= incoming_content_length;
+    }
+
+    bool RegularHTTPProtocol::is_chunked(std::string_view transfer_encoding)
+    {
+        // Chunked must be the last of the transfer-codings applied.
+        auto last = transfer_encoding.substr(transfer_encoding.rfind(',') + 1);
+
+        while (!last.empty() && (last.front() == ' ' || last.front() == '\t'))
+        {
+            last.remove_prefix(1);
+        }
+
+        return core::string_util::iequals(last, "chunked");
+    }
 }
@@ -0,0 +1,227 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iterator>
+#include <fmt/core.h>
+#include "smooth/application/network/http/regular/StaticFileCache.h"
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::filesystem;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace smooth::application::network::http::regular
+{
+    std::shared_ptr<const CachedFile> CachedFile::stat(const Path& path)
+    {
+        auto res = std::make_shared<CachedFile>();
+        FileInfo info{ path };
+
+        res->path = path;
+        res->exists = info.exists();
+        res->regular_file = info.is_regular_file();
+        res->directory = info.is_directory();
+        res->size = info.size();
+        res->last_modified = info.last_modified();
+
+        if (res->regular_file)
+        {
+            res->content_type = utils::get_content_type(path);
+            res->etag = fmt::format("\"{:x}-{:x}\"", res->size, static_cast<uint64_t>(res->last_modified));
+        }
+
+        return res;
+    }
+
+    StaticFileCache::StaticFileCache(const FileCacheConfig& config)
+            : config(config)
+    {
+    }
+
+    std::shared_ptr<const CachedFile> StaticFileCache::get(const Path& path, bool with_content)
+    {
+        std::shared_ptr<const CachedFile> res{};
+
+        if (config.max_entries == 0)
+        {
+            res = CachedFile::stat(path);
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(guard);
+            const auto now = steady_clock::now();
+            auto found = by_path.find(path.str());
+
+            if (found == by_path.end())
+            {
+                ++stats.misses;
+                entries.push_front(Entry{ path.str(), CachedFile::stat(path), now });
+                by_path.emplace(entries.front().path, entries.begin());
+
+                while (entries.size() > config.max_entries)
+                {
+                    remove(std::prev(entries.end()));
+                    ++stats.evictions;
+                }
+            }
+            else
+            {
+                // Most recently used first.
+                entries.splice(entries.begin(), entries, found->second);
+                auto& entry = entries.front();
+
+                if (now - entry.validated >= config.revalidate_after)
+                {
+                    ++stats.revalidations;
+                    auto current = CachedFile::stat(path);
+                    const auto& cached = *entry.file;
+
+                    if (current->exists != cached.exists
+                        || current->regular_file != cached.regular_file
+                        || current->directory != cached.directory
+                        || current->size != cached.size
+                        || current->last_modified != cached.last_modified)
+                    {
+                        ++stats.invalidations;
+                        content_size -= content_size_of(entry);
+                        entry.file = std::move(current);
+                    }
+
+                    entry.validated = now;
+                }
+                else
+                {
+                    ++stats.hits;
+                }
+            }
+
+            auto& entry = entries.front();
+
+            if (with_content && entry.file->regular_file)
+            {
+                entry.file = load_content(entry);
+            }
+
+            res = entry.file;
+        }
+
+        return res;
+    }
+
+    void StaticFileCache::invalidate(const Path& path)
+    {
+        std::unique_lock<std::mutex> lock(guard);
+        auto found = by_path.find(path.str());
+
+        if (found != by_path.end())
+        {
+            remove(found->second);
+            ++stats.invalidations;
+        }
+    }
+
+    void StaticFileCache::clear()
+    {
+        std::unique_lock<std::mutex> lock(guard);
+        stats.invalidations += entries.size();
+        entries.clear();
+        by_path.clear();
+        content_size = 0;
+    }
+
+    FileCacheStats StaticFileCache::get_statistics() const
+    {
+        std::unique_lock<std::mutex> lock(guard);
+        auto res = stats;
+        res.entries = entries.size();
+        res.content_size = content_size;
+
+        return res;
+    }
+
+    void StaticFileCache::dump_statistics() const
+    {
+        auto s = get_statistics();
+
+        Log::info("StaticFileCache",
+                  "Entries: {}; Content: {} bytes; Hit rate: {:.1f}% ({} hits, {} misses, {} revalidations); "
+                  "Content hit rate: {:.1f}% ({} hits, {} misses); Invalidations: {}; Evictions: {}",
+                  s.entries, s.content_size, s.hit_rate() * 100, s.hits, s.misses, s.revalidations,
+                  s.content_hit_rate() * 100, s.content_hits, s.content_misses, s.invalidations, s.evictions);
+    }
+
+    std::shared_ptr<const CachedFile> StaticFileCache::load_content(Entry& entry)
+    {
+        auto res = entry.file;
+        const auto size = res->size;
+
+        if (res->content)
+        {
+            ++stats.content_hits;
+        }
+        else if (config.max_content_size > 0 && size <= config.max_file_size && size <= config.max_content_size)
+        {
+            ++stats.content_misses;
+            auto content = std::make_shared<std::vector<uint8_t>>();
+
+            if (File::read(res->path, *content, 0, size))
+            {
+                release_content(size);
+
+                auto with_content = std::make_shared<CachedFile>(*res);
+                with_content->content = std::move(content);
+                res = std::move(with_content);
+                content_size += size;
+            }
+        }
+
+        return res;
+    }
+
+    void StaticFileCache::remove(EntryList::iterator entry)
+    {
+        content_size -= content_size_of(*entry);
+        by_path.erase(entry->path);
+        entries.erase(entry);
+    }
+
+    void StaticFileCache::release_content(std::size_t wanted_space)
+    {
+        // Release the content of the least recently used files first.
+        for (auto it = entries.rbegin(); content_size + wanted_space > config.max_content_size && it != entries.rend();
+             ++it)
+        {
+            if (it->file->content)
+            {
+                content_size -= content_size_of(*it);
+
+                auto without_content = std::make_shared<CachedFile>(*it->file);
+                without_content->content.reset();
+                it->file = std::move(without_content);
+                ++stats.evictions;
+            }
+        }
+    }
+
+    std::size_t StaticFileCache::content_size_of(const Entry& entry)
+    {
+        return entry.file->content ? entry.file->content->size() : 0;
+    }
+}
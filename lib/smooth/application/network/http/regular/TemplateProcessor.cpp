@@ -16,18 +16,138 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
-#include <regex>
-#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include <algorithm>
+#include <string_view>
+#include "smooth/application/network/http/http_utils.h"
 #include "smooth/application/network/http/regular/responses/ErrorResponse.h"
+#include "smooth/application/network/http/regular/responses/TemplateResponse.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
 #include "smooth/core/filesystem/File.h"
-#include "smooth/core/util/string_util.h"
+#include "smooth/core/filesystem/FileReader.h"
 
 using namespace smooth::core::filesystem;
-using namespace smooth::core::string_util;
 
 namespace smooth::application::network::http::regular
 {
+    namespace
+    {
+        /// Finds tokens in a template in a single pass, without backtracking, so that a template can be fed to it
+        /// in parts. Tokens are found where a search for the regular expression "\{\{[\d_\-a-zA-Z]+\}\}" from the
+        /// start of the text, continuing after each match, would find them.
+        class TokenScanner
+        {
+            public:
+                explicit TokenScanner(std::vector<CompiledTemplate::Segment>& segments)
+                        : segments(segments)
+                {
+                }
+
+                /// \param data The next part of the template.
+                /// \param offset Position of the part in the template.
+                void feed(std::string_view data, std::size_t offset)
+                {
+                    for (std::size_t i = 0; i < data.size(); ++i)
+                    {
+                        auto c = data[i];
+                        auto pos = offset + i;
+
+                        if (state == State::Literal)
+                        {
+                            start_candidate_if_brace(c, pos);
+                        }
+                        else if (state == State::OpeningBrace)
+                        {
+                            state = c == '{' ? State::Name : State::Literal;
+                        }
+                        else if (state == State::Name)
+                        {
+                            if (is_name_char(c))
+                            {
+                                name.push_back(c);
+                            }
+                            else if (c == '}' && !name.empty())
+                            {
+                                state = State::ClosingBrace;
+                            }
+                            else if (c == '{' && name.empty())
+                            {
+                                // "{{{", the token may start at the second brace.
+                                ++candidate;
+                            }
+                            else
+                            {
+                                reset_candidate();
+                                start_candidate_if_brace(c, pos);
+                            }
+                        }
+                        else if (c == '}')
+                        {
+                            add_literal(candidate);
+                            segments.push_back(CompiledTemplate::Segment{ 0, 0, "{{" + name + "}}" });
+                            literal_start = pos + 1;
+                            reset_candidate();
+                        }
+                        else
+                        {
+                            reset_candidate();
+                            start_candidate_if_brace(c, pos);
+                        }
+                    }
+                }
+
+                /// Adds the remaining literal text.
+                /// \param size The size of the template.
+                void finish(std::size_t size)
+                {
+                    add_literal(size);
+                }
+
+            private:
+                enum class State
+                {
+                    Literal,
+                    OpeningBrace,
+                    Name,
+                    ClosingBrace
+                };
+
+                static bool is_name_char(char c)
+                {
+                    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                           || c == '_' || c == '-';
+                }
+
+                void start_candidate_if_brace(char c, std::size_t pos)
+                {
+                    if (c == '{')
+                    {
+                        state = State::OpeningBrace;
+                        candidate = pos;
+                    }
+                }
+
+                void reset_candidate()
+                {
+                    state = State::Literal;
+                    name.clear();
+                }
+
+                void add_literal(std::size_t end)
+                {
+                    if (end > literal_start)
+                    {
+                        segments.push_back(CompiledTemplate::Segment{ literal_start, end - literal_start, "" });
+                    }
+                }
+
+                std::vector<CompiledTemplate::Segment>& segments;
+                State state{ State::Literal };
+                std::size_t literal_start{ 0 };
+                std::size_t candidate{ 0 };
+                std::string name{};
+        };
+    }
+
     TemplateProcessor::TemplateProcessor(std::set<std::string> template_files,
                                          std::shared_ptr<ITemplateDataRetriever> data_retriever)
             : template_files(std::move(template_files)),
@@ -36,57 +156,146 @@ namespace smooth::application::network::http::regular
     }
 
     std::unique_ptr<IResponseOperation> TemplateProcessor::process_template(const smooth::core::filesystem::Path& path)
+    {
+        return process_template(CachedFile::stat(path));
+    }
+
+    std::unique_ptr<IResponseOperation>
+    TemplateProcessor::process_template(const std::shared_ptr<const CachedFile>& file)
     {
         std::unique_ptr<IResponseOperation> res{};
 
-        const auto& ext = path.extension();
+        const auto& ext = file->path.extension();
         bool is_template_file = template_files.find(ext) != template_files.end();
 
         if (is_template_file)
         {
-            std::string data;
-            File src{ path };
+            auto entry = compiled.find(file->path.str());
+
+            if (entry == compiled.end())
+            {
+                if (compiled.size() >= max_compiled)
+                {
+                    compiled.erase(std::min_element(compiled.begin(), compiled.end(),
+                                                    [](const auto& a, const auto& b) {
+                                                        return a.second.last_used < b.second.last_used;
+                                                    }));
+                }
+
+                entry = compiled.emplace(file->path.str(), Entry{}).first;
+            }
+
+            entry->second.last_used = ++use_count;
+            auto& current = entry->second.compiled;
 
-            if (!src.read(data) || data.empty())
+            if (!current || current->last_modified != file->last_modified || current->size != file->size)
             {
+                current = compile(*file);
+            }
+
+            if (!current)
+            {
+                // Also removes files that have been deleted.
+                compiled.erase(entry);
                 res = std::make_unique<responses::ErrorResponse>(ResponseCode::Internal_Server_Error);
             }
             else
             {
-                process_template(data);
-                res = std::make_unique<responses::StringResponse>(ResponseCode::OK, data, false);
+                // Looked up up front, so the length of the response is known.
+                std::vector<std::string> values(current->segments.size());
+
+                for (std::size_t i = 0; i < values.size(); ++i)
+                {
+                    const auto& token = current->segments[i].token;
+
+                    if (!token.empty())
+                    {
+                        // Tokens without corresponding data are replaced with an empty string.
+                        values[i] = data_retriever ? data_retriever->get(token) : token;
+                    }
+                }
+
+                res = std::make_unique<responses::TemplateResponse>(current, std::move(values));
             }
         }
 
         return res;
     }
 
-    void TemplateProcessor::process_template(std::string& template_data) const
+    std::shared_ptr<const CompiledTemplate> TemplateProcessor::compile(const CachedFile& file)
     {
-        // Find keys in the form "{{alpha_num}}, then do a lookup on the alpha_num part
-        // and replace the entire found token. Continue search after the found token until end of data.
+        // Read in parts, so that large templates don't have to fit in memory.
+        constexpr std::size_t read_size = 1024;
+
+        auto res = std::make_shared<CompiledTemplate>();
+        res->path = file.path;
+        res->size = file.size;
+        res->last_modified = file.last_modified;
+        res->content_type = file.content_type;
 
-        if (data_retriever)
+        bool ok = file.regular_file;
+        FileReader reader{ file.path, 0 };
+
+        if (ok && reader.is_open())
         {
-            try
+            // The file may have changed since it was looked up, parse what is actually read.
+            ok = reader.stat(res->size, res->last_modified);
+        }
+
+        ok = ok && res->size > 0;
+
+        TokenScanner scanner{ res->segments };
+        std::vector<uint8_t> data{};
+
+        for (std::size_t offset = 0; ok && offset < res->size; offset += read_size)
+        {
+            data.clear();
+            auto length = std::min(read_size, res->size - offset);
+
+            if (reader.is_open())
+            {
+                ok = reader.read(data, length);
+            }
+            else
             {
-                // Find all tokens
-                std::smatch match{};
+                // No file slot was available when the reader was created, read as files usually are.
+                ok = File::read(file.path, data, offset, length);
+            }
 
-                while (std::regex_search(template_data, match, token))
-                {
-                    std::stringstream ss;
-                    const auto& found_token = match[0].str();
+            scanner.feed(std::string_view{ reinterpret_cast<const char*>(data.data()), data.size() }, offset);
 
-                    // Replaces any matched token, even if no corresponding data exists, in which case empty string is
-                    // used.
-                    replace_all(template_data, found_token, data_retriever->get(found_token));
-                }
+            if (res->size <= CompiledTemplate::max_content_size)
+            {
+                res->content.insert(res->content.end(), data.begin(), data.end());
             }
-            catch (std::regex_error& ex)
+        }
+
+        scanner.finish(res->size);
+
+        return ok ? res : nullptr;
+    }
+
+    void TemplateProcessor::process_template(std::string& template_data) const
+    {
+        std::vector<CompiledTemplate::Segment> segments{};
+        TokenScanner scanner{ segments };
+        scanner.feed(template_data, 0);
+        scanner.finish(template_data.size());
+
+        std::string res{};
+
+        for (const auto& segment : segments)
+        {
+            if (segment.token.empty())
             {
-                Log::error("TemplateProcessor", ex.what());
+                res.append(template_data, segment.offset, segment.length);
+            }
+            else
+            {
+                res.append(data_retriever ? data_retriever->get(segment.token) : segment.token);
             }
         }
+
+        template_data = std::move(res);
     }
 }
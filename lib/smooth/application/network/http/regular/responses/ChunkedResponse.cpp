@@ -0,0 +1,122 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+#include "smooth/application/network/http/regular/responses/ChunkedResponse.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    namespace
+    {
+        constexpr std::string_view chunk_ending = "\r\n";
+        constexpr std::string_view last_chunk = "0\r\n\r\n";
+
+        std::size_t hex_digits(std::size_t value)
+        {
+            std::size_t res = 1;
+
+            while (value >>= 4)
+            {
+                ++res;
+            }
+
+            return res;
+        }
+    }
+
+    ChunkedResponse::ChunkedResponse(ResponseCode code, const std::string& content_type, Producer producer)
+            : HeaderOnlyResponse(code),
+              producer(std::move(producer))
+    {
+        headers[TRANSFER_ENCODING] = "chunked";
+        headers[CONTENT_TYPE] = content_type;
+    }
+
+    ResponseStatus ChunkedResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res{ ResponseStatus::NoData };
+
+        if (!finished)
+        {
+            // The size of the chunk is only known after producing it, so room is made for it up front.
+            // Leading zeros are allowed in the size, so it is always written using the same number of digits.
+            const auto digits = hex_digits(max_amount);
+            const auto overhead = digits + chunk_ending.size() * 2 + last_chunk.size();
+            const auto max_content = max_amount > overhead ? max_amount - overhead : 1;
+
+            const auto size_pos = target.size();
+            target.resize(size_pos + digits + chunk_ending.size());
+            const auto content_pos = target.size();
+
+            finished = !produce(max_content, target);
+            auto size = target.size() - content_pos;
+
+            if (size > max_content)
+            {
+                Log::error("Response", "Produced {} bytes, more than the {} asked for.", size, max_content);
+                res = ResponseStatus::Error;
+            }
+            else
+            {
+                if (size > 0)
+                {
+                    for (auto i = digits, remaining = size; i > 0; --i, remaining >>= 4)
+                    {
+                        target[size_pos + i - 1] = static_cast<uint8_t>("0123456789ABCDEF"[remaining & 0xF]);
+                    }
+
+                    std::copy(chunk_ending.begin(),
+                              chunk_ending.end(),
+                              target.begin() + static_cast<long>(size_pos + digits));
+                    target.insert(target.end(), chunk_ending.begin(), chunk_ending.end());
+                    content_sent += size;
+                }
+                else
+                {
+                    // An empty chunk would mark the end of the content.
+                    target.resize(size_pos);
+                }
+
+                if (finished)
+                {
+                    target.insert(target.end(), last_chunk.begin(), last_chunk.end());
+                }
+
+                res = finished ? ResponseStatus::LastData : ResponseStatus::HasMoreData;
+            }
+        }
+
+        return res;
+    }
+
+    void ChunkedResponse::dump() const
+    {
+        Log::debug("Response", "Code: {}; Chunked, sent: {} bytes", code, content_sent);
+    }
+
+    bool ChunkedResponse::produce(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        return producer && producer(max_amount, target);
+    }
+}
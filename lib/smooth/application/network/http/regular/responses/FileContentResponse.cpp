@@ -29,13 +29,66 @@ using namespace smooth::core::filesystem;
 namespace smooth::application::network::http::regular::responses
 {
     FileContentResponse::FileContentResponse(smooth::core::filesystem::Path full_path)
-            : StringResponse(ResponseCode::OK),
-              path(std::move(full_path)),
-              info(path)
+            : FileContentResponse(CachedFile::stat(full_path), utils::get_content_type(full_path))
     {
-        headers[CONTENT_LENGTH] = std::to_string(info.size());
-        headers[CONTENT_TYPE] = utils::get_content_type(info.path());
-        headers[LAST_MODIFIED] = utils::make_http_time(info.last_modified());
+    }
+
+    FileContentResponse::FileContentResponse(std::shared_ptr<const CachedFile> file,
+                                             const std::string& content_type,
+                                             const std::string& content_encoding,
+                                             const std::vector<utils::ByteRange>& ranges)
+            : StringResponse(ranges.empty() ? ResponseCode::OK : ResponseCode::Partial_Content, ResponseBody{}),
+              file(std::move(file))
+    {
+        const auto& size = this->file->size;
+        auto content_range = [size](const utils::ByteRange& r) {
+                                 return "bytes " + std::to_string(r.first) + "-" + std::to_string(r.last)
+                                        + "/" + std::to_string(size);
+                             };
+
+        if (ranges.empty())
+        {
+            parts.push_back(Part{ "", 0, size });
+            headers[CONTENT_TYPE] = content_type;
+        }
+        else if (ranges.size() == 1)
+        {
+            parts.push_back(Part{ "", ranges.front().first, ranges.front().length() });
+            headers[CONTENT_TYPE] = content_type;
+            headers[CONTENT_RANGE] = content_range(ranges.front());
+        }
+        else
+        {
+            // The boundary must not occur in the content; a fixed, unlikely, string is enough for files.
+            static const std::string boundary = "SMOOTH_BYTERANGES_2f9c81d4a6e5";
+
+            for (const auto& r : ranges)
+            {
+                auto head = parts.empty() ? std::string{} : std::string{ "\r\n" };
+                head += "--" + boundary + "\r\n";
+                head += "Content-Type: " + content_type + "\r\n";
+                head += "Content-Range: " + content_range(r) + "\r\n\r\n";
+                parts.push_back(Part{ std::move(head), r.first, r.length() });
+            }
+
+            parts.push_back(Part{ "\r\n--" + boundary + "--\r\n", 0, 0 });
+            headers[CONTENT_TYPE] = "multipart/byteranges; boundary=" + boundary;
+        }
+
+        for (const auto& part : parts)
+        {
+            total += part.head.size() + part.length;
+        }
+
+        headers[CONTENT_LENGTH] = std::to_string(total);
+        headers[ACCEPT_RANGES] = "bytes";
+        headers[LAST_MODIFIED] = utils::make_http_time(this->file->last_modified);
+        headers[ETAG] = this->file->etag;
+
+        if (!content_encoding.empty())
+        {
+            headers[CONTENT_ENCODING] = content_encoding;
+        }
     }
 
     // Called at least once when sending a response and until ResponseStatus::NoData is returned
@@ -43,16 +96,52 @@ namespace smooth::application::network::http::regular::responses
     {
         auto res = ResponseStatus::NoData;
 
-        if (sent < info.size())
+        if (sent < total)
         {
-            auto to_send = std::min(info.size() - sent, max_amount);
+            std::size_t amount = 0;
+            bool ok = true;
+
+            while (ok && amount < max_amount && current_part < parts.size())
+            {
+                const auto& part = parts[current_part];
+                auto to_send = max_amount - amount;
+
+                if (sent_of_part < part.head.size())
+                {
+                    to_send = std::min(to_send, part.head.size() - sent_of_part);
+                    auto begin = part.head.begin() + static_cast<std::ptrdiff_t>(sent_of_part);
+                    target.insert(target.end(), begin, begin + static_cast<std::ptrdiff_t>(to_send));
+                }
+                else
+                {
+                    auto done = sent_of_part - part.head.size();
+                    to_send = std::min(to_send, part.length - done);
+                    ok = to_send == 0 || append_content(part.offset + done, to_send, target);
+                }
+
+                if (ok)
+                {
+                    amount += to_send;
+                    sent_of_part += to_send;
 
-            auto read_res = smooth::core::filesystem::File::read(path, target, sent, to_send);
+                    if (sent_of_part == part.head.size() + part.length)
+                    {
+                        ++current_part;
+                        sent_of_part = 0;
+                    }
+                }
+            }
 
-            if (read_res)
+            if (ok)
             {
-                sent += to_send;
-                res = sent < info.size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+                sent += amount;
+                res = sent < total ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+
+                if (res == ResponseStatus::LastData)
+                {
+                    // Let go of the file as soon as possible.
+                    reader.reset();
+                }
             }
             else
             {
@@ -63,8 +152,119 @@ namespace smooth::application::network::http::regular::responses
         return res;
     }
 
+    bool FileContentResponse::append_content(std::size_t offset, std::size_t& length, std::vector<uint8_t>& target)
+    {
+        bool res = true;
+
+        if (file->content)
+        {
+            auto begin = file->content->cbegin() + static_cast<std::ptrdiff_t>(offset);
+            target.insert(target.end(), begin, begin + static_cast<std::ptrdiff_t>(length));
+        }
+        else if (!read_ahead.empty() && read_ahead_offset == offset)
+        {
+            length = std::min(length, read_ahead.size());
+
+            if (target.empty() && length == read_ahead.size())
+            {
+                // Hand over the buffer rather than copying it.
+                std::swap(target, read_ahead);
+                read_ahead.clear();
+            }
+            else
+            {
+                auto end = read_ahead.begin() + static_cast<std::ptrdiff_t>(length);
+                target.insert(target.end(), read_ahead.begin(), end);
+                read_ahead.erase(read_ahead.begin(), end);
+                read_ahead_offset += length;
+            }
+        }
+        else
+        {
+            read_ahead.clear();
+            res = !read_ahead_failed && read(offset, length, target);
+        }
+
+        return res;
+    }
+
+    std::shared_ptr<smooth::core::network::FileRegion> FileContentResponse::get_file_region()
+    {
+        std::shared_ptr<smooth::core::network::FileRegion> region{};
+
+        // Content held in memory is sent from there, and multiple ranges need their part headers.
+        if (sent == 0 && total > 0 && !file->content && parts.size() == 1)
+        {
+            region = smooth::core::network::FileRegion::open(file->path, parts.front().offset, total);
+
+            if (region)
+            {
+                sent = total;
+                current_part = parts.size();
+            }
+        }
+
+        return region;
+    }
+
+    void FileContentResponse::prepare_next(std::size_t max_amount)
+    {
+        if (!file->content && read_ahead.empty() && !read_ahead_failed && current_part < parts.size())
+        {
+            // Read the next content to send, of the current part or, if it is all sent, of the next.
+            auto index = current_part;
+            auto done = sent_of_part > parts[index].head.size() ? sent_of_part - parts[index].head.size() : 0;
+
+            if (done == parts[index].length && index + 1 < parts.size())
+            {
+                ++index;
+                done = 0;
+            }
+
+            const auto& part = parts[index];
+
+            if (done < part.length)
+            {
+                read_ahead_offset = part.offset + done;
+                read_ahead_failed = !read(read_ahead_offset, std::min(part.length - done, max_amount), read_ahead);
+            }
+        }
+    }
+
+    bool FileContentResponse::read(std::size_t offset, std::size_t length, std::vector<uint8_t>& target)
+    {
+        if (!reader)
+        {
+            reader = std::make_unique<smooth::core::filesystem::FileReader>(file->path, offset);
+            reader_position = offset;
+        }
+
+        bool res;
+
+        if (reader->is_open())
+        {
+            res = (reader_position == offset || reader->seek(offset)) && reader->read(target, length);
+            reader_position = offset + length;
+        }
+        else
+        {
+            // No file slot was available when the reader was created, read as files usually are.
+            reader.reset();
+            std::vector<uint8_t> data{};
+            res = smooth::core::filesystem::File::read(file->path, data, offset, length);
+            target.insert(target.end(), data.begin(), data.end());
+        }
+
+        return res;
+    }
+
     void FileContentResponse::dump() const
     {
-        Log::debug("FileContentResponse", "Code: {}; Status: {}/{} bytes, Path: {}", code, sent, info.size(), path);
+        Log::debug("FileContentResponse",
+                   "Code: {}; Status: {}/{} bytes, Path: {}",
+                   code,
+                   sent,
+                   total,
+                   file->path);
     }
 }
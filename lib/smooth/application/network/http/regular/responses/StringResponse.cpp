@@ -27,23 +27,22 @@ using namespace smooth::core::logging;
 
 namespace smooth::application::network::http::regular::responses
 {
-    StringResponse::StringResponse(ResponseCode code, std::string body, bool add_surrounding_html)
-            : HeaderOnlyResponse(code)
+    static std::string surround_with_html(std::string body, bool add_surrounding_html)
     {
-        if (add_surrounding_html)
-        {
-            add_string("<html><body>");
-        }
-
-        add_string(std::move(body));
+        return add_surrounding_html ? "<html><body>" + body + "</body></html>" : body;
+    }
 
-        if (add_surrounding_html)
-        {
-            add_string("</body></html>");
-        }
+    StringResponse::StringResponse(ResponseCode code, std::string body, bool add_surrounding_html)
+            : StringResponse(code, ResponseBody{ surround_with_html(std::move(body), add_surrounding_html) })
+    {
+    }
 
-        headers[CONTENT_LENGTH] = std::to_string(data.size());
-        headers[CONTENT_TYPE] = "text/html";
+    StringResponse::StringResponse(ResponseCode code, ResponseBody body, const std::string& content_type)
+            : HeaderOnlyResponse(code),
+              body(std::move(body))
+    {
+        headers[CONTENT_LENGTH] = std::to_string(this->body.size());
+        headers[CONTENT_TYPE] = content_type;
         headers[LAST_MODIFIED] = utils::make_http_time(std::chrono::system_clock::now());
     }
 
@@ -51,21 +50,12 @@ namespace smooth::application::network::http::regular::responses
     {
         auto res{ ResponseStatus::NoData };
 
-        auto remaining = std::distance(data.begin(), data.end());
-
-        if (remaining > 0)
+        if (body.remaining() > 0)
         {
-            auto to_send = std::min(static_cast<std::size_t>(remaining), max_amount);
-            auto begin = data.begin();
-            auto end = data.begin() + static_cast<long>(to_send);
-
-            std::copy(std::make_move_iterator(begin), std::make_move_iterator(end),
-                      std::back_inserter(target));
-            data.erase(begin, end);
+            body.take(max_amount, target);
 
             // Anything still left?
-            remaining = std::distance(data.begin(), data.end());
-            res = remaining > 0 ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+            res = body.remaining() > 0 ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
         }
 
         return res;
@@ -73,12 +63,6 @@ namespace smooth::application::network::http::regular::responses
 
     void StringResponse::dump() const
     {
-        Log::debug("Response", "Code: {}; Remaining: {} bytes", code, data.size());
-    }
-
-    void StringResponse::add_string(std::string str)
-    {
-        data.insert(data.end(), std::make_move_iterator(str.begin()),
-                    std::make_move_iterator(str.end()));
+        Log::debug("Response", "Code: {}; Remaining: {} bytes", code, body.remaining());
     }
 }
@@ -0,0 +1,198 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/application/network/http/regular/responses/TemplateResponse.h"
+#include <algorithm>
+#include <utility>
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::filesystem;
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    TemplateResponse::TemplateResponse(std::shared_ptr<const CompiledTemplate> compiled,
+                                       std::vector<std::string> values)
+            : StringResponse(ResponseCode::OK, ResponseBody{}),
+              compiled(std::move(compiled)),
+              values(std::move(values))
+    {
+        for (std::size_t i = 0; i < this->compiled->segments.size(); ++i)
+        {
+            total += length_of(i);
+        }
+
+        headers[CONTENT_LENGTH] = std::to_string(total);
+        headers[CONTENT_TYPE] = this->compiled->content_type;
+    }
+
+    ResponseStatus TemplateResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res = ResponseStatus::NoData;
+
+        if (sent < total)
+        {
+            const auto& segments = compiled->segments;
+            std::size_t amount = 0;
+            bool ok = true;
+
+            while (ok && amount < max_amount && current_segment < segments.size())
+            {
+                const auto& segment = segments[current_segment];
+                auto to_send = std::min(max_amount - amount, length_of(current_segment) - sent_of_segment);
+
+                if (segment.token.empty())
+                {
+                    ok = to_send == 0
+                         || append_literal(segment.offset + sent_of_segment, to_send, max_amount, target);
+                }
+                else
+                {
+                    auto begin = values[current_segment].begin() + static_cast<std::ptrdiff_t>(sent_of_segment);
+                    target.insert(target.end(), begin, begin + static_cast<std::ptrdiff_t>(to_send));
+                }
+
+                if (ok)
+                {
+                    amount += to_send;
+                    sent_of_segment += to_send;
+
+                    if (sent_of_segment == length_of(current_segment))
+                    {
+                        ++current_segment;
+                        sent_of_segment = 0;
+                    }
+                }
+            }
+
+            if (ok)
+            {
+                sent += amount;
+                res = sent < total ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+
+                if (res == ResponseStatus::LastData)
+                {
+                    reader.reset();
+                    block.clear();
+                    block.shrink_to_fit();
+                }
+            }
+            else
+            {
+                res = ResponseStatus::Error;
+            }
+        }
+
+        return res;
+    }
+
+    std::size_t TemplateResponse::length_of(std::size_t segment) const
+    {
+        const auto& s = compiled->segments[segment];
+
+        return s.token.empty() ? s.length : values[segment].size();
+    }
+
+    bool TemplateResponse::append_literal(std::size_t offset, std::size_t length, std::size_t read_size,
+                                          std::vector<uint8_t>& target)
+    {
+        bool res = true;
+
+        if (!compiled->content.empty())
+        {
+            auto begin = compiled->content.begin() + static_cast<std::ptrdiff_t>(offset);
+            target.insert(target.end(), begin, begin + static_cast<std::ptrdiff_t>(length));
+        }
+        else
+        {
+            if (offset < block_offset || offset + length > block_offset + block.size())
+            {
+                block.clear();
+                block_offset = offset;
+                res = read(offset, std::min(std::max(length, read_size), compiled->size - offset), block);
+            }
+
+            if (res)
+            {
+                auto begin = block.begin() + static_cast<std::ptrdiff_t>(offset - block_offset);
+                target.insert(target.end(), begin, begin + static_cast<std::ptrdiff_t>(length));
+            }
+        }
+
+        return res;
+    }
+
+    bool TemplateResponse::read(std::size_t offset, std::size_t length, std::vector<uint8_t>& target)
+    {
+        bool res = true;
+
+        if (!reader)
+        {
+            reader = std::make_unique<FileReader>(compiled->path, offset);
+            reader_position = offset;
+
+            if (reader->is_open())
+            {
+                // The file is kept open from here on, so replacing it doesn't affect the response.
+                std::size_t size{};
+                time_t last_modified{};
+                res = reader->stat(size, last_modified) && is_compiled_version(size, last_modified);
+            }
+        }
+
+        if (res && reader->is_open())
+        {
+            res = (reader_position == offset || reader->seek(offset)) && reader->read(target, length);
+            reader_position = offset + length;
+        }
+        else if (res)
+        {
+            // No file slot was available when the reader was created, read as files usually are.
+            reader.reset();
+            FileInfo info{ compiled->path };
+            std::vector<uint8_t> data{};
+            res = is_compiled_version(info.size(), info.last_modified())
+                  && File::read(compiled->path, data, offset, length);
+            target.insert(target.end(), data.begin(), data.end());
+        }
+
+        if (!res)
+        {
+            Log::error("TemplateResponse", "Failed to read template {}, or it has changed", compiled->path);
+        }
+
+        return res;
+    }
+
+    bool TemplateResponse::is_compiled_version(std::size_t size, time_t last_modified) const
+    {
+        return size == compiled->size && last_modified == compiled->last_modified;
+    }
+
+    void TemplateResponse::dump() const
+    {
+        Log::debug("TemplateResponse",
+                   "Code: {}; Status: {}/{} bytes, Path: {}",
+                   code,
+                   sent,
+                   total,
+                   compiled->path);
+    }
+}
@@ -26,7 +26,7 @@ namespace smooth::application::network::http::websocket::responses
 
         auto res{ ResponseStatus::NoData };
 
-        auto remaining = std::distance(data.begin(), data.end());
+        auto remaining = data.remaining();
 
         if (!header_sent)
         {
@@ -59,18 +59,13 @@ namespace smooth::application::network::http::websocket::responses
 
         if (remaining > 0)
         {
-            auto to_send = std::min(static_cast<std::size_t>(remaining), max_amount);
+            auto to_send = std::min(remaining, max_amount);
 
             set_length(to_send, target);
-
-            auto begin = data.begin();
-            auto end = data.begin() + static_cast<long>(to_send);
-
-            std::copy(begin, end, std::back_inserter(target));
-            data.erase(begin, end);
+            data.take(to_send, target);
 
             // Anything still left?
-            remaining = std::distance(data.begin(), data.end());
+            remaining = data.remaining();
             res = remaining > 0 ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
         }
 
@@ -83,33 +78,30 @@ namespace smooth::application::network::http::websocket::responses
     }
 
     WSResponse::WSResponse(const std::string& text, bool first_fragment, bool last_fragment)
-            : op_code(OpCode::Text), first_fragment(first_fragment), last_fragment(last_fragment)
+            : WSResponse(ResponseBody{ text }, true, first_fragment, last_fragment)
     {
-        std::copy(text.begin(), text.end(), std::back_inserter(data));
     }
 
     WSResponse::WSResponse(std::string&& text, bool first_fragment, bool last_fragment)
-            : op_code(OpCode::Text), first_fragment(first_fragment), last_fragment(last_fragment)
+            : WSResponse(ResponseBody{ std::move(text) }, true, first_fragment, last_fragment)
     {
-        std::copy(std::make_move_iterator(text.begin()),
-                  std::make_move_iterator(text.end()),
-                  std::back_inserter(data));
     }
 
     WSResponse::WSResponse(const std::vector<uint8_t>& binary, bool treat_as_text, bool first_fragment,
                            bool last_fragment)
-            : op_code(treat_as_text ? OpCode::Text : OpCode::Binary), first_fragment(first_fragment),
-              last_fragment(last_fragment)
+            : WSResponse(ResponseBody{ binary }, treat_as_text, first_fragment, last_fragment)
     {
-        std::copy(binary.begin(), binary.end(), std::back_inserter(data));
     }
 
     WSResponse::WSResponse(std::vector<uint8_t>&& binary, bool first_fragment, bool last_fragment)
-            : op_code(OpCode::Binary), first_fragment(first_fragment), last_fragment(last_fragment)
+            : WSResponse(ResponseBody{ std::move(binary) }, false, first_fragment, last_fragment)
+    {
+    }
+
+    WSResponse::WSResponse(ResponseBody body, bool treat_as_text, bool first_fragment, bool last_fragment)
+            : op_code(treat_as_text ? OpCode::Text : OpCode::Binary), first_fragment(first_fragment),
+              last_fragment(last_fragment), data(std::move(body))
     {
-        std::copy(std::make_move_iterator(binary.begin()),
-                  std::make_move_iterator(binary.end()),
-                  std::back_inserter(data));
     }
 
     void WSResponse::set_length(uint64_t len, std::vector<uint8_t>& buff) const
@@ -266,7 +266,11 @@ namespace smooth::application::network::mqtt
 
                 buff->clear();
 
-                mqtts_socket = core::network::SecureSocket<packet::MQTTProtocol>::create(buff, tls_context->create_context());
+                mqtts_socket = core::network::SecureSocket<packet::MQTTProtocol>::create(buff,
+                                                                                         tls_context->create_context(),
+                                                                                         std::chrono::milliseconds(5000),
+                                                                                         std::chrono::milliseconds{ 0 },
+                                                                                         socket_options);
                 mqtts_socket->set_receive_timeout(keep_alive + seconds{ 1 });
                 mqtts_socket->start(address);
             } 
@@ -279,7 +283,10 @@ namespace smooth::application::network::mqtt
 
                 buff->clear();
 
-                mqtt_socket = core::network::Socket<packet::MQTTProtocol>::create(buff, seconds{ 1 });
+                mqtt_socket = core::network::Socket<packet::MQTTProtocol>::create(buff,
+                                                                                  seconds{ 1 },
+                                                                                  core::network::DefaultReceiveTimeout,
+                                                                                  socket_options);
                 mqtt_socket->set_receive_timeout(keep_alive + seconds{ 1 });
                 mqtt_socket->start(address);
             }
@@ -292,6 +299,9 @@ namespace smooth::application::network::mqtt
         is_mqtts = true;
         tls_context = std::make_unique<smooth::core::network::MBedTLSContext>();
         tls_context->init_client(ca_cert);
+
+        // Reconnects resume the previous session, avoiding a full handshake.
+        tls_context->enable_client_session_cache();
         
         return true;
     }
@@ -45,6 +45,13 @@ namespace smooth::core
 #endif
     }
 
+    StatisticsSnapshot SystemStatistics::snapshot() const
+    {
+        synch guard{ lock };
+
+        return StatisticsSnapshot{ task_info, dispatcher_stats, socket_stats };
+    }
+
     static constexpr const char* dump_fmt = "{:>8} | {:>11} | {:>14} | {:>12} | {:>11} | {:>14} | {:>12}";
 
     void SystemStatistics::dump() const noexcept
@@ -80,6 +87,43 @@ namespace smooth::core
                           stat.second.get_high_water_mark(),
                           stat.second.get_stack_size() - stat.second.get_high_water_mark());
             }
+
+            const auto& d = dispatcher_stats;
+            Log::info(tag, "");
+            Log::info(tag,
+                      "Dispatcher: {} iterations, {} wakeups, {:.2f} (max {}) ready per wakeup, {} active sockets",
+                      d.iterations,
+                      d.wakeups,
+                      d.ready_fds_per_wakeup(),
+                      d.max_ready_fds,
+                      d.active_sockets);
+            Log::info(tag,
+                      "Dispatcher: {} us in select, {} us readable, {} us writable",
+                      d.select_time.count(),
+                      d.readable_time.count(),
+                      d.writable_time.count());
+
+            constexpr const char* socket_format =
+                "{:>4} | {:>21} | {:>12} | {:>12} | {:>9} | {:>9} | {:>6} | {:>7} | {:>8} | {:>9} | {:>9}";
+            Log::info(tag, socket_format, "Id", "Address", "Bytes in", "Bytes out", "Pkts in", "Pkts out",
+                      "Stalls", "Tx full", "Backoffs", "recv()", "send()");
+
+            for (const auto& s : socket_stats)
+            {
+                Log::info(tag,
+                          socket_format,
+                          s.socket_id,
+                          s.address,
+                          s.bytes_received,
+                          s.bytes_sent,
+                          s.packets_received,
+                          s.packets_sent,
+                          s.send_stalls,
+                          s.tx_buffer_full,
+                          s.back_offs,
+                          s.receive_calls,
+                          s.send_calls);
+            }
         }
     }
 
@@ -64,11 +64,36 @@ namespace smooth::core::filesystem
         cv.notify_one();
     }
 
-    FSLock::~FSLock()
+    FSLock::FSLock(std::try_to_lock_t)
     {
         std::unique_lock<std::mutex> guard{ lock };
-        count--;
-        cv.notify_one();
+
+        if (max <= 0)
+        {
+            throw std::invalid_argument("Must call FSLock::set_limit() before using FSLock");
+        }
+
+        owns = count < max;
+
+        if (owns)
+        {
+            count++;
+
+            if (count > max_ever_opened)
+            {
+                max_ever_opened = count;
+            }
+        }
+    }
+
+    FSLock::~FSLock()
+    {
+        if (owns)
+        {
+            std::unique_lock<std::mutex> guard{ lock };
+            count--;
+            cv.notify_one();
+        }
     }
 
     int FSLock::max_concurrently_opened()
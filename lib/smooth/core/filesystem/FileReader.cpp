@@ -0,0 +1,93 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "smooth/core/filesystem/FileReader.h"
+
+namespace smooth::core::filesystem
+{
+    FileReader::FileReader(const Path& path, std::size_t offset)
+    {
+        if (fs_lock.owns_lock())
+        {
+            fd = ::open(static_cast<const char*>(path), O_RDONLY);
+
+            if (fd >= 0 && !seek(offset))
+            {
+                close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    FileReader::~FileReader()
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    bool FileReader::read(std::vector<uint8_t>& target, std::size_t length)
+    {
+        auto start = target.size();
+        target.resize(start + length);
+        std::size_t received = 0;
+        bool res = is_open();
+
+        while (res && received < length)
+        {
+            auto count = ::read(fd, target.data() + start + received, length - received);
+
+            if (count > 0)
+            {
+                received += static_cast<std::size_t>(count);
+            }
+            else
+            {
+                // End of file, or an error other than an interrupted read.
+                res = count < 0 && errno == EINTR;
+            }
+        }
+
+        target.resize(start + received);
+
+        return res;
+    }
+
+    bool FileReader::seek(std::size_t offset)
+    {
+        return is_open() && lseek(fd, static_cast<off_t>(offset), SEEK_SET) == static_cast<off_t>(offset);
+    }
+
+    bool FileReader::stat(std::size_t& size, time_t& last_modified) const
+    {
+        struct stat s {};
+        bool res = is_open() && fstat(fd, &s) == 0;
+
+        if (res)
+        {
+            size = static_cast<std::size_t>(s.st_size);
+            last_modified = s.st_mtime;
+        }
+
+        return res;
+    }
+}
@@ -60,6 +60,148 @@ namespace smooth::core::network
         return res;
     }
 
+    bool CommonSocket::set_option(int level, int name, int value, const char* error)
+    {
+        bool res = setsockopt(socket_id, level, name, &value, sizeof(value)) == 0;
+
+        if (!res)
+        {
+            loge(error);
+        }
+
+        return res;
+    }
+
+    bool CommonSocket::start_with_address(std::shared_ptr<InetAddress> address)
+    {
+        bool res = true;
+        ip = std::move(address);
+
+        if (ip->resolve_ip_cached())
+        {
+            res = ip->is_valid();
+
+            if (res)
+            {
+                SocketDispatcher::instance().perform_op(SocketOperation::Op::Start, shared_from_this());
+            }
+        }
+        else
+        {
+            // Don't block the caller while the host is looked up.
+            SocketDispatcher::instance().resolve_and_start(shared_from_this(), ip);
+        }
+
+        return res;
+    }
+
+    bool CommonSocket::apply_socket_options()
+    {
+        bool res = true;
+        const auto& opt = socket_options;
+
+        auto set = [this, &res](int level, int name, int value, const char* error) {
+                       res &= set_option(level, name, value, error);
+                   };
+
+        if (opt.send_buffer_size > 0)
+        {
+            set(SOL_SOCKET, SO_SNDBUF, opt.send_buffer_size, "Failed to set send buffer size");
+        }
+
+        if (opt.receive_buffer_size > 0)
+        {
+            set(SOL_SOCKET, SO_RCVBUF, opt.receive_buffer_size, "Failed to set receive buffer size");
+        }
+
+        if (opt.no_delay)
+        {
+            set(IPPROTO_TCP, TCP_NODELAY, 1, "Failed to set no delay socket option");
+        }
+
+        if (opt.keep_alive)
+        {
+            set(SOL_SOCKET, SO_KEEPALIVE, 1, "Failed to enable keepalive");
+
+#if defined(TCP_KEEPIDLE) && defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+            if (opt.keep_alive_idle > 0)
+            {
+                set(IPPROTO_TCP, TCP_KEEPIDLE, opt.keep_alive_idle, "Failed to set keepalive idle time");
+            }
+
+            if (opt.keep_alive_interval > 0)
+            {
+                set(IPPROTO_TCP, TCP_KEEPINTVL, opt.keep_alive_interval, "Failed to set keepalive interval");
+            }
+
+            if (opt.keep_alive_count > 0)
+            {
+                set(IPPROTO_TCP, TCP_KEEPCNT, opt.keep_alive_count, "Failed to set keepalive count");
+            }
+#endif
+        }
+
+        return res;
+    }
+
+    bool CommonSocket::apply_fast_open(bool listening)
+    {
+        bool res = true;
+
+#if defined(__linux__) && !defined(ESP_PLATFORM) && defined(TCP_FASTOPEN)
+        if (socket_options.fast_open > 0)
+        {
+            if (listening)
+            {
+                res = set_option(IPPROTO_TCP, TCP_FASTOPEN, socket_options.fast_open, "Failed to enable TCP Fast Open");
+            }
+#ifdef TCP_FASTOPEN_CONNECT
+            else
+            {
+                // connect() returns immediately and the SYN is sent along with the first data written.
+                res = set_option(IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1, "Failed to enable TCP Fast Open");
+            }
+#endif
+        }
+#endif
+
+        (void)listening;
+
+        return res;
+    }
+
+    int CommonSocket::get_send_flags(bool more_follows) const
+    {
+        int flags = SEND_FLAGS;
+
+#ifdef MSG_MORE
+        if (more_follows && socket_options.coalesce_writes)
+        {
+            flags |= MSG_MORE;
+        }
+#else
+        (void)more_follows;
+#endif
+
+        return flags;
+    }
+
+    SocketStats CommonSocket::get_statistics() const
+    {
+        SocketStats stats{};
+        stats.socket_id = socket_id;
+        stats.is_server = is_server();
+
+        if (ip)
+        {
+            stats.address = ip->get_host() + ":" + std::to_string(ip->get_port());
+        }
+
+        counters.copy_to(stats);
+
+        return stats;
+    }
+
     void CommonSocket::log(const char* message)
     {
         Log::info("Socket",
@@ -0,0 +1,168 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <sys/socket.h>
+#include "smooth/core/network/DatagramBatch.h"
+
+namespace smooth::core::network
+{
+    DatagramBatch::DatagramBatch(std::size_t max_datagram_size, int batch_size)
+            : max_datagram_size(max_datagram_size),
+              batch_size(std::max(1, batch_size)),
+              receive_buffer(max_datagram_size * static_cast<std::size_t>(this->batch_size)),
+              lengths(static_cast<std::size_t>(this->batch_size)),
+              truncated(static_cast<std::size_t>(this->batch_size)),
+              send_data(static_cast<std::size_t>(this->batch_size)),
+              send_lengths(static_cast<std::size_t>(this->batch_size))
+    {
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+        const auto size = static_cast<std::size_t>(this->batch_size);
+        receive_vectors.resize(size);
+        receive_headers.resize(size);
+        send_vectors.resize(size);
+        send_headers.resize(size);
+
+        // The receive buffers never move so the headers only have to be setup once.
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            receive_vectors[i].iov_base = receive_buffer.data() + i * max_datagram_size;
+            receive_vectors[i].iov_len = max_datagram_size;
+            receive_headers[i].msg_hdr.msg_iov = &receive_vectors[i];
+            receive_headers[i].msg_hdr.msg_iovlen = 1;
+
+            send_headers[i].msg_hdr.msg_iov = &send_vectors[i];
+            send_headers[i].msg_hdr.msg_iovlen = 1;
+        }
+#endif
+    }
+
+    int DatagramBatch::receive(int socket_id, int count)
+    {
+        count = std::min(count, batch_size);
+        int res = 0;
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+        res = recvmmsg(socket_id, receive_headers.data(), static_cast<unsigned int>(count), 0, nullptr);
+
+        for (int i = 0; i < res; ++i)
+        {
+            const auto& header = receive_headers[static_cast<std::size_t>(i)];
+            lengths[static_cast<std::size_t>(i)] = static_cast<int>(header.msg_len);
+            truncated[static_cast<std::size_t>(i)] = (header.msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        }
+#else
+        bool done = false;
+
+        for (int i = 0; !done && i < count; ++i)
+        {
+            // recvmsg() rather than recv() since only it tells if the datagram was truncated.
+            iovec vector{};
+            vector.iov_base = receive_buffer.data() + static_cast<std::size_t>(i) * max_datagram_size;
+            vector.iov_len = max_datagram_size;
+
+            msghdr header{};
+            header.msg_iov = &vector;
+            header.msg_iovlen = 1;
+
+            auto length = recvmsg(socket_id, &header, 0);
+
+            if (length < 0)
+            {
+                // Report the error only if it happened on the first datagram, the rest will
+                // be picked up on the next call.
+                res = i == 0 ? -1 : res;
+                done = true;
+            }
+            else
+            {
+                lengths[static_cast<std::size_t>(i)] = static_cast<int>(length);
+                truncated[static_cast<std::size_t>(i)] = (header.msg_flags & MSG_TRUNC) != 0;
+                ++res;
+            }
+        }
+#endif
+
+        return res;
+    }
+
+    bool DatagramBatch::stage(const uint8_t* data, int length)
+    {
+        bool res = staged < batch_size;
+
+        if (res)
+        {
+            send_data[static_cast<std::size_t>(staged)] = data;
+            send_lengths[static_cast<std::size_t>(staged)] = length;
+            ++staged;
+        }
+
+        return res;
+    }
+
+    int DatagramBatch::send(int socket_id, int flags)
+    {
+        int res = 0;
+
+        if (staged > 0)
+        {
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+            for (std::size_t i = 0; i < static_cast<std::size_t>(staged); ++i)
+            {
+                send_vectors[i].iov_base = const_cast<uint8_t*>(send_data[i]);
+                send_vectors[i].iov_len = static_cast<std::size_t>(send_lengths[i]);
+            }
+
+            res = sendmmsg(socket_id, send_headers.data(), static_cast<unsigned int>(staged), flags);
+#else
+            bool done = false;
+
+            for (std::size_t i = 0; !done && i < static_cast<std::size_t>(staged); ++i)
+            {
+                auto sent = ::send(socket_id, send_data[i], static_cast<std::size_t>(send_lengths[i]), flags);
+
+                if (sent < 0)
+                {
+                    res = i == 0 ? -1 : res;
+                    done = true;
+                }
+                else
+                {
+                    ++res;
+                }
+            }
+#endif
+
+            if (res < 0 && errno == EWOULDBLOCK)
+            {
+                res = 0;
+            }
+
+            sent_bytes = 0;
+
+            for (std::size_t i = 0; i < static_cast<std::size_t>(std::max(0, res)); ++i)
+            {
+                sent_bytes += send_lengths[i];
+            }
+
+            staged = 0;
+        }
+
+        return res;
+    }
+}
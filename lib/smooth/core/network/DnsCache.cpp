@@ -0,0 +1,110 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include "smooth/core/network/DnsCache.h"
+
+using namespace std::chrono;
+
+namespace smooth::core::network
+{
+    DnsCache& DnsCache::instance()
+    {
+        static DnsCache cache;
+
+        return cache;
+    }
+
+    void DnsCache::set_ttl(std::chrono::seconds positive, std::chrono::seconds negative)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        ttl = positive;
+        negative_ttl = negative;
+    }
+
+    bool DnsCache::get(const std::string& host, std::string& resolved_ip)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        auto it = entries.find(host);
+        bool res = it != entries.end() && it->second.expires_at > steady_clock::now();
+
+        if (res)
+        {
+            resolved_ip = it->second.resolved_ip;
+        }
+
+        return res;
+    }
+
+    void DnsCache::put(const std::string& host, const std::string& resolved_ip)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        auto now = steady_clock::now();
+
+        if (entries.size() >= max_entries && entries.find(host) == entries.end())
+        {
+            purge_expired_internal(now);
+
+            if (entries.size() >= max_entries)
+            {
+                // Still full, make room by dropping the entry closest to expiring.
+                auto oldest = std::min_element(entries.begin(), entries.end(),
+                                               [](const auto& a, const auto& b) {
+                                                   return a.second.expires_at < b.second.expires_at;
+                                               });
+                entries.erase(oldest);
+            }
+        }
+
+        entries[host] = Entry{ resolved_ip, now + (resolved_ip.empty() ? negative_ttl : ttl) };
+    }
+
+    void DnsCache::remove(const std::string& host)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        entries.erase(host);
+    }
+
+    void DnsCache::purge_expired()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        purge_expired_internal(steady_clock::now());
+    }
+
+    void DnsCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        entries.clear();
+    }
+
+    void DnsCache::purge_expired_internal(steady_clock::time_point now)
+    {
+        for (auto it = entries.begin(); it != entries.end(); )
+        {
+            if (it->second.expires_at <= now)
+            {
+                it = entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
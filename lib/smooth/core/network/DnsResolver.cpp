@@ -0,0 +1,86 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/DnsResolver.h"
+#include "smooth/core/network/DnsCache.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+#include "smooth/config_constants.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::network
+{
+    DnsResolver::DnsResolver()
+            : Task("DnsResolver",
+                   CONFIG_SMOOTH_DNS_RESOLVER_STACK_SIZE,
+                   DNS_RESOLVER_PRIO,
+                   std::chrono::seconds(60)),
+              requests(RequestQueue::create(CONFIG_LWIP_MAX_SOCKETS, *this, *this))
+    {
+    }
+
+    DnsResolver& DnsResolver::instance()
+    {
+        static DnsResolver instance;
+
+        // Start task on first use
+        static bool initialized = false;
+
+        if (!initialized)
+        {
+            initialized = true;
+            instance.start();
+        }
+
+        return instance;
+    }
+
+    bool DnsResolver::resolve(std::shared_ptr<InetAddress> address, std::weak_ptr<ResponseQueue> response_queue)
+    {
+        return requests->push(DnsRequest(std::move(address), std::move(response_queue)));
+    }
+
+    void DnsResolver::event(const DnsRequest& request)
+    {
+        const auto& address = request.get_address();
+
+        if (address)
+        {
+            // The address is shared with the socket and the application, so resolve a copy of it.
+            std::shared_ptr<InetAddress> resolved = address->clone();
+
+            // A previous request for the same host may already have filled the cache.
+            if (!resolved->resolve_ip_cached())
+            {
+                resolved->resolve_ip();
+            }
+
+            auto queue = request.get_response_queue().lock();
+
+            if (queue)
+            {
+                queue->push(event::DnsResolvedEvent(address, std::move(resolved)));
+            }
+        }
+    }
+
+    void DnsResolver::tick()
+    {
+        DnsCache::instance().purge_expired();
+    }
+}
@@ -0,0 +1,115 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <limits>
+#include <unistd.h>
+#include "smooth/core/network/FileRegion.h"
+#include "smooth/core/util/create_protected.h"
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+#include <csignal>
+#include <sys/sendfile.h>
+#endif
+
+namespace smooth::core::network
+{
+    std::shared_ptr<FileRegion> FileRegion::open(const smooth::core::filesystem::Path& path,
+                                                 std::size_t offset,
+                                                 std::size_t length)
+    {
+        std::shared_ptr<FileRegion> res = smooth::core::util::create_protected_shared<FileRegion>(path,
+                                                                                                  offset,
+                                                                                                  length);
+
+        if (res->fd < 0)
+        {
+            res.reset();
+        }
+
+        return res;
+    }
+
+    FileRegion::FileRegion(const smooth::core::filesystem::Path& path, std::size_t offset, std::size_t length)
+            : offset(offset),
+              length(length)
+    {
+        // fs_lock has been acquired at this point.
+        fd = ::open(static_cast<const char*>(path), O_RDONLY);
+    }
+
+    FileRegion::~FileRegion()
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    int FileRegion::send_to(int socket_id, std::size_t already_sent, std::size_t max_amount) const
+    {
+        int res = -1;
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+        auto file_offset = static_cast<off_t>(offset + already_sent);
+        auto amount = std::min({ length - std::min(length, already_sent),
+                                 max_amount,
+                                 static_cast<std::size_t>(std::numeric_limits<int>::max()) });
+
+        // Unlike send(), sendfile() has no MSG_NOSIGNAL so block SIGPIPE while sending and
+        // discard it if raised, leaving EPIPE to be reported as an error.
+        sigset_t pipe_set{};
+        sigset_t old_set{};
+        sigemptyset(&pipe_set);
+        sigaddset(&pipe_set, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+        auto sent = sendfile(socket_id, fd, &file_offset, amount);
+
+        if (sent < 0)
+        {
+            if (errno == EWOULDBLOCK)
+            {
+                sent = 0;
+            }
+            else if (errno == EPIPE)
+            {
+                timespec no_wait{};
+                sigtimedwait(&pipe_set, nullptr, &no_wait);
+            }
+        }
+        else if (sent == 0 && amount > 0)
+        {
+            // End of file, i.e. the file has shrunk since the region was opened and
+            // the rest of the region will never be sent.
+            sent = -1;
+        }
+
+        pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+
+        res = sent < 0 ? -1 : static_cast<int>(sent);
+#else
+        (void)socket_id;
+        (void)already_sent;
+        (void)max_amount;
+#endif
+
+        return res;
+    }
+}
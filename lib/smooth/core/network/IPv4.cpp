@@ -25,6 +25,7 @@ limitations under the License.
 #include <arpa/inet.h>
 #include "smooth/core/logging/log.h"
 #include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/DnsCache.h"
 
 using namespace smooth::core::logging;
 
@@ -68,25 +69,41 @@ namespace smooth::core::network
         return sizeof(sock_address);
     }
 
-    bool IPv4::resolve_ip()
+    bool IPv4::resolve_ip_cached()
     {
         std::smatch match;
+        std::string ip{};
+
+        bool res = std::regex_match(host, match, numeric_ip);
 
-        if (std::regex_match(host, match, numeric_ip))
+        if (res)
         {
             // Already an IP
-            resolved_ip = host;
-            sock_address.sin_family = AF_INET;
-            sock_address.sin_port = htons(static_cast<uint16_t>(port));
-            valid = inet_pton(AF_INET, host.c_str(), &sock_address.sin_addr) == 1;
+            ip = host;
         }
         else
         {
-            memset(&sock_address, 0, sizeof(sock_address));
+            res = DnsCache::instance().get(host, ip);
+        }
 
+        if (res)
+        {
+            assign(ip);
+        }
+
+        return res;
+    }
+
+    bool IPv4::resolve_ip()
+    {
+        if (!resolve_ip_cached())
+        {
+            std::string ip{};
             struct addrinfo* result = nullptr;
+            addrinfo hints{};
+            hints.ai_family = AF_INET;
 
-            auto res = getaddrinfo(host.c_str(), nullptr, nullptr, &result);
+            auto res = getaddrinfo(host.c_str(), nullptr, &hints, &result);
 
             if (res != 0)
             {
@@ -105,21 +122,33 @@ namespace smooth::core::network
 #pragma GCC diagnostic ignored "-Wcast-align"
                     auto p = reinterpret_cast<sockaddr_in*>(result->ai_addr);
 #pragma GCC diagnostic pop
-                    sock_address = *p;
-                    sock_address.sin_port = htons(static_cast<uint16_t>(port));
 
-                    char address[100];
-                    valid = inet_ntop(result->ai_family, &p->sin_addr, address, sizeof(address));
+                    char address[INET_ADDRSTRLEN];
 
-                    resolved_ip = address;
-
-                    Log::info("IPv4", "{} resolved to {}", host, get_resolved_ip());
+                    if (inet_ntop(AF_INET, &p->sin_addr, address, sizeof(address)))
+                    {
+                        ip = address;
+                        Log::info("IPv4", "{} resolved to {}", host, ip);
+                    }
                 }
 
                 freeaddrinfo(result);
             }
+
+            // Failed lookups are cached too, for a shorter time.
+            DnsCache::instance().put(host, ip);
+            assign(ip);
         }
 
         return valid;
     }
+
+    void IPv4::assign(const std::string& ip)
+    {
+        memset(&sock_address, 0, sizeof(sock_address));
+        resolved_ip = ip;
+        sock_address.sin_family = AF_INET;
+        sock_address.sin_port = htons(static_cast<uint16_t>(port));
+        valid = !ip.empty() && inet_pton(AF_INET, ip.c_str(), &sock_address.sin_addr) == 1;
+    }
 }
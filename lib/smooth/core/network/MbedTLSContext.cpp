@@ -50,15 +50,55 @@ namespace smooth::core::network
         Log::error(log_tag, "{} returned {}: {}", prefix, err_code, buf);
     }
 
+    void ClientSessionCache::save(const mbedtls_ssl_context* ssl)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        // mbedtls_ssl_get_session() expects a fresh session structure.
+        mbedtls_ssl_session_free(&session);
+        mbedtls_ssl_session_init(&session);
+
+        auto res = mbedtls_ssl_get_session(ssl, &session);
+        valid = res == 0;
+
+        if (!valid)
+        {
+            log_mbedtls_error(tag, "mbedtls_ssl_get_session", res);
+        }
+    }
+
+    void ClientSessionCache::apply(mbedtls_ssl_context* ssl)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        if (valid)
+        {
+            auto res = mbedtls_ssl_set_session(ssl, &session);
+
+            if (res != 0)
+            {
+                log_mbedtls_error(tag, "mbedtls_ssl_set_session", res);
+            }
+        }
+    }
+
+    void ClientSessionCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        mbedtls_ssl_session_free(&session);
+        mbedtls_ssl_session_init(&session);
+        valid = false;
+    }
+
     MBedTLSContext::MBedTLSContext()
     {
-        mbedtls_pk_init(&pk_key);
         mbedtls_ssl_config_init(&conf);
-        mbedtls_x509_crt_init(&ca_cert);
-        mbedtls_x509_crt_init(&ca_chain);
-        mbedtls_x509_crt_init(&server_cert);
-        mbedtls_entropy_init(&entropy);
-        mbedtls_ctr_drbg_init(&ctr_drbg);
+#ifdef MBEDTLS_SSL_CACHE_C
+        mbedtls_ssl_cache_init(&server_sessions);
+#endif
+#ifdef MBEDTLS_SSL_TICKET_C
+        mbedtls_ssl_ticket_init(&ticket_keys);
+#endif
 
 #if defined(ESP_PLATFORM)
     #if defined(CONFIG_MBEDTLS_DEBUG)
@@ -70,28 +110,26 @@ namespace smooth::core::network
 #endif
     }
 
-    int MBedTLSContext::common_init(bool server)
+    bool MBedTLSContext::common_init(bool server)
     {
-        auto res = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, nullptr, 0);
+        // The random generator is shared by all contexts and only seeded once.
+        auto res = SharedRandom::is_ready();
 
-        if (res != 0)
-        {
-            log_mbedtls_error(tag, "mbedtls_ctr_drbg_seed returned", res);
-        }
-        else
+        if (res)
         {
-            res = mbedtls_ssl_config_defaults(&conf,
-                                              server ? MBEDTLS_SSL_IS_SERVER : MBEDTLS_SSL_IS_CLIENT,
-                                              MBEDTLS_SSL_TRANSPORT_STREAM,
-                                              MBEDTLS_SSL_PRESET_DEFAULT);
+            auto err = mbedtls_ssl_config_defaults(&conf,
+                                                   server ? MBEDTLS_SSL_IS_SERVER : MBEDTLS_SSL_IS_CLIENT,
+                                                   MBEDTLS_SSL_TRANSPORT_STREAM,
+                                                   MBEDTLS_SSL_PRESET_DEFAULT);
+            res = err == 0;
 
-            if (res != 0)
+            if (!res)
             {
-                log_mbedtls_error(tag, "mbedtls_ssl_config_defaults", res);
+                log_mbedtls_error(tag, "mbedtls_ssl_config_defaults", err);
             }
             else
             {
-                mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &ctr_drbg);
+                mbedtls_ssl_conf_rng(&conf, SharedRandom::random, nullptr);
             }
         }
 
@@ -102,7 +140,7 @@ namespace smooth::core::network
     {
         auto res = common_init(false);
 
-        if (res == 0)
+        if (res)
         {
             if (ca_certificates.empty())
             {
@@ -112,16 +150,17 @@ namespace smooth::core::network
             {
                 mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_REQUIRED);
 
-                res = load_certificate(ca_certificates, ca_cert);
+                ca_cert = SharedCertificate::get(ca_certificates);
+                res = ca_cert != nullptr;
 
-                if (res == 0)
+                if (res)
                 {
-                    mbedtls_ssl_conf_ca_chain(&conf, &ca_cert, nullptr);
+                    mbedtls_ssl_conf_ca_chain(&conf, ca_cert->get_crt(), nullptr);
                 }
             }
         }
 
-        return res == 0;
+        return res;
     }
 
     bool MBedTLSContext::init_server(const std::vector<unsigned char>& ca_certificates,
@@ -131,36 +170,24 @@ namespace smooth::core::network
     {
         auto res = common_init(true);
 
-        if (res == 0)
+        if (res)
         {
-            res = load_certificate(server_certificate, server_cert);
+            // Certificates and keys are parsed once and shared with other contexts using the same data.
+            server_cert = SharedCertificate::get(server_certificate);
+            ca_cert = SharedCertificate::get(ca_certificates);
+            pk_key = SharedPrivateKey::get(private_key, password);
 
-            if (res == 0)
-            {
-                res = load_certificate(ca_certificates, ca_cert);
-            }
+            res = server_cert && ca_cert && pk_key;
 
-            if (res == 0)
+            if (res)
             {
-                res = mbedtls_pk_parse_key(&pk_key,
-                                           private_key.data(),
-                                           private_key.size(),
-                                           password.data(),
-                                           password.size());
+                mbedtls_ssl_conf_ca_chain(&conf, ca_cert->get_crt(), nullptr);
+                auto err = mbedtls_ssl_conf_own_cert(&conf, server_cert->get_crt(), pk_key->get_pk());
+                res = err == 0;
 
-                if (res != 0)
-                {
-                    log_mbedtls_error(tag, "mbedtls_pk_parse_key", res);
-                }
-                else
+                if (!res)
                 {
-                    mbedtls_ssl_conf_ca_chain(&conf, &ca_cert, nullptr);
-                    res = mbedtls_ssl_conf_own_cert(&conf, &server_cert, &pk_key);
-
-                    if (res != 0)
-                    {
-                        log_mbedtls_error(tag, "mbedtls_ssl_conf_own_cert", res);
-                    }
+                    log_mbedtls_error(tag, "mbedtls_ssl_conf_own_cert", err);
                 }
             }
         }
@@ -168,31 +195,64 @@ namespace smooth::core::network
         return res;
     }
 
-    MBedTLSContext::~MBedTLSContext()
+    void MBedTLSContext::enable_client_session_cache()
     {
-        mbedtls_ctr_drbg_free(&ctr_drbg);
-        mbedtls_entropy_free(&entropy);
-        mbedtls_x509_crt_free(&ca_chain);
-        mbedtls_x509_crt_free(&ca_cert);
-        mbedtls_x509_crt_free(&server_cert);
-        mbedtls_ssl_config_free(&conf);
-        mbedtls_pk_free(&pk_key);
+        client_sessions = std::make_shared<ClientSessionCache>();
     }
 
-    int MBedTLSContext::load_certificate(const std::vector<unsigned char>& cert, mbedtls_x509_crt& target)
+    bool MBedTLSContext::enable_server_session_cache(int max_entries, std::chrono::seconds lifetime, bool use_tickets)
     {
-        auto res = mbedtls_x509_crt_parse(&target, cert.data(), cert.size());
+        auto res = 0;
 
-        if (res < 0)
+#ifdef MBEDTLS_SSL_CACHE_C
+        mbedtls_ssl_cache_set_max_entries(&server_sessions, max_entries);
+        mbedtls_ssl_cache_set_timeout(&server_sessions, static_cast<int>(lifetime.count()));
+        mbedtls_ssl_conf_session_cache(&conf, &server_sessions, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+#else
+        (void)max_entries;
+        Log::warning(tag, "Session cache not available, MBEDTLS_SSL_CACHE_C is not enabled.");
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C) && defined(MBEDTLS_SSL_SESSION_TICKETS)
+        if (use_tickets)
         {
-            log_mbedtls_error(tag, "mbedtls_x509_crt_parse", res);
+            res = mbedtls_ssl_ticket_setup(&ticket_keys,
+                                           SharedRandom::random,
+                                           nullptr,
+                                           MBEDTLS_CIPHER_AES_256_GCM,
+                                           static_cast<uint32_t>(lifetime.count()));
+
+            if (res != 0)
+            {
+                log_mbedtls_error(tag, "mbedtls_ssl_ticket_setup", res);
+            }
+            else
+            {
+                mbedtls_ssl_conf_session_tickets_cb(&conf,
+                                                    mbedtls_ssl_ticket_write,
+                                                    mbedtls_ssl_ticket_parse,
+                                                    &ticket_keys);
+            }
         }
-        else if (res > 0)
+#else
+        if (use_tickets)
         {
-            Log::error("MBedTLSContext", "mbedtls_x509_crt_parse failed to parse {} certificates.", res);
+            Log::warning(tag, "Session tickets not available, MBEDTLS_SSL_TICKET_C is not enabled.");
         }
+#endif
 
-        return res;
+        return res == 0;
+    }
+
+    MBedTLSContext::~MBedTLSContext()
+    {
+#ifdef MBEDTLS_SSL_TICKET_C
+        mbedtls_ssl_ticket_free(&ticket_keys);
+#endif
+#ifdef MBEDTLS_SSL_CACHE_C
+        mbedtls_ssl_cache_free(&server_sessions);
+#endif
+        mbedtls_ssl_config_free(&conf);
     }
 
     std::unique_ptr<SSLContext> MBedTLSContext::create_context()
@@ -204,6 +264,11 @@ namespace smooth::core::network
         {
             log_mbedtls_error(tag, "mbedtls_ssl_setup", res);
         }
+        else if (client_sessions)
+        {
+            context->set_session_cache(client_sessions);
+            client_sessions->apply(*context);
+        }
 
         return context;
     }
@@ -0,0 +1,180 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <array>
+#include <map>
+#include <mbedtls/platform_util.h>
+#include "smooth/core/network/MbedTLSShared.h"
+#include "smooth/core/network/MbedTLSContext.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/application/hash/sha.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::network
+{
+    static constexpr const char* tag = "MBedTLSShared";
+
+    using Digest = std::array<uint8_t, 32>;
+
+    /// Shared objects by the digest of the data they were parsed from. Only the digest is kept,
+    /// never a copy of the data which, for private keys, is secret.
+    template<typename T>
+    using Registry = std::map<Digest, std::weak_ptr<T>>;
+
+    /// Looks up a shared object by the digest of the data it was parsed from, pruning objects no longer in use.
+    template<typename T>
+    static std::shared_ptr<T> find(Registry<T>& registry, const Digest& key)
+    {
+        for (auto it = registry.begin(); it != registry.end();)
+        {
+            it = it->second.expired() ? registry.erase(it) : std::next(it);
+        }
+
+        auto it = registry.find(key);
+
+        return it == registry.end() ? std::shared_ptr<T>{} : it->second.lock();
+    }
+
+    SharedRandom::SharedRandom()
+    {
+        mbedtls_entropy_init(&entropy);
+        mbedtls_ctr_drbg_init(&ctr_drbg);
+
+        auto res = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, nullptr, 0);
+        seeded = res == 0;
+
+        if (!seeded)
+        {
+            log_mbedtls_error(tag, "mbedtls_ctr_drbg_seed", res);
+        }
+    }
+
+    SharedRandom::~SharedRandom()
+    {
+        mbedtls_ctr_drbg_free(&ctr_drbg);
+        mbedtls_entropy_free(&entropy);
+    }
+
+    SharedRandom& SharedRandom::instance()
+    {
+        static SharedRandom random{};
+
+        return random;
+    }
+
+    bool SharedRandom::is_ready()
+    {
+        return instance().seeded;
+    }
+
+    int SharedRandom::random(void* /*ctx*/, unsigned char* output, size_t len)
+    {
+        auto& r = instance();
+        std::lock_guard<std::mutex> lock(r.guard);
+
+        return mbedtls_ctr_drbg_random(&r.ctr_drbg, output, len);
+    }
+
+    SharedCertificate::SharedCertificate()
+    {
+        mbedtls_x509_crt_init(&crt);
+    }
+
+    SharedCertificate::~SharedCertificate()
+    {
+        mbedtls_x509_crt_free(&crt);
+    }
+
+    std::shared_ptr<SharedCertificate> SharedCertificate::get(const std::vector<unsigned char>& data)
+    {
+        static std::mutex guard{};
+        static Registry<SharedCertificate> registry{};
+
+        std::lock_guard<std::mutex> lock(guard);
+        auto key = smooth::application::hash::sha256(data.data(), data.size());
+        auto cert = find(registry, key);
+
+        if (!cert)
+        {
+            cert = std::make_shared<SharedCertificate>();
+            auto res = mbedtls_x509_crt_parse(&cert->crt, data.data(), data.size());
+
+            if (res < 0)
+            {
+                log_mbedtls_error(tag, "mbedtls_x509_crt_parse", res);
+                cert.reset();
+            }
+            else if (res > 0)
+            {
+                Log::error(tag, "mbedtls_x509_crt_parse failed to parse {} certificates.", res);
+                cert.reset();
+            }
+            else
+            {
+                registry[key] = cert;
+            }
+        }
+
+        return cert;
+    }
+
+    SharedPrivateKey::SharedPrivateKey()
+    {
+        mbedtls_pk_init(&pk);
+    }
+
+    SharedPrivateKey::~SharedPrivateKey()
+    {
+        mbedtls_pk_free(&pk);
+    }
+
+    std::shared_ptr<SharedPrivateKey> SharedPrivateKey::get(const std::vector<unsigned char>& data,
+                                                            const std::vector<unsigned char>& password)
+    {
+        static std::mutex guard{};
+        static Registry<SharedPrivateKey> registry{};
+
+        std::lock_guard<std::mutex> lock(guard);
+
+        // The password is part of the key so that the same data with a different password is parsed again.
+        auto data_digest = smooth::application::hash::sha256(data.data(), data.size());
+        std::vector<unsigned char> salted{ data_digest.begin(), data_digest.end() };
+        salted.insert(salted.end(), password.begin(), password.end());
+        auto key = smooth::application::hash::sha256(salted.data(), salted.size());
+        mbedtls_platform_zeroize(salted.data(), salted.size());
+        auto pk = find(registry, key);
+
+        if (!pk)
+        {
+            pk = std::make_shared<SharedPrivateKey>();
+            auto res = mbedtls_pk_parse_key(&pk->pk, data.data(), data.size(), password.data(), password.size());
+
+            if (res != 0)
+            {
+                log_mbedtls_error(tag, "mbedtls_pk_parse_key", res);
+                pk.reset();
+            }
+            else
+            {
+                registry[key] = pk;
+            }
+        }
+
+        return pk;
+    }
+}
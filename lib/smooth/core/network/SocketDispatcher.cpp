@@ -18,6 +18,8 @@ limitations under the License.
 #include <algorithm>
 #include <functional>
 #include "smooth/core/network/SocketDispatcher.h"
+#include "smooth/core/network/DnsResolver.h"
+#include "smooth/core/SystemStatistics.h"
 #include "smooth/core/task_priorities.h"
 #include "smooth/config_constants.h"
 
@@ -59,30 +61,54 @@ namespace smooth::core::network
               network_events(NetworkEventQueue::create(10, *this, *this)),
               socket_op(SocketOperationQueue::create(CONFIG_LWIP_MAX_SOCKETS,
                                                      *this,
-                                                     *this))
+                                                     *this)),
+              dns_events(DnsEventQueue::create(CONFIG_LWIP_MAX_SOCKETS, *this, *this))
     {
         clear_sets();
     }
 
+    void SocketDispatcher::init()
+    {
+        dispatcher_thread = std::this_thread::get_id();
+        statistics_timer.start();
+    }
+
     void SocketDispatcher::tick()
     {
         std::lock_guard<std::mutex> lock(socket_guard);
         restart_inactive_sockets();
         check_socket_timeouts();
 
+        ++stats.iterations;
         int max_file_descriptor = build_sets();
 
         if (max_file_descriptor >= 0)
         {
             set_timeout();
+            auto select_start = steady_clock::now();
             int res = select(max_file_descriptor + 1, &read_set, &write_set, nullptr, &tv);
+            auto select_end = steady_clock::now();
+            stats.select_time += duration_cast<microseconds>(select_end - select_start);
 
             if (res == -1)
             {
                 Log::error(tag, "Error during select: {}", strerror(errno));
             }
-            else if (res > 0)
+            else if (res > 0 || !buffered_sockets.empty())
             {
+                if (res > 0)
+                {
+                    ++stats.wakeups;
+                    stats.ready_fds += static_cast<uint64_t>(res);
+                    stats.max_ready_fds = std::max(stats.max_ready_fds, static_cast<uint32_t>(res));
+                }
+
+                // Sockets with buffered data are readable whether or not more data has arrived.
+                for (auto id : buffered_sockets)
+                {
+                    set_fd(static_cast<FD>(id), read_set);
+                }
+
                 for (int i = 0; i <= max_file_descriptor; ++i)
                 {
                     if (is_fd_set(static_cast<FD>(i), read_set))
@@ -91,7 +117,9 @@ namespace smooth::core::network
 
                         if (it != active_sockets.end())
                         {
+                            auto start = steady_clock::now();
                             it->second->readable(*this);
+                            stats.readable_time += duration_cast<microseconds>(steady_clock::now() - start);
                         }
                     }
 
@@ -101,7 +129,9 @@ namespace smooth::core::network
 
                         if (it != active_sockets.end())
                         {
+                            auto start = steady_clock::now();
                             it->second->writable();
+                            stats.writable_time += duration_cast<microseconds>(steady_clock::now() - start);
                         }
                     }
                 }
@@ -124,12 +154,34 @@ namespace smooth::core::network
             // operation, but only when there was no socket read/write to do prior to that operation being queued.
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
+
+        report_statistics();
+    }
+
+    void SocketDispatcher::report_statistics()
+    {
+        if (statistics_timer.get_running_time() >= statistics_interval)
+        {
+            statistics_timer.reset();
+            stats.active_sockets = active_sockets.size();
+
+            std::vector<SocketStats> socket_stats{};
+            socket_stats.reserve(active_sockets.size());
+
+            for (const auto& pair : active_sockets)
+            {
+                socket_stats.emplace_back(pair.second->get_statistics());
+            }
+
+            SystemStatistics::instance().report(stats, std::move(socket_stats));
+        }
     }
 
     void SocketDispatcher::set_timeout()
     {
         tv.tv_sec = 0;
-        tv.tv_usec = 10000;
+        // Don't wait for the network when there already is data to process.
+        tv.tv_usec = buffered_sockets.empty() ? 10000 : 0;
     }
 
     void SocketDispatcher::clear_sets()
@@ -144,6 +196,7 @@ namespace smooth::core::network
     int SocketDispatcher::build_sets()
     {
         clear_sets();
+        buffered_sockets.clear();
 
         int max = ISocket::INVALID_SOCKET;
 
@@ -162,9 +215,15 @@ namespace smooth::core::network
                         set_fd(static_cast<FD>(s->get_socket_id()), write_set);
                     }
 
-                    if (s->is_connected())
+                    // Stop reading from sockets whose receive buffers are full, i.e. apply backpressure.
+                    if (s->is_connected() && s->has_receive_capacity())
                     {
                         set_fd(static_cast<FD>(s->get_socket_id()), read_set);
+
+                        if (s->has_buffered_data())
+                        {
+                            buffered_sockets.push_back(s->get_socket_id());
+                        }
                     }
                 }
             }
@@ -199,6 +258,7 @@ namespace smooth::core::network
         remove_socket_from_active_sockets(socket);
         remove_socket_from_collection(inactive_sockets, socket);
         remove_backed_off_socket(socket->get_socket_id());
+        remove_resolving_socket(socket);
 
         auto socket_id = socket->get_socket_id();
 
@@ -318,9 +378,33 @@ namespace smooth::core::network
             start_socket(event.get_socket());
         }
         else if (event.get_op() == SocketOperation::Op::AddActiveSocket)
+        {
+            add_active_socket(event.get_socket());
+        }
+        else if (event.get_op() == SocketOperation::Op::ResolveAndStart)
         {
             auto socket = event.get_socket();
-            active_sockets.emplace(socket->get_socket_id(), socket);
+            bool queued;
+
+            {
+                std::lock_guard<std::mutex> lock(socket_guard);
+                remove_resolving_socket(socket);
+                resolving_sockets.emplace_back(event.get_address(), socket);
+                queued = DnsResolver::instance().resolve(event.get_address(), dns_events);
+
+                if (!queued)
+                {
+                    remove_resolving_socket(socket);
+                }
+            }
+
+            if (!queued)
+            {
+                Log::error(tag, "DNS request queue full, could not resolve {}", event.get_address()->get_host());
+
+                // Let the application know the socket won't be connected.
+                socket->publish_connected_status();
+            }
         }
         else
         {
@@ -335,6 +419,77 @@ namespace smooth::core::network
         socket_op->push(SocketOperation(op, std::move(socket)));
     }
 
+    void SocketDispatcher::add_active_socket(std::shared_ptr<ISocket> socket)
+    {
+        if (std::this_thread::get_id() == dispatcher_thread)
+        {
+            active_sockets.emplace(socket->get_socket_id(), std::move(socket));
+        }
+        else
+        {
+            perform_op(SocketOperation::Op::AddActiveSocket, std::move(socket));
+        }
+    }
+
+    void SocketDispatcher::resolve_and_start(std::shared_ptr<ISocket> socket, std::shared_ptr<InetAddress> address)
+    {
+        // Pass through the operation queue to keep the order relative to other operations, e.g. a preceding stop.
+        socket_op->push(SocketOperation(SocketOperation::Op::ResolveAndStart, std::move(socket), std::move(address)));
+    }
+
+    void SocketDispatcher::event(const event::DnsResolvedEvent& event)
+    {
+        std::vector<std::shared_ptr<ISocket>> resolved{};
+
+        {
+            std::lock_guard<std::mutex> lock(socket_guard);
+
+            for (auto it = resolving_sockets.begin(); it != resolving_sockets.end(); )
+            {
+                if (it->first == event.get_address())
+                {
+                    resolved.emplace_back(std::move(it->second));
+                    it = resolving_sockets.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        if (!resolved.empty() && event.get_resolved())
+        {
+            // Applied here rather than on the DnsResolver task since the address is in use by the socket.
+            event.get_address()->assign(*event.get_resolved());
+        }
+
+        for (auto& socket : resolved)
+        {
+            if (event.is_resolved())
+            {
+                start_socket(socket);
+            }
+            else
+            {
+                Log::error(tag, "Could not resolve {}", event.get_address()->get_host());
+
+                // Let the application know the socket won't be connected.
+                socket->publish_connected_status();
+            }
+        }
+    }
+
+    void SocketDispatcher::remove_resolving_socket(const std::shared_ptr<ISocket>& socket)
+    {
+        resolving_sockets.erase(std::remove_if(resolving_sockets.begin(),
+                                               resolving_sockets.end(),
+                                               [&socket](const auto& pair) {
+                                                   return pair.second == socket;
+                                               }),
+                                resolving_sockets.end());
+    }
+
     void SocketDispatcher::check_socket_timeouts()
     {
         for (auto& pair : active_sockets)
@@ -371,6 +526,13 @@ namespace smooth::core::network
     void SocketDispatcher::back_off(int socket_id, std::chrono::milliseconds duration)
     {
         backed_off[socket_id] = steady_clock::now() + duration;
+
+        auto it = active_sockets.find(socket_id);
+
+        if (it != active_sockets.end())
+        {
+            it->second->get_counters().add_back_off();
+        }
     }
 
     bool SocketDispatcher::is_backed_off(int socket_id)
@@ -0,0 +1,107 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/TlsBio.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#include <sys/socket.h>
+#pragma GCC diagnostic pop
+#include "smooth/core/network/ISocket.h"
+
+namespace smooth::core::network
+{
+    void TlsBio::attach(mbedtls_ssl_context* ssl)
+    {
+        mbedtls_ssl_set_bio(ssl, this, send, recv, nullptr);
+    }
+
+    int TlsBio::send(void* ctx, const unsigned char* buf, size_t len)
+    {
+        auto bio = static_cast<TlsBio*>(ctx);
+        bio->counters.add_send_call();
+        errno = 0;
+
+        int amount_sent = static_cast<int>(::send(bio->socket_id, buf, len, ISocket::SEND_FLAGS));
+
+        if (amount_sent < 0 && errno == EWOULDBLOCK)
+        {
+            amount_sent = MBEDTLS_ERR_SSL_WANT_WRITE;
+        }
+
+        // A partial send is returned as is; mbedTLS keeps track of what remains of the record.
+        return amount_sent;
+    }
+
+    int TlsBio::recv(void* ctx, unsigned char* buf, size_t len)
+    {
+        return static_cast<TlsBio*>(ctx)->receive(buf, len);
+    }
+
+    int TlsBio::receive(unsigned char* buf, size_t len)
+    {
+        int res;
+
+        if (position < end)
+        {
+            auto amount = std::min(len, end - position);
+            memcpy(buf, read_ahead.data() + position, amount);
+            position += amount;
+            res = static_cast<int>(amount);
+        }
+        else
+        {
+            // Large requests go straight to the caller's buffer.
+            const bool direct = len >= read_ahead_size;
+
+            if (!direct && read_ahead.empty())
+            {
+                read_ahead.resize(read_ahead_size);
+            }
+
+            counters.add_receive_call();
+            errno = 0;
+
+            res = static_cast<int>(::recv(socket_id,
+                                     direct ? buf : read_ahead.data(),
+                                     direct ? len : read_ahead.size(),
+                                     0));
+
+            if (res < 0)
+            {
+                if (errno == EWOULDBLOCK)
+                {
+                    res = MBEDTLS_ERR_SSL_WANT_READ;
+                }
+            }
+            else if (!direct && res > 0)
+            {
+                position = 0;
+                end = static_cast<std::size_t>(res);
+
+                auto amount = std::min(len, end);
+                memcpy(buf, read_ahead.data(), amount);
+                position = amount;
+                res = static_cast<int>(amount);
+            }
+        }
+
+        return res;
+    }
+}
@@ -0,0 +1,115 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include "smooth/core/network/TlsHandshakeWorker.h"
+#include "smooth/core/task_priorities.h"
+#include "smooth/config_constants.h"
+
+namespace smooth::core::network
+{
+    TlsHandshakeWorker::TlsHandshakeWorker()
+            : Task("TlsHandshake",
+                   CONFIG_SMOOTH_TLS_HANDSHAKE_STACK_SIZE,
+                   TLS_HANDSHAKE_PRIO,
+                   std::chrono::seconds(60)),
+              capacity(static_cast<std::size_t>(CONFIG_LWIP_MAX_SOCKETS)),
+              wake_up(WakeUpQueue::create(1, *this, *this))
+    {
+    }
+
+    TlsHandshakeWorker& TlsHandshakeWorker::instance()
+    {
+        static TlsHandshakeWorker instance;
+
+        // Start task on first use
+        static bool initialized = false;
+
+        if (!initialized)
+        {
+            initialized = true;
+            instance.start();
+        }
+
+        return instance;
+    }
+
+    void TlsHandshakeWorker::reserve(int count)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        capacity += static_cast<std::size_t>(std::max(0, count));
+    }
+
+    void TlsHandshakeWorker::release(int count)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        capacity -= std::min(capacity - static_cast<std::size_t>(CONFIG_LWIP_MAX_SOCKETS),
+                             static_cast<std::size_t>(std::max(0, count)));
+    }
+
+    bool TlsHandshakeWorker::perform(std::weak_ptr<ITlsHandshake> handshake)
+    {
+        bool res;
+
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            res = pending.size() < capacity;
+
+            if (res)
+            {
+                pending.emplace_back(std::move(handshake));
+            }
+        }
+
+        if (res)
+        {
+            // Fails when a wake up already is queued, which then also covers this handshake.
+            wake_up->push(TlsHandshakeRequest{});
+        }
+
+        return res;
+    }
+
+    void TlsHandshakeWorker::event(const TlsHandshakeRequest& /*request*/)
+    {
+        TlsHandshakeRequest request{};
+
+        while (take_next(request))
+        {
+            auto handshake = request.get_handshake().lock();
+
+            if (handshake)
+            {
+                handshake->run_handshake();
+            }
+        }
+    }
+
+    bool TlsHandshakeWorker::take_next(TlsHandshakeRequest& request)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        bool res = !pending.empty();
+
+        if (res)
+        {
+            request = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        return res;
+    }
+}
@@ -16,7 +16,9 @@ limitations under the License.
 */
 
 #include <string>
+#include <string_view>
 #include <algorithm>
+#include "smooth/core/util/string_util.h"
 
 namespace smooth::core::string_util
 {
@@ -31,7 +33,7 @@ namespace smooth::core::string_util
         }
     }
 
-    bool icontains(const std::string& s, const std::string& to_find)
+    bool icontains(std::string_view s, std::string_view to_find)
     {
         auto iequal = [](const unsigned char c, const unsigned char c2)
                       {
@@ -41,12 +43,12 @@ namespace smooth::core::string_util
         return std::search(s.begin(), s.end(), to_find.begin(), to_find.end(), iequal) != s.end();
     }
 
-    bool equals(const std::string& s, const std::string& s2)
+    bool equals(std::string_view s, std::string_view s2)
     {
         return s == s2;
     }
 
-    bool iequals(const std::string& s, const std::string& s2)
+    bool iequals(std::string_view s, std::string_view s2)
     {
         return std::equal(s.begin(), s.end(), s2.begin(), s2.end(),
                           [](unsigned char c, unsigned char c2) {
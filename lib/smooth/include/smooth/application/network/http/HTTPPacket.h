@@ -18,12 +18,16 @@ limitations under the License.
 #pragma once
 
 #include <algorithm>
+#include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include "smooth/core/network/IPacketDisassembly.h"
+#include "smooth/core/network/FileRegion.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
 #include "regular/HTTPMethod.h"
+#include "regular/HeaderMap.h"
 #include "websocket/OpCode.h"
 
 namespace smooth::application::network::http
@@ -66,6 +70,17 @@ namespace smooth::application::network::http
                 return content.data();
             }
 
+            const smooth::core::network::FileRegion* get_file_region() override
+            {
+                return file.get();
+            }
+
+            /// Sets a file region to be sent after the content of the packet.
+            void set_file_region(std::shared_ptr<smooth::core::network::FileRegion> region)
+            {
+                file = std::move(region);
+            }
+
             const auto& get_buffer()
             {
                 return content;
@@ -91,7 +106,11 @@ namespace smooth::application::network::http
                 return continuation;
             }
 
-            void set_request_data(const std::string& method, const std::string& url, const std::string& version)
+            /// Sets the request line data.
+            /// \param method The method, std::nullopt if not supported.
+            void set_request_data(std::optional<regular::HTTPMethod> method,
+                                  const std::string& url,
+                                  const std::string& version)
             {
                 request_method = method;
                 request_url = url;
@@ -113,7 +132,7 @@ namespace smooth::application::network::http
                 return request_url;
             }
 
-            const std::string& get_request_method() const
+            std::optional<regular::HTTPMethod> get_request_method() const
             {
                 return request_method;
             }
@@ -134,7 +153,7 @@ namespace smooth::application::network::http
                                                         + static_cast<decltype(content.size())>(additional_space)));
             }
 
-            std::unordered_map<std::string, std::string>& headers()
+            regular::HeaderMap& headers()
             {
                 return request_headers;
             }
@@ -167,11 +186,12 @@ namespace smooth::application::network::http
 
             void add_header(const std::string& key, const std::string& value);
 
-            std::unordered_map<std::string, std::string> request_headers{};
-            std::string request_method{};
+            regular::HeaderMap request_headers{};
+            std::optional<regular::HTTPMethod> request_method{};
             std::string request_url{};
             std::string request_version{};
             std::vector<uint8_t> content{};
+            std::shared_ptr<smooth::core::network::FileRegion> file{};
             regular::ResponseCode resp_code{};
             bool continuation = false;
             bool continued = false;
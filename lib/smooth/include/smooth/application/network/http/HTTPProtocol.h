@@ -69,6 +69,10 @@ namespace smooth::application::network::http
 
             void reset() override;
 
+            int read_buffered(uint8_t* target, int max_length) override;
+
+            bool has_buffered_data() const override;
+
             void upgrade_to_websocket() override;
 
         private:
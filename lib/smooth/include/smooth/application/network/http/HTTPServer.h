@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <functional>
 #include <set>
@@ -37,12 +38,15 @@ limitations under the License.
 #include "smooth/application/network/http/http_utils.h"
 #include "smooth/application/network/http/HTTPProtocol.h"
 #include "smooth/application/network/http/HTTPServerClient.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
 #include "smooth/application/network/http/regular/responses/ErrorResponse.h"
+#include "smooth/application/network/http/regular/responses/HeaderOnlyResponse.h"
 #include "smooth/application/network/http/regular/responses/FileContentResponse.h"
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
 #include "smooth/application/hash/sha.h"
 #include "regular/RequestHandlerSignature.h"
 #include "regular/HTTPRequestHandler.h"
+#include "regular/Router.h"
 #include "regular/WebSocketUpgradeDetector.h"
 #include "HTTPServerConfig.h"
 
@@ -57,19 +61,33 @@ namespace smooth::application::network::http
         public:
             HTTPServer(smooth::core::Task& task, const HTTPServerConfig& configuration);
 
-            void start(int max_client_count, int backlog, std::shared_ptr<smooth::core::network::InetAddress> bind_to)
+            /// Starts the server.
+            /// \param pool_size The number of clients, i.e. simultaneous connections. Use an elastic size to only
+            /// hold as many clients, with their buffers, as there are connections.
+            void start(smooth::core::network::ClientPoolSize pool_size,
+                       int backlog,
+                       std::shared_ptr<smooth::core::network::InetAddress> bind_to)
             {
                 server = ServerType::create(task,
-                                            max_client_count,
+                                            pool_size,
                                             backlog,
+                                            config.socket_options(),
                                             config.max_header_size(),
                                             config.chunk_size(),
-                                            config.max_responses());
+                                            config.max_responses(),
+                                            config.buffer_depth());
                 server->set_client_context(this);
                 server->start(std::move(bind_to));
             }
 
-            void start(int max_client_count,
+            /// Starts the server with a fixed number of clients.
+            /// \param max_client_count The number of clients, i.e. simultaneous connections.
+            void start(int max_client_count, int backlog, std::shared_ptr<smooth::core::network::InetAddress> bind_to)
+            {
+                start(smooth::core::network::ClientPoolSize{ max_client_count }, backlog, std::move(bind_to));
+            }
+
+            void start(smooth::core::network::ClientPoolSize pool_size,
                        int backlog,
                        std::shared_ptr<smooth::core::network::InetAddress> bind_to,
                        const std::vector<unsigned char>& ca_chain,
@@ -78,53 +96,102 @@ namespace smooth::application::network::http
                        const std::vector<unsigned char>& password)
             {
                 server = ServerType::create(task,
-                                            max_client_count,
+                                            pool_size,
                                             backlog,
+                                            config.socket_options(),
                                             ca_chain,
                                             own_cert,
                                             private_key,
                                             password,
                                             config.max_header_size(),
                                             config.chunk_size(),
-                                            config.max_responses());
+                                            config.max_responses(),
+                                            config.buffer_depth());
 
                 server->set_client_context(this);
                 server->start(std::move(bind_to));
             }
 
+            void start(int max_client_count,
+                       int backlog,
+                       std::shared_ptr<smooth::core::network::InetAddress> bind_to,
+                       const std::vector<unsigned char>& ca_chain,
+                       const std::vector<unsigned char>& own_cert,
+                       const std::vector<unsigned char>& private_key,
+                       const std::vector<unsigned char>& password)
+            {
+                start(smooth::core::network::ClientPoolSize{ max_client_count },
+                      backlog,
+                      std::move(bind_to),
+                      ca_chain,
+                      own_cert,
+                      private_key,
+                      password);
+            }
+
             /// Configure a request handler to handle a specific HTTP verb and path.
             /// Responders may be used for multiple URLS and/or methods, but must not be shared
             /// between different instances of an HTTP server since there is no guarantee in
             /// what order the data arrives to the handler. (If a handler is state-less, then this
             /// limitation does not apply.)
+            /// The path may contain parameters, e.g. '/api/device/:id', and end with a wildcard, e.g. '/api/*',
+            /// see regular::Router. Their values are available to the handler through path_parameters().
             void on(HTTPMethod method, const std::string& url,
                     const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler);
 
+            /// Configure a request handler to handle a path and everything beneath it, e.g. '/api' and '/api/...'.
+            /// The part of the URL following the prefix is available to the handler as path_parameters().get("*").
+            void mount(HTTPMethod method, const std::string& prefix,
+                       const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler);
+
             template<typename WServerType>
             void enable_websocket_on(const std::string& url);
 
+            /// The cache of files served from the web root, configured through HTTPServerConfig.
+            /// Use it to invalidate files changed by the application, e.g. after an upload, and to get statistics.
+            regular::StaticFileCache& get_file_cache()
+            {
+                return file_cache;
+            }
+
         private:
-            using HandlerByURL = std::unordered_map<std::string,
-                                                    std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>>;
+            using HandlerByURL = smooth::application::network::http::regular::Router<
+                std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>>;
             using HandlerByMethod = std::unordered_map<HTTPMethod, HandlerByURL>;
 
             void handle(HTTPMethod method,
                         IServerResponse& response,
                         IConnectionTimeoutModifier& timeout_modifier,
                         const std::string& requested_url,
-                        const std::unordered_map<std::string, std::string>& request_headers,
+                        const HeaderMap& request_headers,
                         const std::unordered_map<std::string, std::string>& request_parameters,
                         const std::vector<uint8_t>& data,
                         bool fist_part,
                         bool last_part) override;
 
-            smooth::core::filesystem::Path find_index(const smooth::core::filesystem::Path& search_path) const;
+            /// \return The first index file found in the directory, or nullptr.
+            std::shared_ptr<const regular::CachedFile> find_index(const smooth::core::filesystem::Path& search_path);
 
             void
             reply_with(IServerResponse& response, std::unique_ptr<IResponseOperation> res);
 
             void serve_file(const HTTPMethod& method, IServerResponse& response, const std::string& requested_url,
-                            const std::unordered_map<std::string, std::string>& request_headers);
+                            const HeaderMap& request_headers);
+
+            /// Replies with a file, processing it as a template if it is one.
+            /// A file accompanied by a precompressed version, e.g. 'app.js.gz' next to 'app.js', is never
+            /// processed as a template; the precompressed version is sent when the client accepts its encoding.
+            /// Precompressed versions older than the file are ignored. CI/precompress_web_root.sh creates them.
+            /// Range requests are honored for GET, unless an If-Range header holds another time than the
+            /// last modification of the file.
+            void reply_with_file(const HTTPMethod& method,
+                                 IServerResponse& response,
+                                 const std::shared_ptr<const regular::CachedFile>& file,
+                                 const HeaderMap& request_headers);
+
+            /// Gets the Cache-Control header for a file, from the max age rules of the configuration.
+            /// \return The header, or an empty string if no rule applies.
+            std::string get_cache_control(const smooth::core::filesystem::Path& path) const;
 
             smooth::core::Task& task;
             std::shared_ptr<smooth::core::network::ServerSocket<
@@ -132,9 +199,11 @@ namespace smooth::application::network::http
                                 smooth::application::network::http::HTTPProtocol, IRequestHandler>> server{};
 
             HandlerByMethod handlers{};
+            smooth::application::network::http::regular::RouteParameters path_parameters{};
             HTTPServerConfig config;
             const char* tag = "HTTPServer";
             TemplateProcessor template_processor;
+            regular::StaticFileCache file_cache;
     };
 
     template<typename ServerSocketType>
@@ -142,7 +211,8 @@ namespace smooth::application::network::http
             :
               task(task),
               config(configuration),
-              template_processor(configuration.templates(), config.data_retriever())
+              template_processor(configuration.templates(), config.data_retriever()),
+              file_cache(config.file_cache_config())
     {
     }
 
@@ -151,7 +221,26 @@ namespace smooth::application::network::http
                                     const std::string& url,
                                     const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler)
     {
-        handlers[method][url] = handler;
+        if (!handlers[method].add(url, handler))
+        {
+            Log::error(tag, "Invalid route: {}", url);
+        }
+    }
+
+    template<typename ServerType>
+    void HTTPServer<ServerType>::mount(HTTPMethod method,
+                                       const std::string& prefix,
+                                       const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler)
+    {
+        auto base = prefix;
+
+        while (!base.empty() && base.back() == '/')
+        {
+            base.pop_back();
+        }
+
+        on(method, base.empty() ? "/" : base, handler);
+        on(method, base + "/*", handler);
     }
 
     template<typename ServerType>
@@ -160,7 +249,7 @@ namespace smooth::application::network::http
         IServerResponse& response,
         IConnectionTimeoutModifier& timeout_modifier,
         const std::string& requested_url,
-        const std::unordered_map<std::string, std::string>& request_headers,
+        const HeaderMap& request_headers,
         const std::unordered_map<std::string, std::string>& request_parameters,
         const std::vector<uint8_t>& data,
         bool first_part,
@@ -174,22 +263,27 @@ namespace smooth::application::network::http
         if (by_url != handlers.end())
         {
             // Is there a specific handler for this URL?
-            auto response_handler = (*by_url).second.find(requested_url);
+            auto response_handler = (*by_url).second.find(requested_url, path_parameters);
 
-            if (response_handler == (*by_url).second.end())
+            if (response_handler == nullptr)
             {
                 // No handler for this URL, does it match a file path beneath the web root?
                 serve_file(method, response, requested_url, request_headers);
             }
             else
             {
-                auto handler = (*response_handler).second;
+                const auto& handler = *response_handler;
 
                 // Call order is important - must update call params before calling the rest of the methods in the
                 // inheriting class.
                 if (first_part || last_part)
                 {
-                    handler->update_call_params(first_part, last_part, response, request_headers, request_parameters);
+                    handler->update_call_params(first_part,
+                                                last_part,
+                                                response,
+                                                request_headers,
+                                                request_parameters,
+                                                path_parameters);
                 }
 
                 if (first_part)
@@ -217,7 +311,7 @@ namespace smooth::application::network::http
     void HTTPServer<ServerType>::serve_file(const HTTPMethod& method,
                                             IServerResponse& response,
                                             const std::string& requested_url,
-                                            const std::unordered_map<std::string, std::string>& request_headers)
+                                            const HeaderMap& request_headers)
     {
         auto found = false;
 
@@ -228,91 +322,189 @@ namespace smooth::application::network::http
 
         if (config.web_root().is_parent_of(search) || config.web_root() == search)
         {
-            filesystem::FileInfo info(search);
+            auto file = file_cache.get(search);
 
-            if (info.is_regular_file())
+            if (file->regular_file)
             {
-                // Attempt to process the file as a template.
-                auto processed_template = template_processor.process_template(info.path());
+                reply_with_file(method, response, file, request_headers);
+                found = true;
+            }
+            else if (file->directory)
+            {
+                auto index = find_index(search);
 
-                if (processed_template)
+                if (index)
                 {
-                    reply_with(response, std::move(processed_template));
+                    reply_with_file(method, response, index, request_headers);
+                    found = true;
                 }
-                else
+            }
+        }
+
+        if (!found)
+        {
+            reply_with(response, std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Found));
+        }
+    }
+
+    template<typename ServerType>
+    void HTTPServer<ServerType>::reply_with_file(const HTTPMethod& method,
+                                                 IServerResponse& response,
+                                                 const std::shared_ptr<const regular::CachedFile>& file,
+                                                 const HeaderMap& request_headers)
+    {
+        // In order of preference, the smallest first.
+        static const std::array<std::pair<const char*, const char*>, 2> precompressed{ { { ".br", "br" },
+                                                                                         { ".gz", "gzip" } } };
+
+        auto accept_encoding = request_headers.get(ACCEPT_ENCODING);
+        std::shared_ptr<const regular::CachedFile> encoded{};
+        const char* encoding = "";
+        bool has_precompressed = false;
+
+        for (auto it = precompressed.begin(); !encoded && it != precompressed.end(); ++it)
+        {
+            auto candidate = file_cache.get(filesystem::Path{ (file->path.str() + it->first).c_str() });
+
+            // A precompressed version older than the file is stale, e.g. the file has been edited
+            // without the precompressed versions being regenerated, and is ignored.
+            if (candidate->regular_file && candidate->last_modified >= file->last_modified)
+            {
+                has_precompressed = true;
+
+                if (utils::accepts_encoding(accept_encoding, it->second))
                 {
-                    // Not a template, simply serve the requested file
-                    bool send_not_modified = false;
-                    auto if_modified_since = request_headers.find("if-modified-since");
-
-                    if (if_modified_since != request_headers.end())
-                    {
-                        auto since = utils::parse_http_time((*if_modified_since).second);
-
-                        if (since >= info.last_modified_point())
-                        {
-                            send_not_modified = true;
-                        }
-                    }
-
-                    if (send_not_modified)
-                    {
-                        reply_with(response,
-                                   std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Modified));
-                    }
-                    else
-                    {
-                        reply_with(response, std::make_unique<responses::FileContentResponse>(search));
-                    }
+                    encoded = std::move(candidate);
+                    encoding = it->second;
                 }
+            }
+        }
 
-                found = true;
+        // Attempt to process the file as a template.
+        auto processed_template = has_precompressed ? nullptr : template_processor.process_template(file);
+
+        if (processed_template)
+        {
+            reply_with(response, std::move(processed_template));
+        }
+        else
+        {
+            const auto& to_send = encoded ? encoded : file;
+            bool send_not_modified = false;
+            auto if_none_match = request_headers.get(IF_NONE_MATCH);
+
+            // If-None-Match takes precedence, https://tools.ietf.org/html/rfc7232#section-6
+            if (!if_none_match.empty())
+            {
+                send_not_modified = utils::etag_matches(if_none_match, to_send->etag, true);
             }
-            else if (info.is_directory())
+            else
             {
-                auto index_path = find_index(search);
+                auto if_modified_since = request_headers.get(IF_MODIFIED_SINCE);
+                send_not_modified = !if_modified_since.empty()
+                                    && utils::parse_http_time(if_modified_since) >= to_send->last_modified_point();
+            }
 
-                if (!index_path.empty())
-                {
-                    auto processed_template = template_processor.process_template(index_path);
+            std::unique_ptr<IResponseOperation> res{};
+
+            if (send_not_modified)
+            {
+                // Without a body, but with the headers a 200 response would have had for caches to update.
+                res = std::make_unique<responses::HeaderOnlyResponse>(ResponseCode::Not_Modified);
+                res->set_header(LAST_MODIFIED, utils::make_http_time(to_send->last_modified));
+                res->set_header(ETAG, to_send->etag);
+            }
+            else
+            {
+                std::vector<utils::ByteRange> ranges{};
+                bool satisfiable = true;
+                auto range = request_headers.get(RANGE);
 
-                    if (processed_template)
-                    {
-                        reply_with(response, std::move(processed_template));
-                    }
-                    else
-                    {
-                        reply_with(response, std::make_unique<responses::FileContentResponse>(index_path));
-                    }
+                if (method == HTTPMethod::GET && !range.empty())
+                {
+                    // If-Range holds either an entity tag or a date, which must match the file exactly.
+                    auto if_range = request_headers.get(IF_RANGE);
+                    bool unchanged = if_range.empty()
+                                     || utils::etag_matches(if_range, to_send->etag, false)
+                                     || utils::parse_http_time(if_range) == to_send->last_modified_point();
+
+                    // Malformed ranges are ignored and the entire file sent.
+                    satisfiable = !unchanged || !utils::parse_byte_ranges(range, to_send->size, ranges)
+                                  || !ranges.empty();
+                }
 
-                    found = true;
+                if (satisfiable)
+                {
+                    res = std::make_unique<responses::FileContentResponse>(file_cache.get(to_send->path, true),
+                                                                           file->content_type,
+                                                                           encoding,
+                                                                           ranges);
                 }
+                else
+                {
+                    res = std::make_unique<responses::ErrorResponse>(ResponseCode::Requested_Range_Not_Satisfiable);
+                    res->set_header(CONTENT_RANGE, "bytes */" + std::to_string(to_send->size));
+                }
+            }
+
+            auto cache_control = get_cache_control(file->path);
+
+            if (!cache_control.empty())
+            {
+                res->set_header(CACHE_CONTROL, cache_control);
+            }
+
+            if (has_precompressed)
+            {
+                // Caches must not hand out one version of the file to clients that asked for another.
+                res->set_header(VARY, "Accept-Encoding");
             }
+
+            reply_with(response, std::move(res));
         }
+    }
 
-        if (!found)
+    template<typename ServerType>
+    std::string HTTPServer<ServerType>::get_cache_control(const smooth::core::filesystem::Path& path) const
+    {
+        std::string res{};
+        const auto& rules = config.max_age_rules();
+
+        if (!rules.empty())
         {
-            reply_with(response, std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Found));
+            auto rule = rules.find(smooth::core::string_util::to_lower_copy(path.extension()));
+
+            if (rule == rules.end())
+            {
+                rule = rules.find("*");
+            }
+
+            if (rule != rules.end())
+            {
+                res = rule->second.count() > 0 ? "max-age=" + std::to_string(rule->second.count()) : "no-cache";
+            }
         }
+
+        return res;
     }
 
     template<typename ServerType>
-    smooth::core::filesystem::Path HTTPServer<ServerType>::find_index(
-        const smooth::core::filesystem::Path& search_path) const
+    std::shared_ptr<const regular::CachedFile> HTTPServer<ServerType>::find_index(
+        const smooth::core::filesystem::Path& search_path)
     {
-        smooth::core::filesystem::Path found_index{};
+        std::shared_ptr<const regular::CachedFile> found_index{};
 
-        for (auto index = config.indexes().begin(); found_index.empty() && index != config.indexes().end(); ++index)
+        for (auto index = config.indexes().begin(); !found_index && index != config.indexes().end(); ++index)
         {
             auto index_path = search_path / *index;
 
             if (config.web_root().is_parent_of(index_path))
             {
-                core::filesystem::FileInfo index_info(search_path / *index);
+                auto index_file = file_cache.get(index_path);
 
-                if (index_info.is_regular_file())
+                if (index_file->regular_file)
                 {
-                    found_index = search_path / *index;
+                    found_index = std::move(index_file);
                 }
             }
         }
@@ -49,7 +49,8 @@ namespace smooth::application::network::http
                              smooth::core::network::ClientPool<HTTPServerClient>& pool,
                              std::size_t max_header_size,
                              std::size_t content_chunk_size,
-                             std::size_t max_enqueued_responses)
+                             std::size_t max_enqueued_responses,
+                             smooth::core::network::BufferDepth depth)
                     : core::network::ServerClient<HTTPServerClient,
                                                   smooth::application::network::http::HTTPProtocol, IRequestHandler>(
                           task,
@@ -57,7 +58,8 @@ namespace smooth::application::network::http
                           std::make_unique<smooth::application::network::http::HTTPProtocol>(
                                                                                        max_header_size,
                                                                                        content_chunk_size,
-                                                                                       *this)),
+                                                                                       *this),
+                          depth),
                       content_chunk_size(content_chunk_size),
                       task(task),
                       max_enqueued_responses(max_enqueued_responses)
@@ -103,6 +105,7 @@ namespace smooth::application::network::http
             {
                 // Don't clear TX buffer - the upgrade response is being sent.
                 container->get_rx_buffer().clear();
+                deferred_requests = 0;
                 container->get_protocol().upgrade_to_websocket();
                 mode = Mode::Websocket;
             }
@@ -122,18 +125,24 @@ namespace smooth::application::network::http
 
             void send_first_part();
 
-            bool translate_method(const HTTPPacket& packet, HTTPMethod& method) const;
+            void handle_request(HTTPPacket& packet);
+
+            /// Handles requests left in the receive buffer while responses to earlier requests were waiting.
+            void handle_deferred_requests();
 
             const std::size_t content_chunk_size;
             smooth::core::Task& task;
             std::unordered_map<std::string, std::string> request_parameters{};
-            std::unordered_map<std::string, std::string> request_headers{};
+            regular::HeaderMap request_headers{};
             std::string requested_url{};
             URLEncoding encoding{};
             std::deque<std::unique_ptr<IResponseOperation>> operations{};
             std::unique_ptr<IResponseOperation> current_operation{};
             const std::size_t max_enqueued_responses;
 
+            /// The number of received requests, or parts thereof, not yet handled, see http_event().
+            std::size_t deferred_requests{ 0 };
+
             void set_keep_alive();
     };
 }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include "smooth/core/network/BufferDepth.h"
+#include "smooth/core/network/SocketOptions.h"
+#include "smooth/application/network/http/regular/StaticFileCache.h"
 
 namespace smooth::application::network::http
 {
@@ -33,20 +38,37 @@ namespace smooth::application::network::http
             /// data). To prevent an out-of-memory situation when there is a steady stream of incoming data, and the
             /// device can't send out the responses fast enough, this threshold protects the device by closing the
             /// connection if it is reached.
+            /// \arg depth The number of packets the receive and transmit buffers of each client may hold. Use an adaptive
+            /// depth to let connections grow their buffers during bursts while keeping idle connections small.
+            /// \arg options Tuning options for the server socket and the client connections, e.g. kernel buffer sizes,
+            /// keepalive and write coalescing.
+            /// \arg file_cache Configuration of the cache of files served from the web root, disabled by default.
+            /// \arg max_age How long clients may use files from the web root without revalidating them, sent as
+            /// Cache-Control, per file extension, e.g. { ".js", std::chrono::hours{ 24 } }. The rule for "*" applies
+            /// to extensions not listed. A max age of zero makes clients revalidate the file on every use, and files
+            /// without a rule are sent without Cache-Control.
             HTTPServerConfig(smooth::core::filesystem::Path web_root,
                              std::vector<std::string> index_files,
                              std::set<std::string> template_files,
                              std::shared_ptr<ITemplateDataRetriever> template_data_retriever,
                              std::size_t max_header_size,
                              std::size_t content_chunk_size,
-                             std::size_t max_enqueued_responses)
+                             std::size_t max_enqueued_responses,
+                             smooth::core::network::BufferDepth depth = smooth::core::network::BufferDepth{},
+                             smooth::core::network::SocketOptions options = smooth::core::network::SocketOptions{},
+                             regular::FileCacheConfig file_cache = regular::FileCacheConfig{},
+                             std::unordered_map<std::string, std::chrono::seconds> max_age = {})
                     : root_path(std::move(web_root)),
                       index(std::move(index_files)),
                       template_files(std::move(template_files)),
                       template_data_retriever(std::move(template_data_retriever)),
                       maximum_header_size(max_header_size),
                       content_chunk_size(content_chunk_size),
-                      max_enqueued_responses(max_enqueued_responses)
+                      max_enqueued_responses(max_enqueued_responses),
+                      depth(depth),
+                      options(options),
+                      file_cache(file_cache),
+                      max_age(std::move(max_age))
             {
             }
 
@@ -85,6 +107,26 @@ namespace smooth::application::network::http
                 return max_enqueued_responses;
             }
 
+            [[nodiscard]] smooth::core::network::BufferDepth buffer_depth() const
+            {
+                return depth;
+            }
+
+            [[nodiscard]] const smooth::core::network::SocketOptions& socket_options() const
+            {
+                return options;
+            }
+
+            [[nodiscard]] const regular::FileCacheConfig& file_cache_config() const
+            {
+                return file_cache;
+            }
+
+            [[nodiscard]] const std::unordered_map<std::string, std::chrono::seconds>& max_age_rules() const
+            {
+                return max_age;
+            }
+
         private:
             smooth::core::filesystem::Path root_path{};
             std::vector<std::string> index{};
@@ -93,5 +135,9 @@ namespace smooth::application::network::http
             std::size_t maximum_header_size{};
             std::size_t content_chunk_size{};
             std::size_t max_enqueued_responses{};
+            smooth::core::network::BufferDepth depth{};
+            smooth::core::network::SocketOptions options{};
+            regular::FileCacheConfig file_cache{};
+            std::unordered_map<std::string, std::chrono::seconds> max_age{};
     };
 }
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <unordered_map>
 #include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/FileRegion.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
 
 namespace smooth::application::network::http
@@ -51,6 +52,21 @@ namespace smooth::application::network::http
             // Called at least once when sending a response and until ResponseStatus::AllSent is returned
             virtual ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) = 0;
 
+            /// Called instead of the first call to get_data() when the connection is able to send directly from
+            /// files. If a file region is returned, all of it is sent right after the headers and get_data() must
+            /// return ResponseStatus::NoData thereafter.
+            /// \return The file region to send, or nullptr to send the response via get_data().
+            virtual std::shared_ptr<smooth::core::network::FileRegion> get_file_region()
+            {
+                return nullptr;
+            }
+
+            /// Called after data returned by get_data() has been queued for sending, while more remains.
+            /// Lets the operation prepare the next part, e.g. read it from a file, while the current part is sent.
+            /// \param max_amount The maximum amount of data the next call to get_data() will ask for.
+            virtual void prepare_next(std::size_t /*max_amount*/)
+            {}
+
             /// Sets a header, replacing any existing value
             virtual void set_header(const std::string& /*key*/, const std::string& /*value*/)
             {}
@@ -0,0 +1,84 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smooth::application::network::http
+{
+    /// The body of a response, handed out in chunks by moving an offset over storage that never changes, so
+    /// sending a chunk neither copies nor moves the data that remains. Copies share the storage, each with its
+    /// own offset, so the same body can be sent to many clients without being copied.
+    class ResponseBody
+    {
+        public:
+            /// An empty body.
+            ResponseBody() = default;
+
+            /// Takes over a string.
+            explicit ResponseBody(std::string text);
+
+            /// Takes over a vector.
+            explicit ResponseBody(std::vector<uint8_t> data);
+
+            /// Shares a string with its other owners.
+            explicit ResponseBody(std::shared_ptr<const std::string> text);
+
+            /// Shares a vector with its other owners.
+            explicit ResponseBody(std::shared_ptr<const std::vector<uint8_t>> data);
+
+            /// Refers to data that is never freed, e.g. a string literal, without copying it.
+            static ResponseBody from_static(std::string_view data);
+
+            /// The total size, in bytes.
+            [[nodiscard]] std::size_t size() const
+            {
+                return length;
+            }
+
+            /// The number of bytes not yet taken.
+            [[nodiscard]] std::size_t remaining() const
+            {
+                return length - offset;
+            }
+
+            /// Appends the bytes following those already taken.
+            /// \param max_amount The maximum number of bytes to append.
+            /// \param target The container to append to.
+            /// \return The number of bytes appended.
+            std::size_t take(std::size_t max_amount, std::vector<uint8_t>& target);
+
+            /// Starts over from the first byte.
+            void rewind()
+            {
+                offset = 0;
+            }
+
+        private:
+            ResponseBody(std::shared_ptr<const void> owner, const void* data, std::size_t length);
+
+            std::shared_ptr<const void> owner{};
+            const uint8_t* data{ nullptr };
+            std::size_t length{ 0 };
+            std::size_t offset{ 0 };
+    };
+}
@@ -18,21 +18,74 @@ limitations under the License.
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <chrono>
+#include <ctime>
+#include <vector>
 #include "smooth/core/filesystem/Path.h"
 #include "regular/HTTPMethod.h"
 
 namespace smooth::application::network::http::utils
 {
+    /// A range of bytes in a representation, as requested by a Range header.
+    struct ByteRange
+    {
+        /// Position of the first byte.
+        std::size_t first;
+
+        /// Position of the last byte, inclusive.
+        std::size_t last;
+
+        [[nodiscard]] std::size_t length() const
+        {
+            return last - first + 1;
+        }
+    };
+
     std::string make_http_time(const std::chrono::system_clock::time_point& t);
 
     std::string make_http_time(const time_t& t);
 
-    std::chrono::system_clock::time_point parse_http_time(const std::string& t);
+    /// Parses a date in the preferred format of HTTP, e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+    /// \return The time, or std::chrono::system_clock::time_point::min() if malformed.
+    std::chrono::system_clock::time_point parse_http_time(std::string_view t);
 
     std::string get_content_type(const smooth::core::filesystem::Path& path);
 
+    /// Converts a broken down UTC time to seconds since the epoch, the inverse of gmtime().
+    /// Unlike mktime(), it doesn't depend on the time zone of the environment.
     time_t timegm(tm& tm);
 
     std::string http_method_to_string(regular::HTTPMethod m);
+
+    /// Translates the method of a request line.
+    /// \param s The method, case sensitive as per https://tools.ietf.org/html/rfc7230#section-3.1.1
+    /// \param method Assigned the method.
+    /// \return false if the method is not supported.
+    bool string_to_http_method(std::string_view s, regular::HTTPMethod& method);
+
+    /// Checks if a content-coding is acceptable to the client.
+    /// \param accept_encoding The value of the Accept-Encoding header of the request.
+    /// \param coding The content-coding, e.g. "gzip".
+    /// \return true if the coding, or '*', is listed with a quality other than zero.
+    bool accepts_encoding(std::string_view accept_encoding, std::string_view coding);
+
+    /// Parses the byte ranges of a Range header, as per https://tools.ietf.org/html/rfc7233#section-2.1
+    /// Ranges that overlap or are adjacent are merged, so the result is sorted and never covers a byte twice.
+    /// \param range The value of the Range header, e.g. "bytes=0-99, -100".
+    /// \param size The size of the representation the ranges refer to.
+    /// \param ranges Assigned the satisfiable ranges, limited to the size. Empty if none is satisfiable.
+    /// \return false if the header is malformed, uses another unit than bytes or has more than max_byte_ranges
+    /// ranges, in which case it is to be ignored.
+    bool parse_byte_ranges(std::string_view range, std::size_t size, std::vector<ByteRange>& ranges);
+
+    /// The maximum number of ranges accepted in a Range header, to bound the overhead of multipart responses.
+    constexpr std::size_t max_byte_ranges = 16;
+
+    /// Checks if an entity tag is in a list of entity tags, as per https://tools.ietf.org/html/rfc7232#section-2.3.2
+    /// \param etags The list, e.g. the value of an If-None-Match header. "*" matches any entity tag.
+    /// \param etag The entity tag to look for, including quotes, e.g. "\"1a2b-5e0c3a01\"".
+    /// \param weak Use weak comparison, which ignores the weakness indicator "W/", rather than strong comparison,
+    /// where weak entity tags never match.
+    bool etag_matches(std::string_view etags, std::string_view etag, bool weak);
 }
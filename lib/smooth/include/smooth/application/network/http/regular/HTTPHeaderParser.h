@@ -0,0 +1,84 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <optional>
+#include <string_view>
+#include "HeaderMap.h"
+#include "HTTPMethod.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// Parses the start line and headers of a HTTP message in a single pass over the receive buffer,
+    /// without copying anything but the header names and values, which are added to a HeaderMap.
+    /// The start line is kept as views into the parsed data.
+    class HTTPHeaderParser
+    {
+        public:
+            /// Parses a header block.
+            /// \param block The start line and the headers, each line ending with CRLF, not including
+            /// the empty line ending the headers.
+            /// \param headers Receives the headers.
+            /// \return false if the start line is neither a request line nor a status line.
+            bool parse(std::string_view block, HeaderMap& headers);
+
+            /// Returns true if the start line was a request line, false if it was a status line.
+            [[nodiscard]] bool is_request() const
+            {
+                return request;
+            }
+
+            /// Returns the method of a request, or std::nullopt if the method is not supported.
+            [[nodiscard]] std::optional<HTTPMethod> method() const
+            {
+                return request_method;
+            }
+
+            [[nodiscard]] std::string_view url() const
+            {
+                return request_url;
+            }
+
+            /// Returns the HTTP version, e.g. "1.1".
+            [[nodiscard]] std::string_view version() const
+            {
+                return http_version;
+            }
+
+            /// Returns the status code of a response.
+            [[nodiscard]] int status() const
+            {
+                return status_code;
+            }
+
+        private:
+            bool parse_request_line(std::string_view line);
+
+            bool parse_status_line(std::string_view line);
+
+            static void parse_header(std::string_view line, HeaderMap& headers);
+
+            static bool parse_version(std::string_view s, std::string_view& version);
+
+            bool request = false;
+            std::optional<HTTPMethod> request_method{};
+            std::string_view request_url{};
+            std::string_view http_version{};
+            int status_code = 0;
+    };
+}
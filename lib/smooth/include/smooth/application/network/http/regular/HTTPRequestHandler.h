@@ -23,6 +23,8 @@ limitations under the License.
 #include "smooth/application/network/http/IServerResponse.h"
 #include "smooth/application/network/http/IConnectionTimeoutModifier.h"
 #include "smooth/application/network/http/regular/MIMEParser.h"
+#include "smooth/application/network/http/regular/HeaderMap.h"
+#include "smooth/application/network/http/regular/RouteParameters.h"
 
 namespace smooth::application::network::http::regular
 {
@@ -63,8 +65,9 @@ namespace smooth::application::network::http::regular
             void update_call_params(bool first_part,
                                     bool last_part,
                                     IServerResponse& /*response*/,
-                                    const std::unordered_map<std::string, std::string>& headers,
-                                    const std::unordered_map<std::string, std::string>& request_parameters);
+                                    const HeaderMap& headers,
+                                    const std::unordered_map<std::string, std::string>& request_parameters,
+                                    const RouteParameters& path_parameters);
 
         protected:
             MIMEParser mime{};
@@ -79,7 +82,7 @@ namespace smooth::application::network::http::regular
             IServerResponse& response() const { return *request_params.response; }
 
             /// Returns the headers for the current request
-            const std::unordered_map<std::string, std::string>& headers() const { return *request_params.headers; }
+            const HeaderMap& headers() const { return *request_params.headers; }
 
             /// Returns the request parameters (page?a=1&b=2 etc.) for the currect request
             const std::unordered_map<std::string, std::string>& request_parameters() const
@@ -87,6 +90,10 @@ namespace smooth::application::network::http::regular
                 return *request_params.request_parameters;
             }
 
+            /// Returns the parameters extracted from the URL by the route of the handler,
+            /// e.g. 'id' for '/device/:id'. The values are views into the URL, valid during the call to request().
+            const RouteParameters& path_parameters() const { return *request_params.path_parameters; }
+
         private:
             /// This structure holds parameters for the current request,
             /// to be accessed via above methods.
@@ -95,8 +102,9 @@ namespace smooth::application::network::http::regular
                 bool first_part;
                 bool last_part;
                 IServerResponse* response{};
-                const std::unordered_map<std::string, std::string>* headers{ nullptr };
+                const HeaderMap* headers{ nullptr };
                 const std::unordered_map<std::string, std::string>* request_parameters{ nullptr };
+                const RouteParameters* path_parameters{ nullptr };
             };
 
             RequestParams request_params{};
@@ -0,0 +1,158 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// The headers of a request, kept in a single buffer with a flat index on top of it, instead of a
+    /// node and two strings per header. The buffer is kept between requests, so once it has grown to fit
+    /// the headers of a typical request, adding headers does not allocate.
+    /// Headers are case-insensitive (https://tools.ietf.org/html/rfc7230#section-3.2), names are kept as received
+    /// and compared ignoring case. Requests have few headers so a linear search is faster than hashing.
+    /// Returned views are valid until the map is modified.
+    class HeaderMap
+    {
+        public:
+            using value_type = std::pair<std::string_view, std::string_view>;
+
+            /// Adds a header. If it already exists, the value is appended to the existing one, separated by ', '
+            /// as allowed by https://tools.ietf.org/html/rfc7230#section-3.2.2
+            void add(std::string_view name, std::string_view value)
+            {
+                auto index = index_of(name);
+
+                if (index < entries.size())
+                {
+                    auto& e = entries[index];
+                    auto old_value = e.value;
+                    auto old_length = e.value_length;
+
+                    // Reserve first so that the old value stays where it is while being copied.
+                    data.reserve(data.size() + old_length + 2 + value.size());
+                    e.value = data.size();
+                    e.value_length = old_length + 2 + value.size();
+                    data.append(data.data() + old_value, old_length).append(", ").append(value);
+                }
+                else
+                {
+                    Entry e{ data.size(), name.size(), data.size() + name.size(), value.size() };
+                    data.append(name).append(value);
+                    entries.emplace_back(e);
+                }
+            }
+
+            /// Gets the value of a header.
+            /// \param name The name of the header, in any case.
+            /// \return The value, or an empty view if there is no such header.
+            [[nodiscard]] std::string_view get(std::string_view name) const
+            {
+                auto index = index_of(name);
+
+                return index < entries.size() ? value_at(index) : std::string_view{};
+            }
+
+            [[nodiscard]] bool contains(std::string_view name) const
+            {
+                return index_of(name) < entries.size();
+            }
+
+            /// Gets a header by position, in the order they were added.
+            /// \param index Must be less than size().
+            [[nodiscard]] value_type operator[](std::size_t index) const
+            {
+                const auto& e = entries[index];
+
+                return { std::string_view{ data.data() + e.name, e.name_length }, value_at(index) };
+            }
+
+            [[nodiscard]] bool empty() const
+            {
+                return entries.empty();
+            }
+
+            [[nodiscard]] std::size_t size() const
+            {
+                return entries.size();
+            }
+
+            /// Removes all headers, keeping the memory for the next request.
+            void clear()
+            {
+                data.clear();
+                entries.clear();
+            }
+
+        private:
+            /// Positions in data rather than views, so that they survive data growing and the map being moved.
+            struct Entry
+            {
+                std::size_t name;
+                std::size_t name_length;
+                std::size_t value;
+                std::size_t value_length;
+            };
+
+            [[nodiscard]] std::string_view value_at(std::size_t index) const
+            {
+                const auto& e = entries[index];
+
+                return std::string_view{ data.data() + e.value, e.value_length };
+            }
+
+            /// \return The index of the header, or size() if not found.
+            [[nodiscard]] std::size_t index_of(std::string_view name) const
+            {
+                std::size_t i = 0;
+
+                while (i < entries.size()
+                       && !iequals(std::string_view{ data.data() + entries[i].name, entries[i].name_length }, name))
+                {
+                    ++i;
+                }
+
+                return i;
+            }
+
+            static bool iequals(std::string_view a, std::string_view b)
+            {
+                bool res = a.size() == b.size();
+
+                for (std::size_t i = 0; res && i < a.size(); ++i)
+                {
+                    res = to_lower(a[i]) == to_lower(b[i]);
+                }
+
+                return res;
+            }
+
+            /// ASCII only, header names are tokens and std::tolower() depends on the locale.
+            static char to_lower(char c)
+            {
+                return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+            }
+
+            std::string data{};
+            std::vector<Entry> entries{};
+    };
+}
@@ -36,7 +36,7 @@ namespace smooth::application::network::http::regular
                                 IServerResponse& response,
                                 IConnectionTimeoutModifier& timeout_modifier,
                                 const std::string& requested_url,
-                                const std::unordered_map<std::string, std::string>& request_headers,
+                                const HeaderMap& request_headers,
                                 const std::unordered_map<std::string, std::string>& request_parameters,
                                 const std::vector<uint8_t>& data,
                                 bool fist_part,
@@ -17,7 +17,8 @@ limitations under the License.
 
 #pragma once
 
-#include <regex>
+#include <optional>
+#include <string_view>
 #include "smooth/core/network/IPacketAssembly.h"
 #include "smooth/application/network/http/HTTPPacket.h"
 #include "smooth/application/network/http/IServerResponse.h"
@@ -56,15 +57,50 @@ namespace smooth::application::network::http::regular
 
             void reset() override;
 
+            int read_buffered(uint8_t* target, int max_length) override;
+
+            bool has_buffered_data() const override;
+
         private:
             int consume_headers(HTTPPacket& packet, std::vector<uint8_t>::const_iterator header_ending);
 
+            /// Keeps data received beyond the end of the current request for the next one.
+            void keep_surplus(const uint8_t* begin, const uint8_t* end);
+
+            /// Decodes content sent with chunked transfer-encoding that has been written to the packet.
+            void chunked_data_received(HTTPPacket& packet, int length);
+
+            /// Decodes content sent with chunked transfer-encoding in place, removing the framing so that only
+            /// the content remains at the start of the data.
+            /// \param data The received data
+            /// \param length The number of bytes received
+            /// \param consumed Assigned the number of bytes that belong to the current request.
+            /// Once the last chunk has been decoded the remaining bytes belong to the next request.
+            /// \return The number of content bytes, or -1 if the framing is malformed.
+            int decode_chunked(uint8_t* data, int length, int& consumed);
+
+            /// Handles a complete line of chunk framing, i.e. a chunk size, the end of a chunk or a trailer.
+            bool chunk_line_received();
+
+            [[nodiscard]] bool all_content_received() const;
+
+            static bool is_chunked(std::string_view transfer_encoding);
+
             enum class State
             {
                 reading_headers,
                 reading_content
             };
 
+            enum class ChunkState
+            {
+                size,
+                data,
+                data_end,
+                trailer,
+                done
+            };
+
             const int max_header_size;
             const int content_chunk_size;
             IServerResponse& response;
@@ -75,15 +111,22 @@ namespace smooth::application::network::http::regular
             int incoming_content_length{ 0 };
             int actual_header_size{ 0 };
 
-            const std::regex response_line{ R"!(HTTP\/(\d.\d)\ (\d+)\ (.+))!" }; // HTTP/1.1 200 OK
-            const std::regex request_line{ R"!((.+)\ (.+)\ HTTP\/(\d\.\d))!" }; // "GET / HTTP/1.1"
+            bool chunked = false;
+            ChunkState chunk_state = ChunkState::size;
+            std::size_t chunk_remaining{ 0 };
+            std::string chunk_line{};
 
             bool error = false;
             State state = State::reading_headers;
-            std::string last_method{};
+            std::optional<HTTPMethod> last_method{};
             std::string last_url{};
 
             std::string last_request_version{};
+
+            /// Pipelined requests, i.e. data received after the end of the current request, and how much
+            /// of it has been handed to the next request so far.
+            std::vector<uint8_t> surplus{};
+            std::size_t surplus_read{ 0 };
             IUpgradeToWebsocket& websocket_upgrade;
     };
 }
@@ -21,6 +21,7 @@ limitations under the License.
 #include "smooth/application/network/http/IResponseOperation.h"
 #include "smooth/application/network/http/IConnectionTimeoutModifier.h"
 #include "smooth/application/network/http/IServerResponse.h"
+#include "HeaderMap.h"
 
 namespace smooth::application::network::http::regular
 {
@@ -32,7 +33,7 @@ namespace smooth::application::network::http::regular
                                                       const std::string& url,
                                                       bool first_part,
                                                       bool last_part,
-                                                      const std::unordered_map<std::string, std::string>& headers,
+                                                      const HeaderMap& headers,
                                                       const std::unordered_map<std::string,
                                                                                std::string>& request_parameters,
                                                       const std::vector<uint8_t>& content,
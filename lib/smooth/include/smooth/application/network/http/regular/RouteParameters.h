@@ -0,0 +1,105 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// The parameters extracted from a URL by a Router, e.g. 'id' = '42' for the route '/api/device/:id'
+    /// and the URL '/api/device/42'. Names and values are views into the route and the URL respectively,
+    /// so they are only valid as long as both are, i.e. for the duration of the request.
+    class RouteParameters
+    {
+        public:
+            using value_type = std::pair<std::string_view, std::string_view>;
+            using const_iterator = std::vector<value_type>::const_iterator;
+
+            /// Gets the value of a parameter.
+            /// \param name The name of the parameter, without ':' or '*'.
+            /// \return The value, or an empty view if there is no such parameter.
+            [[nodiscard]] std::string_view get(std::string_view name) const
+            {
+                std::string_view res{};
+
+                for (const auto& p : values)
+                {
+                    if (p.first == name)
+                    {
+                        res = p.second;
+                        break;
+                    }
+                }
+
+                return res;
+            }
+
+            [[nodiscard]] bool contains(std::string_view name) const
+            {
+                bool found = false;
+
+                for (auto it = values.begin(); !found && it != values.end(); ++it)
+                {
+                    found = it->first == name;
+                }
+
+                return found;
+            }
+
+            [[nodiscard]] bool empty() const
+            {
+                return values.empty();
+            }
+
+            [[nodiscard]] std::size_t size() const
+            {
+                return values.size();
+            }
+
+            [[nodiscard]] const_iterator begin() const
+            {
+                return values.begin();
+            }
+
+            [[nodiscard]] const_iterator end() const
+            {
+                return values.end();
+            }
+
+            /// Removes all parameters, keeping the memory for the next request.
+            void clear()
+            {
+                values.clear();
+            }
+
+            void push(std::string_view name, std::string_view value)
+            {
+                values.emplace_back(name, value);
+            }
+
+            void pop()
+            {
+                values.pop_back();
+            }
+
+        private:
+            std::vector<value_type> values{};
+    };
+}
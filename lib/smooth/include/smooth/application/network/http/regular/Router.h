@@ -0,0 +1,314 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "RouteParameters.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// Maps URLs to handlers using a radix tree, i.e. a trie where chains of single children are merged
+    /// into one node, so a lookup only compares each character of the URL once and never allocates.
+    /// Routes consist of segments separated by '/', which may be:
+    /// * Static text, e.g. '/api/device', matched exactly.
+    /// * A parameter, e.g. ':id', matching a single non-empty segment.
+    /// * A wildcard, '*' or '*name', as the last segment, matching the remainder of the URL, which may be empty.
+    /// When several routes match a URL, static text is preferred over parameters, and parameters over wildcards.
+    /// Routes of only static text are also kept in a hash map, making their lookup as cheap as an exact match,
+    /// and the tree is only searched when that fails and there are routes with parameters or wildcards.
+    /// Not thread-safe.
+    /// \tparam Handler The type of handler to route to, must be copyable.
+    template<typename Handler>
+    class Router
+    {
+        public:
+            Router() = default;
+
+            Router(const Router&) = delete;
+
+            Router& operator=(const Router&) = delete;
+
+            Router(Router&&) noexcept = default;
+
+            Router& operator=(Router&&) noexcept = default;
+
+            /// Adds a route, replacing any handler already added for the same route.
+            /// \param route The route, see class description.
+            /// \param handler The handler of URLs matching the route.
+            /// \return false if the route is malformed, i.e. a parameter without name or a wildcard that isn't
+            /// the last segment, or if a parameter has a different name than in an already added route.
+            bool add(std::string_view route, const Handler& handler)
+            {
+                Node* node = root.get();
+                std::size_t i = 0;
+                bool ok = true;
+
+                while (ok && i < route.size())
+                {
+                    if (is_special(route, i) && route[i] == ':')
+                    {
+                        auto end = std::min(route.find('/', i), route.size());
+                        auto name = route.substr(i + 1, end - i - 1);
+                        ok = !name.empty();
+
+                        if (ok)
+                        {
+                            if (!node->parameter)
+                            {
+                                node->parameter = std::make_unique<Node>();
+                                node->parameter_name = name;
+                            }
+
+                            ok = node->parameter_name == name;
+                            node = node->parameter.get();
+                            i = end;
+                            dynamic = true;
+                        }
+                    }
+                    else if (is_special(route, i) && route[i] == '*')
+                    {
+                        auto name = route.substr(i + 1);
+                        ok = name.find('/') == std::string_view::npos;
+
+                        if (ok)
+                        {
+                            node->wildcard_name = name.empty() ? "*" : name;
+                            node->wildcard_handler = handler;
+                            dynamic = true;
+                        }
+
+                        return ok;
+                    }
+                    else
+                    {
+                        auto end = i + 1;
+
+                        while (end < route.size() && !is_special(route, end))
+                        {
+                            ++end;
+                        }
+
+                        node = add_static(*node, route.substr(i, end - i));
+                        i = end;
+                    }
+                }
+
+                if (ok)
+                {
+                    node->handler = handler;
+
+                    if (node->route.empty() && !is_dynamic(route))
+                    {
+                        // The node, and thereby the route and handler, stay where they are once created.
+                        node->route = route;
+                        static_routes.emplace(node->route, &*node->handler);
+                    }
+                }
+
+                return ok;
+            }
+
+            /// Finds the handler for a URL.
+            /// \param url The URL, without query string.
+            /// \param parameters Cleared and then assigned the parameters of the matching route.
+            /// \return The handler, or nullptr if no route matches.
+            const Handler* find(std::string_view url, RouteParameters& parameters) const
+            {
+                parameters.clear();
+
+                const Handler* res = nullptr;
+                auto it = static_routes.find(url);
+
+                if (it != static_routes.end())
+                {
+                    res = it->second;
+                }
+                else if (dynamic)
+                {
+                    res = match(*root, url, parameters);
+                }
+
+                return res;
+            }
+
+            [[nodiscard]] bool empty() const
+            {
+                return root->children.empty() && !root->parameter && !root->handler && !root->wildcard_handler;
+            }
+
+        private:
+            struct Node
+            {
+                /// Static text matched by this node, empty for the root and parameter nodes.
+                std::string label{};
+
+                /// Nodes following static text, no two labels starting with the same character.
+                std::vector<std::unique_ptr<Node>> children{};
+
+                /// The first character of the label of each child, in the same order, for a quick scan.
+                std::string indices{};
+
+                std::unique_ptr<Node> parameter{};
+                std::string parameter_name{};
+
+                std::string wildcard_name{};
+                std::optional<Handler> wildcard_handler{};
+
+                std::optional<Handler> handler{};
+
+                /// The entire route, set for nodes ending routes of only static text.
+                std::string route{};
+            };
+
+            static bool is_dynamic(std::string_view route)
+            {
+                bool res = false;
+
+                for (std::size_t i = 0; !res && i < route.size(); ++i)
+                {
+                    res = is_special(route, i);
+                }
+
+                return res;
+            }
+
+            /// Parameters and wildcards are only recognized at the start of a segment.
+            static bool is_special(std::string_view route, std::size_t i)
+            {
+                return i > 0 && route[i - 1] == '/' && (route[i] == ':' || route[i] == '*');
+            }
+
+            /// \return The index of the child whose label starts with c, or std::string::npos.
+            static std::size_t find_child(const Node& node, char c)
+            {
+                // Nodes have few children, a plain loop beats a call to memchr().
+                for (std::size_t i = 0; i < node.indices.size(); ++i)
+                {
+                    if (node.indices[i] == c)
+                    {
+                        return i;
+                    }
+                }
+
+                return std::string::npos;
+            }
+
+            /// Adds static text below a node, splitting existing nodes where the text diverges from their labels.
+            /// The first character of a split node is kept so its index in the parent stays valid.
+            /// \return The node matching the end of the text.
+            static Node* add_static(Node& start, std::string_view text)
+            {
+                Node* current = &start;
+
+                while (!text.empty())
+                {
+                    auto index = find_child(*current, text[0]);
+
+                    if (index == std::string::npos)
+                    {
+                        auto node = std::make_unique<Node>();
+                        node->label = text;
+                        auto* res = node.get();
+                        current->children.emplace_back(std::move(node));
+                        current->indices.push_back(text[0]);
+
+                        return res;
+                    }
+
+                    auto& child = current->children[index];
+                    auto common_length = static_cast<std::size_t>(
+                        std::mismatch(child->label.begin(), child->label.end(), text.begin(), text.end()).first
+                        - child->label.begin());
+
+                    if (common_length < child->label.size())
+                    {
+                        // Split the child, the shared part becoming a new node above it.
+                        auto shared = std::make_unique<Node>();
+                        shared->label = std::string(text.substr(0, common_length));
+                        child->label.erase(0, common_length);
+                        shared->indices.push_back(child->label[0]);
+                        shared->children.emplace_back(std::move(child));
+                        child = std::move(shared);
+                    }
+
+                    current = child.get();
+                    text.remove_prefix(common_length);
+                }
+
+                return current;
+            }
+
+            static const Handler* match(const Node& node, std::string_view url, RouteParameters& parameters)
+            {
+                const Handler* res = nullptr;
+
+                if (url.empty())
+                {
+                    if (node.handler)
+                    {
+                        res = &*node.handler;
+                    }
+                }
+                else
+                {
+                    auto index = find_child(node, url[0]);
+
+                    if (index != std::string::npos)
+                    {
+                        const auto& child = *node.children[index];
+
+                        if (url.compare(0, child.label.size(), child.label) == 0)
+                        {
+                            res = match(child, url.substr(child.label.size()), parameters);
+                        }
+                    }
+
+                    if (!res && node.parameter && url[0] != '/')
+                    {
+                        auto end = std::min(url.find('/'), url.size());
+                        parameters.push(node.parameter_name, url.substr(0, end));
+                        res = match(*node.parameter, url.substr(end), parameters);
+
+                        if (!res)
+                        {
+                            parameters.pop();
+                        }
+                    }
+                }
+
+                if (!res && node.wildcard_handler)
+                {
+                    parameters.push(node.wildcard_name, url);
+                    res = &*node.wildcard_handler;
+                }
+
+                return res;
+            }
+
+            // Held by pointer so that nodes never move, not even when the router is moved.
+            std::unique_ptr<Node> root = std::make_unique<Node>();
+            std::unordered_map<std::string_view, const Handler*> static_routes{};
+            bool dynamic = false;
+    };
+}
@@ -0,0 +1,171 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/core/filesystem/Path.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// Configuration of the StaticFileCache.
+    struct FileCacheConfig
+    {
+        /// The maximum number of paths to remember, including paths that don't exist. 0 disables the cache.
+        std::size_t max_entries = 0;
+
+        /// The maximum total size, in bytes, of file content held in memory. 0 to only cache file information.
+        std::size_t max_content_size = 0;
+
+        /// Files larger than this are never held in memory.
+        std::size_t max_file_size = 0;
+
+        /// How long a cached result is trusted before the file is checked for changes again.
+        std::chrono::milliseconds revalidate_after{ 1000 };
+    };
+
+    /// A snapshot of the counters of a StaticFileCache, accumulated since it was created.
+    struct FileCacheStats
+    {
+        /// Lookups answered without checking the file system.
+        uint64_t hits = 0;
+        /// Lookups of paths not in the cache.
+        uint64_t misses = 0;
+        /// Lookups of cached paths that were checked for changes.
+        uint64_t revalidations = 0;
+        /// Cached results dropped because the file had changed, or on request.
+        uint64_t invalidations = 0;
+        /// Entries removed, or content released, to make room for others.
+        uint64_t evictions = 0;
+        /// Requests for content answered from memory.
+        uint64_t content_hits = 0;
+        /// Requests for content that had to be read from the file system.
+        uint64_t content_misses = 0;
+        std::size_t entries = 0;
+        std::size_t content_size = 0;
+
+        [[nodiscard]] double hit_rate() const
+        {
+            auto lookups = hits + misses + revalidations;
+
+            return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+        }
+
+        [[nodiscard]] double content_hit_rate() const
+        {
+            auto requests = content_hits + content_misses;
+
+            return requests > 0 ? static_cast<double>(content_hits) / static_cast<double>(requests) : 0.0;
+        }
+    };
+
+    /// Information about a file, and possibly its content, at the time it was looked up. Never changes once created.
+    struct CachedFile
+    {
+        /// Looks up a file in the file system, without reading its content.
+        static std::shared_ptr<const CachedFile> stat(const smooth::core::filesystem::Path& path);
+
+        [[nodiscard]] std::chrono::system_clock::time_point last_modified_point() const
+        {
+            return std::chrono::system_clock::from_time_t(last_modified);
+        }
+
+        smooth::core::filesystem::Path path{};
+        bool exists = false;
+        bool regular_file = false;
+        bool directory = false;
+        std::size_t size = 0;
+        time_t last_modified = 0;
+        std::string content_type{};
+
+        /// A strong entity tag made from the size and modification time, e.g. "\"1a2b-5e0c3a01\"".
+        std::string etag{};
+
+        /// The content of the file, if held in memory.
+        std::shared_ptr<const std::vector<uint8_t>> content{};
+    };
+
+    /// A bounded, least recently used, cache of file information and file content, keyed by path, saving
+    /// both stat() calls and reads of hot files from flash. Paths that don't exist are cached too.
+    /// Cached results are checked against the file system once they are older than the configured interval,
+    /// and dropped if the modification time or size of the file has changed.
+    /// Content handed out stays valid, and in memory, for as long as it is used, even after being evicted.
+    /// Thread-safe.
+    class StaticFileCache
+    {
+        public:
+            explicit StaticFileCache(const FileCacheConfig& config);
+
+            StaticFileCache(const StaticFileCache&) = delete;
+
+            StaticFileCache& operator=(const StaticFileCache&) = delete;
+
+            /// Looks up a file.
+            /// \param path The path of the file.
+            /// \param with_content If true, the content of a regular file is read into memory, if allowed by the
+            /// configuration.
+            /// \return Information about the file, never nullptr.
+            std::shared_ptr<const CachedFile> get(const smooth::core::filesystem::Path& path,
+                                                  bool with_content = false);
+
+            /// Drops the cached result of a path, e.g. after writing to the file.
+            void invalidate(const smooth::core::filesystem::Path& path);
+
+            /// Drops all cached results.
+            void clear();
+
+            [[nodiscard]] FileCacheStats get_statistics() const;
+
+            /// Logs the statistics.
+            void dump_statistics() const;
+
+        private:
+            struct Entry
+            {
+                std::string path;
+                std::shared_ptr<const CachedFile> file;
+                std::chrono::steady_clock::time_point validated;
+            };
+
+            using EntryList = std::list<Entry>;
+
+            std::shared_ptr<const CachedFile> load_content(Entry& entry);
+
+            void remove(EntryList::iterator entry);
+
+            void release_content(std::size_t wanted_space);
+
+            static std::size_t content_size_of(const Entry& entry);
+
+            const FileCacheConfig config;
+            mutable std::mutex guard{};
+
+            /// Most recently used first.
+            EntryList entries{};
+            std::unordered_map<std::string, EntryList::iterator> by_path{};
+            std::size_t content_size = 0;
+            FileCacheStats stats{};
+    };
+}
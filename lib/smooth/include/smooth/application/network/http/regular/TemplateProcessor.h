@@ -17,25 +17,74 @@ limitations under the License.
 
 #pragma once
 
+#include <ctime>
 #include <memory>
 #include <set>
-#include <regex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "smooth/core/filesystem/Path.h"
-#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "smooth/application/network/http/IResponseOperation.h"
+#include "smooth/application/network/http/regular/StaticFileCache.h"
 #include "ITemplateDataRetriever.h"
 
 namespace smooth::application::network::http::regular
 {
+    /// A template file split into literal text and tokens, i.e. "{{name}}" where name consists of letters, digits,
+    /// '_' and '-'. Literal text is referred to by its position in the file, so only the tokens are held in memory,
+    /// except for small templates which are held in memory in whole.
+    struct CompiledTemplate
+    {
+        /// Templates up to this size are held in memory.
+        static constexpr std::size_t max_content_size = 512;
+
+        struct Segment
+        {
+            /// Position and length of literal text in the file.
+            std::size_t offset = 0;
+            std::size_t length = 0;
+
+            /// The token, including braces, or empty for literal text.
+            std::string token{};
+        };
+
+        smooth::core::filesystem::Path path{};
+        std::size_t size = 0;
+        time_t last_modified = 0;
+        std::string content_type{};
+        std::vector<Segment> segments{};
+
+        /// The template, when no larger than max_content_size, otherwise empty.
+        std::vector<uint8_t> content{};
+    };
+
+    /// Renders template files. Each template is parsed once, and again only when the file has changed, after which
+    /// rendering is a matter of looking up the value of each token. The rendered page is streamed, reading the
+    /// literal text from the file as it is sent, so it never has to fit in memory. At most max_compiled parsed
+    /// templates are kept, the least recently used is dropped to make room for another. Not thread-safe.
     class TemplateProcessor
     {
         public:
             explicit TemplateProcessor(std::set<std::string> template_files,
                                        std::shared_ptr<ITemplateDataRetriever> data_retriever);
 
+            /// Renders a file, if it is a template file.
+            /// \return The response, or nullptr if the file is not a template file.
             std::unique_ptr<smooth::application::network::http::IResponseOperation>
             process_template(const smooth::core::filesystem::Path& path);
 
+            /// Renders a file looked up in a StaticFileCache, if it is a template file.
+            /// \return The response, or nullptr if the file is not a template file.
+            std::unique_ptr<smooth::application::network::http::IResponseOperation>
+            process_template(const std::shared_ptr<const CachedFile>& file);
+
+            /// Parses a template file. The size and modification time of the parsed template are those of the file
+            /// as it was read, which may be newer than file.
+            /// \return The parsed template, or nullptr if the file is empty or can't be read.
+            static std::shared_ptr<const CompiledTemplate> compile(const CachedFile& file);
+
+            static constexpr std::size_t max_compiled = 16;
+
 #ifndef EXPOSE_PRIVATE_PARTS_FOR_TEST
         private:
 #endif
@@ -44,6 +93,15 @@ namespace smooth::application::network::http::regular
 
             std::set<std::string> template_files;
             std::shared_ptr<ITemplateDataRetriever> data_retriever;
-            const std::regex token{ R"!(\{\{[\d\_\-a-zA-Z]+\}\})!", std::regex::ECMAScript };
+
+            struct Entry
+            {
+                std::shared_ptr<const CompiledTemplate> compiled{};
+                uint64_t last_used = 0;
+            };
+
+            /// Parsed templates, by path.
+            std::unordered_map<std::string, Entry> compiled{};
+            uint64_t use_count = 0;
     };
 }
@@ -39,18 +39,19 @@ namespace smooth::application::network::http::regular
 
                     try
                     {
-                        const auto& upgrade = headers().at(UPGRADE);
-                        const auto& connection = headers().at(CONNECTION);
-                        const auto version = headers().at(SEC_WEBSOCKET_VERSION);
+                        const auto upgrade = headers().get(UPGRADE);
+                        const auto connection = headers().get(CONNECTION);
+                        const auto version = headers().get(SEC_WEBSOCKET_VERSION);
 
                         if (string_util::iequals(upgrade, "websocket")
                             && string_util::icontains(connection, "upgrade")
-                            && string_util::equals(version, "13"))
+                            && string_util::equals(version, "13")
+                            && headers().contains(SEC_WEBSOCKET_KEY))
                         {
-                            const auto& key = headers().at(SEC_WEBSOCKET_KEY);
+                            const auto key = headers().get(SEC_WEBSOCKET_KEY);
                             const char* websocket_key_constant = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 
-                            const auto concat = string_util::trim(key) + websocket_key_constant;
+                            const auto concat = string_util::trim(std::string{ key }) + websocket_key_constant;
                             auto hash = hash::sha1(reinterpret_cast<const uint8_t*>(concat.data()), concat.length());
 
                             auto reply_key = hash::base64::encode(
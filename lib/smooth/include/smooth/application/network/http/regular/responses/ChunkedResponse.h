@@ -0,0 +1,73 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "HeaderOnlyResponse.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// A response whose content is produced while it is being sent, for when the size of the content isn't
+    /// known up front. The content is sent using chunked transfer-encoding, one chunk per call to get_data(),
+    /// so no more than what fits in a single chunk is held in memory at any time.
+    /// Either provide a producer or derive from this class and override produce().
+    class ChunkedResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            /// Produces the next part of the content.
+            /// \param max_amount The maximum number of bytes to append to target.
+            /// \param target Where to append the content.
+            /// \return true while there is more content to produce, false once the last of it has been appended.
+            using Producer = std::function<bool(std::size_t max_amount, std::vector<uint8_t>& target)>;
+
+            /// Constructor
+            /// \param code The response code
+            /// \param content_type The MIME type of the content.
+            /// \param producer Produces the content, see Producer.
+            ChunkedResponse(ResponseCode code, const std::string& content_type, Producer producer = nullptr);
+
+            ChunkedResponse& operator=(ChunkedResponse&&) = default;
+
+            ChunkedResponse(ChunkedResponse&&) = default;
+
+            ChunkedResponse& operator=(const ChunkedResponse&) = delete;
+
+            ChunkedResponse(const ChunkedResponse&) = delete;
+
+            ~ChunkedResponse() override = default;
+
+            // Called at least once when sending a response and until ResponseStatus::AllSent is returned
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            void dump() const override;
+
+        protected:
+            /// Produces the next part of the content, by default by calling the producer.
+            /// An empty part is allowed, nothing is then sent until the next call.
+            /// \see Producer
+            virtual bool produce(std::size_t max_amount, std::vector<uint8_t>& target);
+
+        private:
+            Producer producer;
+            std::size_t content_sent = 0;
+            bool finished = false;
+    };
+}
@@ -17,26 +17,74 @@ limitations under the License.
 
 #pragma once
 
+#include <string>
+#include <vector>
 #include "StringResponse.h"
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/core/filesystem/FileReader.h"
 #include "smooth/core/filesystem/Path.h"
-#include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/application/network/http/regular/StaticFileCache.h"
 
 namespace smooth::application::network::http::regular::responses
 {
+    /// Sends a file, or the ranges of it requested by a Range header. Unless the content is held in memory by the
+    /// StaticFileCache, the file is read while sending, kept open for the life of the response, and the next part
+    /// is read ahead while the current part is sent.
     class FileContentResponse
         : public StringResponse
     {
         public:
             explicit FileContentResponse(smooth::core::filesystem::Path full_path);
 
+            /// Sends a file looked up in a StaticFileCache, from memory if its content is held there.
+            /// \param file The file to send.
+            /// \param content_type The MIME type of the content.
+            /// \param content_encoding The encoding of the file, if it is a precompressed version of the requested
+            /// file, e.g. "gzip".
+            /// \param ranges The ranges to send, as returned by utils::parse_byte_ranges(). If empty, the entire
+            /// file is sent. A single range is sent as is, multiple ranges as multipart/byteranges, both with
+            /// code 206 Partial Content.
+            FileContentResponse(std::shared_ptr<const CachedFile> file,
+                                const std::string& content_type,
+                                const std::string& content_encoding = "",
+                                const std::vector<utils::ByteRange>& ranges = {});
+
             // Called at least once when sending a response and until ResponseStatus::AllSent is returned
             ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
 
+            std::shared_ptr<smooth::core::network::FileRegion> get_file_region() override;
+
+            void prepare_next(std::size_t max_amount) override;
+
             void dump() const override;
 
         private:
-            smooth::core::filesystem::Path path;
-            smooth::core::filesystem::FileInfo info;
+            /// A part of the body; a range of the file, preceded by its multipart headers when there are several.
+            struct Part
+            {
+                std::string head;
+                std::size_t offset;
+                std::size_t length;
+            };
+
+            /// Appends content of the file, from memory, the read ahead data or the file itself.
+            /// \param offset Position in the file.
+            /// \param length The number of bytes to append, lowered if less is read ahead.
+            bool append_content(std::size_t offset, std::size_t& length, std::vector<uint8_t>& target);
+
+            /// Reads a part of the file.
+            bool read(std::size_t offset, std::size_t length, std::vector<uint8_t>& target);
+
+            std::shared_ptr<const CachedFile> file;
+            std::vector<Part> parts{};
+            std::size_t total{ 0 };
             std::size_t sent{ 0 };
+            std::size_t current_part{ 0 };
+            std::size_t sent_of_part{ 0 };
+            std::unique_ptr<smooth::core::filesystem::FileReader> reader{};
+            std::size_t reader_position{ 0 };
+            std::vector<uint8_t> read_ahead{};
+            std::size_t read_ahead_offset{ 0 };
+            bool read_ahead_failed{ false };
     };
 }
@@ -18,7 +18,9 @@ limitations under the License.
 #pragma once
 
 #include "HeaderOnlyResponse.h"
+#include <string>
 #include <vector>
+#include "smooth/application/network/http/ResponseBody.h"
 
 namespace smooth::application::network::http::regular::responses
 {
@@ -28,6 +30,12 @@ namespace smooth::application::network::http::regular::responses
         public:
             explicit StringResponse(ResponseCode code, std::string body = "", bool add_surrounding_html = true);
 
+            /// Sends a body as is, e.g. one shared with other responses, without copying it.
+            /// \param code The response code.
+            /// \param body The body.
+            /// \param content_type The MIME type of the body.
+            StringResponse(ResponseCode code, ResponseBody body, const std::string& content_type = "text/html");
+
             StringResponse& operator=(StringResponse&&) = default;
 
             StringResponse(StringResponse&&) = default;
@@ -44,8 +52,6 @@ namespace smooth::application::network::http::regular::responses
             void dump() const override;
 
         private:
-            std::vector<uint8_t> data{};
-
-            void add_string(std::string str);
+            ResponseBody body;
     };
 }
@@ -0,0 +1,68 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "StringResponse.h"
+#include "smooth/core/filesystem/FileReader.h"
+#include "smooth/application/network/http/regular/TemplateProcessor.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Sends a rendered template, one segment at a time. Literal text is read from the template file as it is
+    /// sent, tokens are replaced by values looked up when the response is created. Should the file no longer be
+    /// the one that was parsed, the response fails rather than sending a mix of the two.
+    class TemplateResponse
+        : public StringResponse
+    {
+        public:
+            /// \param compiled The template to render.
+            /// \param values The value of each segment of the template that is a token, empty for literal text.
+            TemplateResponse(std::shared_ptr<const CompiledTemplate> compiled, std::vector<std::string> values);
+
+            // Called at least once when sending a response and until ResponseStatus::AllSent is returned
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            void dump() const override;
+
+        private:
+            [[nodiscard]] std::size_t length_of(std::size_t segment) const;
+
+            /// Appends literal text, read from the template file in blocks of at least read_size bytes, so that
+            /// literal text separated by tokens is usually read in one go.
+            bool append_literal(std::size_t offset, std::size_t length, std::size_t read_size,
+                                std::vector<uint8_t>& target);
+
+            bool read(std::size_t offset, std::size_t length, std::vector<uint8_t>& target);
+
+            [[nodiscard]] bool is_compiled_version(std::size_t size, time_t last_modified) const;
+
+            std::shared_ptr<const CompiledTemplate> compiled;
+            std::vector<std::string> values;
+            std::size_t total{ 0 };
+            std::size_t sent{ 0 };
+            std::size_t current_segment{ 0 };
+            std::size_t sent_of_segment{ 0 };
+            std::unique_ptr<smooth::core::filesystem::FileReader> reader{};
+            std::size_t reader_position{ 0 };
+            std::vector<uint8_t> block{};
+            std::size_t block_offset{ 0 };
+    };
+}
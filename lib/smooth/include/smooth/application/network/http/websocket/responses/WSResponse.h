@@ -35,6 +35,7 @@ limitations under the License.
 #pragma once
 
 #include "smooth/application/network/http/IResponseOperation.h"
+#include "smooth/application/network/http/ResponseBody.h"
 #include "smooth/application/network/http/websocket/OpCode.h"
 
 namespace smooth::application::network::http::websocket::responses
@@ -54,6 +55,9 @@ namespace smooth::application::network::http::websocket::responses
 
             explicit WSResponse(std::vector<uint8_t>&& binary, bool first_fragment, bool last_fragment);
 
+            /// Sends a body as is, e.g. one shared with other responses, without copying it.
+            WSResponse(ResponseBody body, bool treat_as_text, bool first_fragment, bool last_fragment);
+
             ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
 
         private:
@@ -66,6 +70,6 @@ namespace smooth::application::network::http::websocket::responses
             bool first_fragment{ true };
             bool last_fragment{ true };
 
-            std::vector<uint8_t> data{};
+            ResponseBody data{};
     };
 }
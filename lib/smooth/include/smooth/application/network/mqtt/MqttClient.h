@@ -81,6 +81,13 @@ namespace smooth::application::network::mqtt
 
             void set_authorization(const std::string& username, const std::string& password);
 
+            /// Sets the options applied to the socket on the next (re)connect, e.g. to enable TCP Fast Open
+            /// or keepalive probes.
+            void set_socket_options(const smooth::core::network::SocketOptions& options)
+            {
+                socket_options = options;
+            }
+
             void reconnect() override
             {
                 if (address)
@@ -215,7 +222,8 @@ namespace smooth::application::network::mqtt
             std::shared_ptr<smooth::core::network::BufferContainer<packet::MQTTProtocol>> buff{};
             std::string username;
             std::string password;
-            
+            smooth::core::network::SocketOptions socket_options{};
+
             bool is_mqtts = false;
             std::unique_ptr<smooth::core::network::MBedTLSContext> tls_context{};
     };
@@ -8,5 +8,7 @@ const int CONFIG_SMOOTH_MAX_MQTT_OUTGOING_MESSAGES = 10;
 const int SMOOTH_MQTT_LOGGING_LEVEL = 1;
 const int CONFIG_SMOOTH_SOCKET_DISPATCHER_STACK_SIZE = 20480;
 const int CONFIG_SMOOTH_TIMER_SERVICE_STACK_SIZE = 3072;
+const int CONFIG_SMOOTH_DNS_RESOLVER_STACK_SIZE = 4096;
+const int CONFIG_SMOOTH_TLS_HANDSHAKE_STACK_SIZE = 12288;
 const int CONFIG_LWIP_MAX_SOCKETS = 10;
 #endif
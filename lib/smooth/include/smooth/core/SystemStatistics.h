@@ -17,6 +17,9 @@ limitations under the License.
 #pragma once
 #include <unordered_map>
 #include <mutex>
+#include <string>
+#include <vector>
+#include "smooth/core/network/SocketStatistics.h"
 
 namespace smooth::core
 {
@@ -50,7 +53,16 @@ namespace smooth::core
             uint32_t high_water_mark{};
     };
 
-    /// \brief Displays system statistics; memory and stack usage.
+    /// A copy of the statistics at a point in time, for export.
+    struct StatisticsSnapshot
+    {
+        std::unordered_map<std::string, TaskStats> tasks{};
+        smooth::core::network::DispatcherStats dispatcher{};
+        /// The sockets active at the time of the last report from the socket dispatcher.
+        std::vector<smooth::core::network::SocketStats> sockets{};
+    };
+
+    /// \brief Displays system statistics; memory and stack usage, socket dispatcher and socket I/O.
     class SystemStatistics
     {
         public:
@@ -69,6 +81,18 @@ namespace smooth::core
                 task_info[task_name] = stats;
             }
 
+            /// Called by the socket dispatcher to report its counters, and those of the active sockets.
+            void report(const smooth::core::network::DispatcherStats& dispatcher,
+                        std::vector<smooth::core::network::SocketStats>&& sockets) noexcept
+            {
+                synch guard{ lock };
+                dispatcher_stats = dispatcher;
+                socket_stats = std::move(sockets);
+            }
+
+            /// Returns a copy of the current statistics.
+            [[nodiscard]] StatisticsSnapshot snapshot() const;
+
             void dump() const noexcept;
 
         private:
@@ -80,5 +104,7 @@ namespace smooth::core
 
             mutable std::mutex lock{};
             std::unordered_map<std::string, TaskStats> task_info{};
+            smooth::core::network::DispatcherStats dispatcher_stats{};
+            std::vector<smooth::core::network::SocketStats> socket_stats{};
     };
 }
@@ -33,6 +33,9 @@ namespace smooth::core::filesystem
 
             FSLock();
 
+            /// Takes a slot only if one is available right away, see owns_lock().
+            explicit FSLock(std::try_to_lock_t);
+
             virtual ~FSLock() final;
 
             FSLock(const FSLock&) = delete;
@@ -43,7 +46,15 @@ namespace smooth::core::filesystem
 
             FSLock& operator=(const FSLock&&) = delete;
 
+            /// Returns a value indicating if a slot was taken, always true unless constructed with std::try_to_lock.
+            [[nodiscard]] bool owns_lock() const
+            {
+                return owns;
+            }
+
         private:
+            bool owns = true;
+
             static std::mutex lock;
             static std::condition_variable cv;
             static int max;
@@ -0,0 +1,74 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include "smooth/core/filesystem/FSLock.h"
+#include "smooth/core/filesystem/Path.h"
+
+namespace smooth::core::filesystem
+{
+    /// Reads a file in sequential parts, keeping it open between reads. Unlike File::read(), which opens
+    /// the file and waits for a slot in FSLock on every call, the slot is only taken once, when the reader
+    /// is created, and kept until it is destroyed. To never block, the reader doesn't wait for a slot;
+    /// if none is available it isn't opened, see is_open().
+    class FileReader
+    {
+        public:
+            /// Opens a file for reading.
+            /// \param path The file to read
+            /// \param offset Where to start reading, in bytes from the start of the file.
+            FileReader(const Path& path, std::size_t offset);
+
+            ~FileReader();
+
+            FileReader(const FileReader&) = delete;
+
+            FileReader& operator=(const FileReader&) = delete;
+
+            /// Returns a value indicating if the file was opened.
+            [[nodiscard]] bool is_open() const
+            {
+                return fd >= 0;
+            }
+
+            /// Reads the next part of the file.
+            /// \param target The data is appended to this container.
+            /// \param length The number of bytes to read.
+            /// \return true if all bytes were read, false on error or if the end of the file was reached first.
+            bool read(std::vector<uint8_t>& target, std::size_t length);
+
+            /// Moves to another position in the file.
+            /// \param offset The position, in bytes from the start of the file.
+            /// \return true on success
+            bool seek(std::size_t offset);
+
+            /// Gets the size and modification time of the open file, e.g. to verify that it is the expected version.
+            /// \param size Receives the size of the file.
+            /// \param last_modified Receives the modification time of the file.
+            /// \return true on success
+            bool stat(std::size_t& size, time_t& last_modified) const;
+
+        private:
+            FSLock fs_lock{ std::try_to_lock };
+            int fd = -1;
+    };
+}
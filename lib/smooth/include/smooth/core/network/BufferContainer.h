@@ -22,6 +22,7 @@ limitations under the License.
 #include "smooth/core/ipc/TaskEventQueue.h"
 #include "smooth/core/network/PacketSendBuffer.h"
 #include "smooth/core/network/PacketReceiveBuffer.h"
+#include "smooth/core/network/BufferDepth.h"
 #include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
 #include "smooth/core/network/event/ConnectionStatusEvent.h"
 #include "smooth/core/network/event/DataAvailableEvent.h"
@@ -29,15 +30,23 @@ limitations under the License.
 
 namespace smooth::core::network
 {
-    template<typename Protocol, int BufferSize = 5>
+    template<typename Protocol>
     class BufferContainer
     {
         public:
+            /// Constructor
+            /// \param task The task to which events are delivered.
+            /// \param transmit_buffer_empty Receiver of TransmitBufferEmptyEvent
+            /// \param data_receiver Receiver of DataAvailableEvent
+            /// \param connection_status_receiver Receiver of ConnectionStatusEvent
+            /// \param proto The protocol
+            /// \param depth The number of packets the receive and transmit buffers may hold.
             BufferContainer(smooth::core::Task& task,
                             smooth::core::ipc::IEventListener<event::TransmitBufferEmptyEvent>& transmit_buffer_empty,
                             smooth::core::ipc::IEventListener<event::DataAvailableEvent<Protocol>>& data_receiver,
                             smooth::core::ipc::IEventListener<event::ConnectionStatusEvent>& connection_status_receiver,
-                            std::unique_ptr<Protocol> proto);
+                            std::unique_ptr<Protocol> proto,
+                            BufferDepth depth = BufferDepth{});
 
             const auto& get_tx_empty()
             {
@@ -54,12 +63,12 @@ namespace smooth::core::network
                 return connection_status;
             }
 
-            smooth::core::network::PacketSendBuffer<Protocol, BufferSize>& get_tx_buffer()
+            smooth::core::network::PacketSendBuffer<Protocol>& get_tx_buffer()
             {
                 return tx_buffer;
             }
 
-            smooth::core::network::PacketReceiveBuffer<Protocol, BufferSize>& get_rx_buffer()
+            smooth::core::network::PacketReceiveBuffer<Protocol>& get_rx_buffer()
             {
                 return rx_buffer;
             }
@@ -85,20 +94,22 @@ namespace smooth::core::network
             std::shared_ptr<DataAvailableQueue> data_available;
             using ConnectionStatusQueue = smooth::core::ipc::TaskEventQueue<network::event::ConnectionStatusEvent>;
             std::shared_ptr<ConnectionStatusQueue> connection_status;
-            PacketSendBuffer<Protocol, BufferSize> tx_buffer{};
-            PacketReceiveBuffer<Protocol, BufferSize> rx_buffer{};
+            PacketSendBuffer<Protocol> tx_buffer;
+            PacketReceiveBuffer<Protocol> rx_buffer;
     };
 
-    template<typename Protocol, int BufferSize>
-    BufferContainer<Protocol, BufferSize>::BufferContainer(smooth::core::Task& task,
-                                                           smooth::core::ipc::IEventListener<event::TransmitBufferEmptyEvent>& transmit_buffer_empty,
-                                                           smooth::core::ipc::IEventListener<event::DataAvailableEvent<Protocol>>& data_receiver,
-                                                           smooth::core::ipc::IEventListener<event::ConnectionStatusEvent>& connection_status_receiver,
-                                                           std::unique_ptr<Protocol> proto)
-            : tx_empty(TxEmptyQueue::create(BufferSize, task, transmit_buffer_empty)),
-              data_available(DataAvailableQueue::create(BufferSize, task, data_receiver)),
-              connection_status(ConnectionStatusQueue::create(BufferSize, task, connection_status_receiver)),
-              rx_buffer(std::move(proto))
+    template<typename Protocol>
+    BufferContainer<Protocol>::BufferContainer(smooth::core::Task& task,
+                                               smooth::core::ipc::IEventListener<event::TransmitBufferEmptyEvent>& transmit_buffer_empty,
+                                               smooth::core::ipc::IEventListener<event::DataAvailableEvent<Protocol>>& data_receiver,
+                                               smooth::core::ipc::IEventListener<event::ConnectionStatusEvent>& connection_status_receiver,
+                                               std::unique_ptr<Protocol> proto,
+                                               BufferDepth depth)
+            : tx_empty(TxEmptyQueue::create(depth.max, task, transmit_buffer_empty)),
+              data_available(DataAvailableQueue::create(depth.max, task, data_receiver)),
+              connection_status(ConnectionStatusQueue::create(depth.max, task, connection_status_receiver)),
+              tx_buffer(depth),
+              rx_buffer(std::move(proto), depth)
     {
     }
 }
@@ -0,0 +1,48 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+namespace smooth::core::network
+{
+    /// The number of packets the receive and transmit buffers of a connection may hold.
+    /// When max is larger than initial the buffers grow during bursts, up to max packets,
+    /// and shrink back to initial once drained. When the receive buffer is full, reading
+    /// from the socket is paused until the application has consumed a packet.
+    struct BufferDepth
+    {
+        BufferDepth() = default;
+
+        /// Fixed depth
+        /// \param depth Number of packets
+        explicit BufferDepth(int depth)
+                : initial(depth), max(depth)
+        {
+        }
+
+        /// Adaptive depth
+        /// \param initial Number of packets the buffers hold until they have to grow.
+        /// \param max Number of packets the buffers may grow to.
+        BufferDepth(int initial, int max)
+                : initial(initial), max(max < initial ? initial : max)
+        {
+        }
+
+        int initial = 5;
+        int max = 5;
+    };
+}
@@ -14,13 +14,15 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 */
-
 #pragma once
 
-#include <deque>
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
-#include <algorithm>
+#include "smooth/core/network/ClientPoolSize.h"
 
 namespace smooth::core
 {
@@ -32,16 +34,37 @@ namespace smooth::core::network
     /// ClientPool holds a number of client instances which are requested by the
     /// owning ServerSocket. When a client is done, i.e. connection closed, it
     /// is returned to the pool for reuse at a later time.
+    ///
+    /// Clients live in a fixed array of slots, linked into a free list by index, so both get() and
+    /// return_client() are O(1). The most recently returned client is handed out first, keeping the
+    /// least recently used ones at the tail of the free list where they are trimmed when idle,
+    /// see ClientPoolSize. Clients are requested on the socket dispatcher's task and returned on the
+    /// server's task, so the pool is thread-safe.
     /// \tparam Client The client type held by the pool.
     template<typename Client>
     class ClientPool
     {
         public:
-            ClientPool(smooth::core::Task& task, int count);
+            ClientPool(smooth::core::Task& task, ClientPoolSize size);
+
+            ClientPool(const ClientPool&) = delete;
+
+            ClientPool& operator=(const ClientPool&) = delete;
 
+            /// Returns a value indicating if there are no clients available, neither idle nor possible to create.
             bool empty() const
             {
-                return clients.empty();
+                std::lock_guard<std::mutex> lock(guard);
+
+                return free_head == no_slot && vacant_head == no_slot;
+            }
+
+            /// Returns the number of clients currently created, whether in use or not.
+            int size() const
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return created;
             }
 
             std::shared_ptr<Client> get();
@@ -51,22 +74,80 @@ namespace smooth::core::network
             template<typename... Args>
             void create_clients(Args ... args);
 
+            /// Destroys clients, beyond the initial ones, that have been idle for at least the idle timeout.
+            /// Called periodically by the owning ServerSocket when the pool is elastic and has an idle timeout.
+            void trim();
+
+            [[nodiscard]] const ClientPoolSize& get_pool_size() const
+            {
+                return pool_size;
+            }
+
         private:
+            static constexpr int no_slot = -1;
+
+            struct Slot
+            {
+                std::shared_ptr<Client> client{};
+                int next = no_slot;
+                int prev = no_slot;
+                std::chrono::steady_clock::time_point idle_since{};
+                bool in_use = false;
+            };
+
+            void push_free(int index);
+
+            void unlink_free(int index);
+
+            bool create_client(int index);
+
             smooth::core::Task& task;
-            std::deque<std::shared_ptr<Client>> clients{};
-            std::vector<std::shared_ptr<Client>> in_use{};
+            ClientPoolSize pool_size;
+            std::vector<Slot> slots;
+            std::function<std::shared_ptr<Client>()> factory{};
+            int free_head = no_slot;
+            int free_tail = no_slot;
+            int vacant_head = no_slot;
+            int created = 0;
+            mutable std::mutex guard{};
     };
 
+    template<typename Client>
+    ClientPool<Client>::ClientPool(smooth::core::Task& task, ClientPoolSize size)
+            : task(task),
+              pool_size(size),
+              slots(static_cast<std::size_t>(std::max(0, size.max)))
+    {
+        // All slots start out vacant, clients are created by create_clients() or on demand.
+        for (int i = static_cast<int>(slots.size()) - 1; i >= 0; --i)
+        {
+            slots[static_cast<std::size_t>(i)].next = vacant_head;
+            vacant_head = i;
+        }
+    }
+
     template<typename Client>
     std::shared_ptr<Client> ClientPool<Client>::get()
     {
+        std::lock_guard<std::mutex> lock(guard);
         std::shared_ptr<Client> c{};
 
-        if (!clients.empty())
+        if (free_head != no_slot)
+        {
+            auto index = free_head;
+            unlink_free(index);
+            slots[static_cast<std::size_t>(index)].in_use = true;
+            c = slots[static_cast<std::size_t>(index)].client;
+        }
+        else if (vacant_head != no_slot && factory)
         {
-            c = *clients.begin();
-            in_use.push_back(c);
-            clients.pop_front();
+            auto index = vacant_head;
+
+            if (create_client(index))
+            {
+                slots[static_cast<std::size_t>(index)].in_use = true;
+                c = slots[static_cast<std::size_t>(index)].client;
+            }
         }
 
         return c;
@@ -76,30 +157,125 @@ namespace smooth::core::network
     void ClientPool<Client>::return_client(std::shared_ptr<Client> client)
     {
         client->reset();
-        auto found = std::find(in_use.begin(), in_use.end(), client);
 
-        if (found != in_use.end())
+        std::lock_guard<std::mutex> lock(guard);
+        auto& slot = slots[static_cast<std::size_t>(client->pool_slot)];
+
+        // Guard the free list against a client being returned twice.
+        if (slot.in_use)
         {
-            in_use.erase(found);
+            slot.in_use = false;
+            push_free(client->pool_slot);
         }
+    }
+
+    template<typename Client>
+    template<typename... ProtocolArguments>
+    void ClientPool<Client>::create_clients(ProtocolArguments... args)
+    {
+        std::lock_guard<std::mutex> lock(guard);
 
-        clients.push_back(std::move(client));
+        factory = [this, args...]() {
+                      return std::make_shared<Client>(task, *this, args...);
+                  };
+
+        for (int i = 0; i < pool_size.initial && vacant_head != no_slot; ++i)
+        {
+            auto index = vacant_head;
+
+            if (create_client(index))
+            {
+                push_free(index);
+            }
+        }
     }
 
     template<typename Client>
-    ClientPool<Client>::ClientPool(smooth::core::Task& task, int count)
-            : task(task)
+    void ClientPool<Client>::trim()
     {
-        in_use.reserve(static_cast<typename decltype(in_use)::size_type>(count));
+        // Destroy the clients outside the lock, taking down their buffers and queues may take a while.
+        std::vector<std::shared_ptr<Client>> idle{};
+
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            auto now = std::chrono::steady_clock::now();
+
+            while (free_tail != no_slot
+                   && created > pool_size.initial
+                   && now - slots[static_cast<std::size_t>(free_tail)].idle_since >= pool_size.idle_timeout)
+            {
+                auto index = free_tail;
+                auto& slot = slots[static_cast<std::size_t>(index)];
+                unlink_free(index);
+                idle.emplace_back(std::move(slot.client));
+                slot.next = vacant_head;
+                vacant_head = index;
+                --created;
+            }
+        }
     }
 
     template<typename Client>
-    template<typename... ProtocolArguments>
-    void ClientPool<Client>::create_clients(ProtocolArguments... args)
+    void ClientPool<Client>::push_free(int index)
     {
-        for (std::size_t i = 0; i < in_use.capacity(); ++i)
+        auto& slot = slots[static_cast<std::size_t>(index)];
+        slot.idle_since = std::chrono::steady_clock::now();
+        slot.prev = no_slot;
+        slot.next = free_head;
+
+        if (free_head != no_slot)
+        {
+            slots[static_cast<std::size_t>(free_head)].prev = index;
+        }
+        else
         {
-            clients.emplace_back(std::make_shared<Client>(task, *this, args...));
+            free_tail = index;
         }
+
+        free_head = index;
+    }
+
+    template<typename Client>
+    void ClientPool<Client>::unlink_free(int index)
+    {
+        auto& slot = slots[static_cast<std::size_t>(index)];
+
+        if (slot.prev != no_slot)
+        {
+            slots[static_cast<std::size_t>(slot.prev)].next = slot.next;
+        }
+        else
+        {
+            free_head = slot.next;
+        }
+
+        if (slot.next != no_slot)
+        {
+            slots[static_cast<std::size_t>(slot.next)].prev = slot.prev;
+        }
+        else
+        {
+            free_tail = slot.prev;
+        }
+
+        slot.next = no_slot;
+        slot.prev = no_slot;
+    }
+
+    template<typename Client>
+    bool ClientPool<Client>::create_client(int index)
+    {
+        auto& slot = slots[static_cast<std::size_t>(index)];
+        slot.client = factory();
+
+        if (slot.client)
+        {
+            vacant_head = slot.next;
+            slot.next = no_slot;
+            slot.client->pool_slot = index;
+            ++created;
+        }
+
+        return static_cast<bool>(slot.client);
     }
 }
@@ -0,0 +1,58 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <chrono>
+
+namespace smooth::core::network
+{
+    /// The number of clients a server socket holds in its ClientPool, i.e. the maximum number of simultaneous
+    /// connections. When max is larger than initial, clients are created on demand, up to max, and clients
+    /// that have been idle for idle_timeout are destroyed until the pool is back to initial, releasing
+    /// their buffers.
+    struct ClientPoolSize
+    {
+        ClientPoolSize() = default;
+
+        /// Fixed size, all clients are created up front.
+        /// \param count Number of clients
+        explicit ClientPoolSize(int count)
+                : initial(count), max(count)
+        {
+        }
+
+        /// Elastic size
+        /// \param initial Number of clients created up front, and kept when idle.
+        /// \param max Number of clients the pool may grow to.
+        /// \param idle_timeout Time a client, beyond the initial ones, may be unused before being destroyed.
+        /// Zero keeps clients once created.
+        ClientPoolSize(int initial, int max, std::chrono::milliseconds idle_timeout)
+                : initial(initial), max(max < initial ? initial : max), idle_timeout(idle_timeout)
+        {
+        }
+
+        /// Returns a value indicating if clients are created on demand.
+        [[nodiscard]] bool is_elastic() const
+        {
+            return max > initial;
+        }
+
+        int initial = 1;
+        int max = 1;
+        std::chrono::milliseconds idle_timeout{ 0 };
+    };
+}
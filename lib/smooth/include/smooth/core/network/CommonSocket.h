@@ -28,6 +28,7 @@ limitations under the License.
 
 #include <chrono>
 #include "smooth/core/timer/ElapsedTime.h"
+#include "smooth/core/network/SocketOptions.h"
 
 namespace smooth::core::network
 {
@@ -72,15 +73,62 @@ namespace smooth::core::network
                 return receive_timeout;
             }
 
+            bool can_send_file() const override
+            {
+                return false;
+            }
+
+            /// Sets the options to apply when the socket is created or an accepted socket is assigned.
+            void set_socket_options(const SocketOptions& options)
+            {
+                socket_options = options;
+            }
+
+            [[nodiscard]] const SocketOptions& get_socket_options() const
+            {
+                return socket_options;
+            }
+
+            [[nodiscard]] SocketStats get_statistics() const override;
+
         protected:
+            SocketCounters& get_counters() override
+            {
+                return counters;
+            }
+
             bool set_non_blocking();
 
+            /// Starts the socket via the SocketDispatcher using the given address, without blocking on name resolution.
+            /// \return false if the address is known to be invalid, otherwise true.
+            bool start_with_address(std::shared_ptr<InetAddress> address);
+
+            /// Applies the socket options, except Fast Open, to the underlying socket.
+            /// \return true on success, false if any of the options could not be set.
+            bool apply_socket_options();
+
+            /// Enables TCP Fast Open on a newly created socket, if requested by the socket options and supported.
+            /// \param listening true if the socket is a server socket about to start listening.
+            /// \return true on success, false if Fast Open could not be enabled.
+            bool apply_fast_open(bool listening);
+
+            /// Returns the flags to pass to send().
+            /// \param more_follows true if more data is queued after the data being sent.
+            [[nodiscard]] int get_send_flags(bool more_follows) const;
+
+            bool set_option(int level, int name, int value, const char* error);
+
             void log(const char* message);
 
             void loge(const char* message);
 
             bool is_connected() const override;
 
+            bool has_buffered_data() override
+            {
+                return false;
+            }
+
             bool has_send_expired() const override
             {
                 return send_timeout.count() > 0
@@ -101,7 +149,9 @@ namespace smooth::core::network
             int socket_id = INVALID_SOCKET;
             std::chrono::milliseconds send_timeout{ 0 };
             std::chrono::milliseconds receive_timeout{ 0 };
+            SocketOptions socket_options{};
             smooth::core::timer::ElapsedTime elapsed_send_time{};
             smooth::core::timer::ElapsedTime elapsed_receive_time{};
+            SocketCounters counters{};
     };
 }
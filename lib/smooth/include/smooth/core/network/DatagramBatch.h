@@ -0,0 +1,134 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+#include <sys/socket.h>
+#endif
+
+namespace smooth::core::network
+{
+    /// Holds the buffers needed to receive and send several datagrams with a single system call,
+    /// using recvmmsg()/sendmmsg() on Linux. On other platforms, i.e. lwIP, each datagram is
+    /// received or sent with its own call to recv()/send().
+    class DatagramBatch
+    {
+        public:
+            /// Returns a value indicating if several datagrams are moved per system call on the current platform.
+            static constexpr bool is_batching_supported()
+            {
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+                return true;
+#else
+                return false;
+#endif
+            }
+
+            /// The default number of datagrams per batch; there is no point in using more than one
+            /// receive buffer per batch when each datagram needs its own system call anyway.
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+            static constexpr int default_batch_size = 16;
+#else
+            static constexpr int default_batch_size = 1;
+#endif
+
+            /// Constructor
+            /// \param max_datagram_size The largest datagram that can be received, in bytes. Larger datagrams
+            /// are truncated.
+            /// \param batch_size The maximum number of datagrams per batch.
+            DatagramBatch(std::size_t max_datagram_size, int batch_size = default_batch_size);
+
+            DatagramBatch(const DatagramBatch&) = delete;
+
+            DatagramBatch& operator=(const DatagramBatch&) = delete;
+
+            [[nodiscard]] int get_batch_size() const
+            {
+                return batch_size;
+            }
+
+            /// Receives up to count datagrams, limited to the batch size, without blocking.
+            /// \param socket_id The socket to receive from.
+            /// \param count The maximum number of datagrams to receive.
+            /// \return The number of datagrams received, or -1 on error with errno set (EWOULDBLOCK when
+            /// there is nothing to receive).
+            int receive(int socket_id, int count);
+
+            /// Returns the data of a datagram received by the last call to receive().
+            [[nodiscard]] const uint8_t* get_data(int index) const
+            {
+                return receive_buffer.data() + static_cast<std::size_t>(index) * max_datagram_size;
+            }
+
+            /// Returns the length of a datagram received by the last call to receive().
+            [[nodiscard]] int get_length(int index) const
+            {
+                return lengths[static_cast<std::size_t>(index)];
+            }
+
+            /// Returns a value indicating if a datagram received by the last call to receive() was larger than
+            /// max_datagram_size and has been truncated.
+            [[nodiscard]] bool is_truncated(int index) const
+            {
+                return truncated[static_cast<std::size_t>(index)];
+            }
+
+            /// Adds a datagram to be sent by the next call to send(). The data is not copied and must
+            /// stay valid until then.
+            /// \return false if the batch is already full.
+            bool stage(const uint8_t* data, int length);
+
+            [[nodiscard]] int get_staged_count() const
+            {
+                return staged;
+            }
+
+            /// Sends the staged datagrams without blocking and unstages them.
+            /// \param socket_id The socket to send on.
+            /// \param flags Flags passed to the underlying send call.
+            /// \return The number of datagrams sent, 0 if none could be sent right now or -1 on error with errno set.
+            int send(int socket_id, int flags);
+
+            /// Returns the number of bytes in the datagrams sent by the last call to send().
+            [[nodiscard]] int get_sent_bytes() const
+            {
+                return sent_bytes;
+            }
+
+        private:
+            std::size_t max_datagram_size;
+            int batch_size;
+            int staged = 0;
+            int sent_bytes = 0;
+            std::vector<uint8_t> receive_buffer;
+            std::vector<int> lengths;
+            std::vector<bool> truncated;
+            std::vector<const uint8_t*> send_data;
+            std::vector<int> send_lengths;
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+            std::vector<iovec> receive_vectors;
+            std::vector<mmsghdr> receive_headers;
+            std::vector<iovec> send_vectors;
+            std::vector<mmsghdr> send_headers;
+#endif
+    };
+}
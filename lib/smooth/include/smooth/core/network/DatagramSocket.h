@@ -0,0 +1,265 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include "Socket.h"
+#include "DatagramBatch.h"
+
+namespace smooth::core::network
+{
+    /// The largest UDP payload that fits in a single Ethernet frame without fragmentation.
+    static constexpr std::size_t DefaultMaxDatagramSize = 1472;
+
+    /// DatagramSocket is used to perform UDP communication with a single remote endpoint, for example
+    /// to stream telemetry. It is driven by the SocketDispatcher and reports events via the
+    /// BufferContainer just like Socket does, but each packet is sent as one datagram and each
+    /// received datagram must contain exactly one packet; a datagram that doesn't is dropped.
+    /// On Linux several datagrams are moved per system call using recvmmsg()/sendmmsg().
+    /// As there is no connection, ConnectionStatusEvent only signals that the socket is ready to be used,
+    /// and there is no receive timeout by default since silence is normal for UDP.
+    /// \tparam Protocol The protocol used to assemble packets from received datagrams.
+    template<typename Protocol, typename Packet = typename Protocol::packet_type>
+    class DatagramSocket
+        : public Socket<Protocol, Packet>
+    {
+        public:
+            /// Creates a datagram socket.
+            /// \param buffer_container The buffers and event queues to use.
+            /// \param max_datagram_size The largest datagram that can be received. Larger datagrams are dropped.
+            /// \param receive_timeout Time without any received datagrams after which the socket is closed,
+            /// 0 to disable.
+            /// \param options Tuning options. Options that only apply to TCP are ignored.
+            static std::shared_ptr<DatagramSocket<Protocol>>
+            create(std::weak_ptr<BufferContainer<Protocol>> buffer_container,
+                   std::size_t max_datagram_size = DefaultMaxDatagramSize,
+                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 },
+                   const SocketOptions& options = SocketOptions{});
+
+            bool can_send_file() const override
+            {
+                return false;
+            }
+
+        protected:
+            DatagramSocket(std::weak_ptr<BufferContainer<Protocol>> buffer_container, std::size_t max_datagram_size)
+                    : Socket<Protocol, Packet>(std::move(buffer_container)),
+                      batch(max_datagram_size)
+            {
+            }
+
+            bool create_socket() override;
+
+            void read_data(const std::shared_ptr<BufferContainer<Protocol>>& container) override;
+
+            void write_data(const std::shared_ptr<BufferContainer<Protocol>>& container) override;
+
+        private:
+            void assemble(const std::shared_ptr<BufferContainer<Protocol>>& container, int index);
+
+            /// An ICMP port unreachable from an earlier datagram is reported on the next call;
+            /// the peer may simply not be listening yet so that is not a reason to close the socket.
+            static bool is_transient_error(int error)
+            {
+                return error == EWOULDBLOCK || error == ECONNREFUSED;
+            }
+
+            DatagramBatch batch;
+    };
+
+    template<typename Protocol, typename Packet>
+    std::shared_ptr<DatagramSocket<Protocol>> DatagramSocket<Protocol, Packet>::create(
+        std::weak_ptr<BufferContainer<Protocol>> buffer_container,
+        std::size_t max_datagram_size,
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options)
+    {
+        auto s = smooth::core::util::create_protected_shared<DatagramSocket<Protocol, Packet>>(buffer_container,
+                                                                                               max_datagram_size);
+        s->set_send_timeout(DefaultSendTimeout);
+        s->set_receive_timeout(receive_timeout);
+
+        auto udp_options = options;
+        udp_options.no_delay = false;
+        udp_options.keep_alive = false;
+        udp_options.coalesce_writes = false;
+        udp_options.fast_open = 0;
+        s->set_socket_options(udp_options);
+
+        return s;
+    }
+
+    template<typename Protocol, typename Packet>
+    bool DatagramSocket<Protocol, Packet>::create_socket()
+    {
+        bool res = false;
+
+        if (this->socket_id < 0)
+        {
+            this->socket_id = socket(this->ip->get_protocol_family(), SOCK_DGRAM, 0);
+
+            if (this->socket_id == ISocket::INVALID_SOCKET)
+            {
+                this->loge("Failed to create datagram socket");
+            }
+            else
+            {
+                // Socket::internal_start() connect()s the socket which, for UDP, only sets the
+                // default destination and filters incoming datagrams to those from the remote endpoint.
+                res = this->set_non_blocking() && this->apply_socket_options();
+            }
+        }
+        else
+        {
+            res = true;
+        }
+
+        return res;
+    }
+
+    template<typename Protocol, typename Packet>
+    void DatagramSocket<Protocol, Packet>::read_data(const std::shared_ptr<BufferContainer<Protocol>>& container)
+    {
+        auto& rx = container->get_rx_buffer();
+
+        // Each datagram holds one packet so don't take more datagrams than there is room for.
+        auto count = batch.receive(this->socket_id, rx.free_capacity());
+
+        if (count < 0)
+        {
+            if (!is_transient_error(errno))
+            {
+                this->stop("Error during receive");
+            }
+        }
+        else
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                this->counters.add_received(batch.get_length(i));
+                assemble(container, i);
+            }
+        }
+
+        this->elapsed_receive_time.start();
+    }
+
+    template<typename Protocol, typename Packet>
+    void DatagramSocket<Protocol, Packet>::assemble(const std::shared_ptr<BufferContainer<Protocol>>& container,
+                                                    int index)
+    {
+        using namespace smooth::core::logging;
+
+        if (batch.is_truncated(index))
+        {
+            Log::warning("DatagramSocket", "Dropped datagram larger than the max datagram size");
+        }
+        else
+        {
+            auto& rx = container->get_rx_buffer();
+            const uint8_t* data = batch.get_data(index);
+            int remaining = batch.get_length(index);
+            bool complete = false;
+            bool error = false;
+
+            while (!complete && !error && remaining > 0)
+            {
+                auto res = rx.receive([&data, &remaining](uint8_t* write_pos, int wanted_length) {
+                                          auto amount = std::min(wanted_length, remaining);
+                                          memcpy(write_pos, data, static_cast<size_t>(amount));
+                                          data += amount;
+                                          remaining -= amount;
+
+                                          return amount;
+                                      },
+                                      [this, &container, &rx, &complete]() {
+                                          complete = true;
+                                          this->counters.add_packet_received();
+                                          event::DataAvailableEvent<Protocol> d(&rx);
+                                          container->get_data_available()->push(d);
+                                      });
+
+                error = res.assembly_error || res.read_count <= 0;
+            }
+
+            if (!complete)
+            {
+                // Packets never span datagrams, drop what has been received.
+                rx.discard_packet_in_progress();
+                Log::warning("DatagramSocket", "Dropped datagram not holding a complete packet");
+            }
+            else if (remaining > 0)
+            {
+                Log::warning("DatagramSocket", "Dropped {} bytes trailing the packet in a datagram", remaining);
+            }
+        }
+    }
+
+    template<typename Protocol, typename Packet>
+    void DatagramSocket<Protocol, Packet>::write_data(const std::shared_ptr<BufferContainer<Protocol>>& container)
+    {
+        auto& tx = container->get_tx_buffer();
+        auto res = tx.send_batch(batch.get_batch_size(),
+                                 [this](Packet& packet) {
+                                     batch.stage(packet.get_data(), packet.get_send_length());
+                                 },
+                                 [this]() {
+                                     return batch.send(this->socket_id, ISocket::SEND_FLAGS);
+                                 });
+
+        if (res.sent_count > 0)
+        {
+            this->counters.add_sent(batch.get_sent_bytes());
+
+            for (int i = 0; i < res.sent_count; ++i)
+            {
+                this->counters.add_packet_sent();
+            }
+        }
+
+        if (res.sent_count < 0)
+        {
+            // Nothing was sent; on a transient error the packets are retried when the socket is writable again.
+            if (!is_transient_error(errno))
+            {
+                this->stop("Failure during send");
+            }
+        }
+        else if (res.packet_complete)
+        {
+            this->elapsed_send_time.stop_and_zero();
+
+            // Let the application know it may now send more packets.
+            smooth::core::network::event::TransmitBufferEmptyEvent event(this->shared_from_this());
+            container->get_tx_empty()->push(event);
+        }
+        else if (res.sent_count > 0)
+        {
+            // More packets are queued than fit in a batch, the rest is sent when the socket is writable again.
+            this->elapsed_send_time.start();
+        }
+        else
+        {
+            // The socket buffer is full, wait until it becomes writable again.
+            this->counters.add_send_stall();
+            this->elapsed_send_time.start();
+        }
+    }
+}
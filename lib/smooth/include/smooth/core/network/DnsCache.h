@@ -0,0 +1,85 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace smooth::core::network
+{
+    /// A cache of host names resolved into IP addresses, shared by all InetAddress instances so that
+    /// (re)connecting sockets don't repeat the same lookups. As getaddrinfo() doesn't report the TTL of the
+    /// DNS records, entries expire after a configurable time. Failed lookups are also cached, for a shorter time,
+    /// so that reconnect attempts to a host that can't be resolved don't flood the DNS server.
+    /// Thread-safe.
+    class DnsCache
+    {
+        public:
+            static DnsCache& instance();
+
+            /// Sets the time entries are kept.
+            /// \param ttl Time a successful lookup is kept.
+            /// \param negative_ttl Time a failed lookup is kept.
+            void set_ttl(std::chrono::seconds ttl, std::chrono::seconds negative_ttl);
+
+            /// Looks up a host.
+            /// \param host The host name
+            /// \param resolved_ip Assigned the IP address of the host, or an empty string if the host
+            /// could not be resolved at the time of the lookup.
+            /// \return true if an entry, that has not expired, was found.
+            bool get(const std::string& host, std::string& resolved_ip);
+
+            /// Adds, or replaces, an entry.
+            /// \param host The host name
+            /// \param resolved_ip The IP address of the host, or an empty string if the lookup failed.
+            void put(const std::string& host, const std::string& resolved_ip);
+
+            /// Removes the entry for a host, forcing the next resolution to perform a lookup.
+            void remove(const std::string& host);
+
+            /// Removes expired entries.
+            void purge_expired();
+
+            void clear();
+
+            DnsCache(const DnsCache&) = delete;
+
+            DnsCache& operator=(const DnsCache&) = delete;
+
+        private:
+            DnsCache() = default;
+
+            struct Entry
+            {
+                std::string resolved_ip;
+                std::chrono::steady_clock::time_point expires_at;
+            };
+
+            void purge_expired_internal(std::chrono::steady_clock::time_point now);
+
+            // Keep the cache small, an embedded device rarely talks to more than a handful of hosts.
+            static constexpr std::size_t max_entries = 16;
+
+            std::mutex guard{};
+            std::unordered_map<std::string, Entry> entries{};
+            std::chrono::seconds ttl{ 60 };
+            std::chrono::seconds negative_ttl{ 5 };
+    };
+}
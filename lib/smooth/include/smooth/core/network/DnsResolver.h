@@ -0,0 +1,90 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include "smooth/core/Task.h"
+#include "smooth/core/ipc/TaskEventQueue.h"
+#include "smooth/core/network/InetAddress.h"
+#include "smooth/core/network/event/DnsResolvedEvent.h"
+
+namespace smooth::core::network
+{
+    /// A request to resolve an address, see DnsResolver.
+    class DnsRequest
+    {
+        public:
+            using ResponseQueue = smooth::core::ipc::TaskEventQueue<event::DnsResolvedEvent>;
+
+            DnsRequest() = default;
+
+            DnsRequest(std::shared_ptr<InetAddress> address, std::weak_ptr<ResponseQueue> response_queue)
+                    : address(std::move(address)),
+                      response_queue(std::move(response_queue))
+            {
+            }
+
+            [[nodiscard]] const std::shared_ptr<InetAddress>& get_address() const
+            {
+                return address;
+            }
+
+            [[nodiscard]] const std::weak_ptr<ResponseQueue>& get_response_queue() const
+            {
+                return response_queue;
+            }
+
+        private:
+            std::shared_ptr<InetAddress> address{};
+            std::weak_ptr<ResponseQueue> response_queue{};
+    };
+
+    /// The DnsResolver performs name lookups, which may block for several seconds, on its own task
+    /// so that neither the application tasks nor the SocketDispatcher are stalled while waiting
+    /// for the DNS server. Results are stored in the DnsCache and delivered via a TaskEventQueue.
+    class DnsResolver
+        : private smooth::core::Task,
+        public smooth::core::ipc::IEventListener<DnsRequest>
+    {
+        public:
+            using ResponseQueue = DnsRequest::ResponseQueue;
+
+            static DnsResolver& instance();
+
+            /// Resolves an address. Requests are handled in order, so multiple requests
+            /// for the same host result in a single lookup. The lookup is done on a copy of the address,
+            /// the result is applied by the receiver of the DnsResolvedEvent.
+            /// \param address The address to resolve.
+            /// \param response_queue The queue onto which a DnsResolvedEvent is put once done.
+            /// \return true if the request was queued, false if the queue is full in which case no
+            /// DnsResolvedEvent will be sent.
+            [[nodiscard]] bool resolve(std::shared_ptr<InetAddress> address,
+                                       std::weak_ptr<ResponseQueue> response_queue);
+
+            void event(const DnsRequest& request) override;
+
+        protected:
+            void tick() override;
+
+        private:
+            DnsResolver();
+
+            using RequestQueue = smooth::core::ipc::TaskEventQueue<DnsRequest>;
+            std::shared_ptr<RequestQueue> requests;
+    };
+}
@@ -0,0 +1,80 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "smooth/core/filesystem/FSLock.h"
+#include "smooth/core/filesystem/Path.h"
+
+namespace smooth::core::network
+{
+    /// A region of an open file which a socket sends straight from the file system, without copying
+    /// it through the application, using sendfile(). Only available on Linux, see is_supported().
+    /// The file is kept open, and counted by FSLock, until the last reference to the region is released.
+    class FileRegion
+    {
+        public:
+            /// Opens a file region.
+            /// \param path The file to open
+            /// \param offset Offset of the region, in bytes from the start of the file.
+            /// \param length Length of the region, in bytes.
+            /// \return The region, or nullptr if the file could not be opened.
+            static std::shared_ptr<FileRegion> open(const smooth::core::filesystem::Path& path,
+                                                    std::size_t offset,
+                                                    std::size_t length);
+
+            /// Returns a value indicating if file regions can be sent on the current platform.
+            static constexpr bool is_supported()
+            {
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+                return true;
+#else
+                return false;
+#endif
+            }
+
+            ~FileRegion();
+
+            FileRegion(const FileRegion&) = delete;
+
+            FileRegion& operator=(const FileRegion&) = delete;
+
+            [[nodiscard]] std::size_t get_length() const
+            {
+                return length;
+            }
+
+            /// Sends part of the region to a socket.
+            /// \param socket_id The socket to send to.
+            /// \param already_sent Number of bytes of the region already sent.
+            /// \param max_amount Maximum number of bytes to send.
+            /// \return Number of bytes sent, 0 if the socket can't accept more data right now or -1 on error,
+            /// including when the file ends before the region does.
+            int send_to(int socket_id, std::size_t already_sent, std::size_t max_amount) const;
+
+        protected:
+            FileRegion(const smooth::core::filesystem::Path& path, std::size_t offset, std::size_t length);
+
+        private:
+            smooth::core::filesystem::FSLock fs_lock{};
+            int fd = -1;
+            std::size_t offset;
+            std::size_t length;
+    };
+}
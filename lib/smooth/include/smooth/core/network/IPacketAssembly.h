@@ -64,6 +64,26 @@ namespace smooth::core::network
             /// Resets the protocol
             virtual void reset() = 0;
 
+            /// Copies data that was received beyond the end of the previous packet, such as the start of a
+            /// pipelined request, to the current packet. While there is such data it is used instead of
+            /// reading from the socket. Protocols that never receive more than a packet needs don't override this.
+            /// \param target The write position, as returned by get_write_pos().
+            /// \param max_length The maximum number of bytes to copy, as returned by get_wanted_amount().
+            /// \return The number of bytes copied.
+            virtual int read_buffered(uint8_t* target, int max_length)
+            {
+                (void)target;
+                (void)max_length;
+
+                return 0;
+            }
+
+            /// Must return true while read_buffered() has data to copy.
+            virtual bool has_buffered_data() const
+            {
+                return false;
+            }
+
             virtual ~IPacketAssembly() = default;
     };
 }
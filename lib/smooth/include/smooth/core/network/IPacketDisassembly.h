@@ -21,6 +21,8 @@ limitations under the License.
 
 namespace smooth::core::network
 {
+    class FileRegion;
+
     /// Interface for packets that can be disassembled into a series of bytes
     class IPacketDisassembly
     {
@@ -33,6 +35,14 @@ namespace smooth::core::network
             /// \return The read position
             virtual const uint8_t* get_data() = 0;
 
+            /// May return a file region to be sent after the data returned by get_data(). Only sockets
+            /// for which ISocket::can_send_file() returns true are able to send such packets.
+            /// \return The file region, or nullptr if there is none.
+            virtual const FileRegion* get_file_region()
+            {
+                return nullptr;
+            }
+
             virtual ~IPacketDisassembly() = default;
     };
 }
@@ -54,6 +54,20 @@ namespace smooth::core::network
             uint8_t* write_pos = nullptr;
     };
 
+    /// The outcome of a receive operation performed in a single locked step, see PacketReceiveBuffer::receive().
+    struct ReceiveResult
+    {
+        /// The value returned by the reader, i.e. number of bytes read, 0 on close or < 0 on error.
+        int read_count = 0;
+
+        /// true if the protocol reported an assembly error; the packet in progress has been discarded.
+        bool assembly_error = false;
+
+        /// true if the data was buffered by the protocol, see IPacketAssembly::read_buffered(), so the reader
+        /// wasn't called.
+        bool buffered = false;
+    };
+
     /// Interface for packet receive buffers
     template<typename Protocol, typename Packet = typename Protocol::packet_type>
     class IPacketReceiveBuffer
@@ -99,5 +113,9 @@ namespace smooth::core::network
             /// Returns a value indicating if an error has occurred during packet assembly, e.g. framing error.
             /// Normally this means that the connection should be closed and reconnected.
             virtual bool is_error() = 0;
+
+            /// Returns a value indicating if the protocol holds received data for packets yet to be assembled,
+            /// i.e. if the next receive can be done without reading from the socket.
+            virtual bool has_buffered_data() = 0;
     };
 }
@@ -21,6 +21,29 @@ limitations under the License.
 
 namespace smooth::core::network
 {
+    /// The outcome of a send operation performed in a single locked step, see PacketSendBuffer::send().
+    struct SendResult
+    {
+        /// The value returned by the writer, i.e. number of bytes sent or < 0 on error.
+        int sent_count = 0;
+
+        /// true if the current packet has been completely sent.
+        bool packet_complete = false;
+    };
+
+    /// The result of a coalesced send operation, see PacketSendBuffer::send_coalesced().
+    struct CoalescedSendResult
+    {
+        /// The value returned by the writer, i.e. number of bytes sent or < 0 on error.
+        int sent_count = 0;
+
+        /// The number of bytes handed to the writer.
+        int write_length = 0;
+
+        /// The number of packets that have been completely sent.
+        int packets_completed = 0;
+    };
+
     /// Interface for packet send buffers
     /// \tparam Packet
     template<typename Protocol, typename Packet = typename Protocol::packet_type>
@@ -58,5 +81,9 @@ namespace smooth::core::network
             /// Returns an item indicating if the buffer is empty.
             /// \return true or false.
             virtual bool is_empty() = 0;
+
+            /// Returns a value indicating if the buffer is full, i.e. if put() would fail.
+            /// \return true or false.
+            virtual bool is_full() = 0;
     };
 }
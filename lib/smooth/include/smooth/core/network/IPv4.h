@@ -37,8 +37,19 @@ namespace smooth::core::network
 
             explicit IPv4(const sockaddr_in& addr);
 
+            IPv4(const IPv4&) = default;
+
+            std::unique_ptr<InetAddress> clone() const override
+            {
+                return std::make_unique<IPv4>(*this);
+            }
+
+            using InetAddress::assign;
+
             bool resolve_ip() override;
 
+            bool resolve_ip_cached() override;
+
             sockaddr* get_socket_address() override;
 
             socklen_t get_socket_address_length() const override;
@@ -49,6 +60,8 @@ namespace smooth::core::network
             }
 
         private:
+            void assign(const std::string& ip);
+
             sockaddr_in sock_address;
             static std::regex const numeric_ip;
     };
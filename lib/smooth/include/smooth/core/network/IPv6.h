@@ -41,6 +41,13 @@ namespace smooth::core::network
 
             explicit IPv6(const sockaddr_in6& address);
 
+            IPv6(const IPv6&) = default;
+
+            std::unique_ptr<InetAddress> clone() const override
+            {
+                return std::make_unique<IPv6>(*this);
+            }
+
             sockaddr* get_socket_address() override;
 
             socklen_t get_socket_address_length() const override;
@@ -20,6 +20,7 @@ limitations under the License.
 #include <memory>
 #include <chrono>
 #include "InetAddress.h"
+#include "SocketStatistics.h"
 
 namespace smooth::core::network
 {
@@ -48,6 +49,8 @@ namespace smooth::core::network
             /// Initiates the connection to the provided IP. After this call events will arrive
             /// via the response methods for data available, TX buffer empty, connection status etc.
             /// \param ip The address to connect to (an instance of either IPv4 or IPv6).
+            /// If the host name has to be looked up, the lookup is performed by the DnsResolver and the socket
+            /// is started once it completes; if the lookup fails a disconnected ConnectionStatusEvent is sent.
             /// \return true if the socket could be started and connection attempt initiated (but possibly not succeeded
             // or yet completed)
             virtual bool start(std::shared_ptr<InetAddress> ip) = 0;
@@ -88,7 +91,17 @@ namespace smooth::core::network
 
             [[nodiscard]] virtual std::chrono::milliseconds get_send_timeout() const = 0;
 
+            /// Returns a value indicating if the socket is able to send packets carrying a file region,
+            /// see IPacketDisassembly::get_file_region().
+            [[nodiscard]] virtual bool can_send_file() const = 0;
+
+            /// Returns a snapshot of the I/O counters of the socket.
+            [[nodiscard]] virtual SocketStats get_statistics() const = 0;
+
         protected:
+            /// Gives access to the live I/O counters of the socket.
+            virtual SocketCounters& get_counters() = 0;
+
             [[nodiscard]] virtual bool is_connected() const = 0;
 
             virtual void readable(ISocketBackOff& ops) = 0;
@@ -97,6 +110,15 @@ namespace smooth::core::network
 
             [[nodiscard]] virtual bool has_data_to_transmit() = 0;
 
+            /// Returns a value indicating if the socket can accept more incoming data. While false, the
+            /// socket dispatcher stops reading from the socket, leaving the data in the network stack.
+            [[nodiscard]] virtual bool has_receive_capacity() = 0;
+
+            /// Returns a value indicating if the socket holds received data that has not yet been
+            /// handed to the application, which select() can't know about, e.g. data buffered by a TLS layer.
+            /// The socket dispatcher calls readable() for such sockets without waiting for the network.
+            [[nodiscard]] virtual bool has_buffered_data() = 0;
+
             [[nodiscard]] virtual bool internal_start() = 0;
 
             virtual void publish_connected_status() = 0;
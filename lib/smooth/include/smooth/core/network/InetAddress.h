@@ -21,6 +21,7 @@ limitations under the License.
 #pragma GCC diagnostic ignored "-Wsign-conversion"
 #include <sys/socket.h>
 #pragma GCC diagnostic pop
+#include <memory>
 #include <string>
 #include <cstring>
 
@@ -38,11 +39,43 @@ namespace smooth::core::network
             {
             }
 
+            InetAddress(const InetAddress&) = default;
+
             virtual ~InetAddress() = default;
 
-            // Performs name resolution
+            /// Creates a copy of the address, e.g. so that it can be resolved on another task without
+            /// touching an address that is in use.
+            /// \return The copy
+            virtual std::unique_ptr<InetAddress> clone() const = 0;
+
+            /// Takes the result of the resolution of a copy of this address, see clone().
+            /// \param resolved The resolved copy.
+            void assign(InetAddress& resolved)
+            {
+                valid = resolved.valid && resolved.get_socket_address_length() == get_socket_address_length();
+                resolved_ip = resolved.resolved_ip;
+
+                if (valid)
+                {
+                    memcpy(get_socket_address(), resolved.get_socket_address(), get_socket_address_length());
+                }
+            }
+
+            /// Performs name resolution, blocking while a lookup is performed if the result isn't cached.
+            /// \return true if the address is valid.
             virtual bool resolve_ip() = 0;
 
+            /// Performs name resolution without blocking, i.e. only succeeds if no lookup is needed.
+            /// Implementations whose resolve_ip() never blocks may rely on the default implementation.
+            /// \return true if resolution is complete, see is_valid() for the outcome. false if a lookup is
+            /// required, see resolve_ip() and DnsResolver.
+            virtual bool resolve_ip_cached()
+            {
+                resolve_ip();
+
+                return true;
+            }
+
             /// Gets the address family, e.g. AF_INET or AF_INET6
             /// \return The adress family
             virtual int get_address_family() const = 0;
@@ -17,18 +17,57 @@ limitations under the License.
 
 #pragma once
 
+#include <chrono>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <mbedtls/net_sockets.h>
 #include <mbedtls/ssl.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/ssl_ticket.h>
 #include <mbedtls/entropy.h>
 #include <mbedtls/ctr_drbg.h>
 #include <mbedtls/debug.h>
+#include "smooth/core/network/MbedTLSShared.h"
 
 namespace smooth::core::network
 {
     void log_mbedtls_error(const char* log_tag, const char* prefix, int err_code) noexcept;
 
+    /// Holds the session of the last completed handshake of a client, so that the next connection
+    /// can resume it instead of running a full handshake. Thread-safe.
+    class ClientSessionCache
+    {
+        public:
+            ClientSessionCache()
+            {
+                mbedtls_ssl_session_init(&session);
+            }
+
+            ~ClientSessionCache()
+            {
+                mbedtls_ssl_session_free(&session);
+            }
+
+            ClientSessionCache(const ClientSessionCache&) = delete;
+
+            ClientSessionCache& operator=(const ClientSessionCache&) = delete;
+
+            /// Stores the session of a context that has completed its handshake.
+            void save(const mbedtls_ssl_context* ssl);
+
+            /// Offers the stored session, if any, to a context that has not yet started its handshake.
+            void apply(mbedtls_ssl_context* ssl);
+
+            /// Forgets the stored session.
+            void clear();
+
+        private:
+            std::mutex guard{};
+            mbedtls_ssl_session session{};
+            bool valid = false;
+    };
+
     class SSLContext
     {
         public:
@@ -42,6 +81,31 @@ namespace smooth::core::network
                 mbedtls_ssl_free(&ssl);
             }
 
+            /// Sets the cache the session is saved to once the handshake completes.
+            void set_session_cache(std::shared_ptr<ClientSessionCache> cache)
+            {
+                session_cache = std::move(cache);
+            }
+
+            /// Called by the owning socket when the handshake has completed.
+            void handshake_completed()
+            {
+                if (session_cache)
+                {
+                    session_cache->save(&ssl);
+                }
+            }
+
+            /// Called by the owning socket when the handshake has failed, so that
+            /// a session the server no longer accepts isn't offered again.
+            void handshake_failed()
+            {
+                if (session_cache)
+                {
+                    session_cache->clear();
+                }
+            }
+
             operator mbedtls_ssl_context*()
             {
                 return &ssl;
@@ -54,8 +118,12 @@ namespace smooth::core::network
 
         private:
             mbedtls_ssl_context ssl{};
+            std::shared_ptr<ClientSessionCache> session_cache{};
     };
 
+    /// TLS configuration shared by all connections created from it, i.e. all clients of a server socket.
+    /// Certificates, keys and the random generator are in turn shared with other contexts, so
+    /// setting up a connection only costs the allocation of its SSLContext.
     class MBedTLSContext
     {
         public:
@@ -70,19 +138,35 @@ namespace smooth::core::network
                              const std::vector<unsigned char>& private_key,
                              const std::vector<unsigned char>& password);
 
+            /// Enables client side session resumption. The session of the last completed handshake
+            /// is offered by contexts created afterwards, letting the server skip the key exchange
+            /// on reconnect. Call after init_client().
+            void enable_client_session_cache();
+
+            /// Enables server side session resumption, using a session cache and, optionally, session tickets.
+            /// Call after init_server().
+            /// \param max_entries The maximum number of sessions held in the cache.
+            /// \param lifetime How long a cached session or a session ticket remains valid.
+            /// \param use_tickets If true, clients are handed an encrypted session ticket they can resume with,
+            /// even after their session has been evicted from the cache.
+            /// \return true on success, false on failure.
+            bool enable_server_session_cache(int max_entries, std::chrono::seconds lifetime, bool use_tickets);
+
             std::unique_ptr<SSLContext> create_context();
 
         private:
-            int common_init(bool server);
-
-            int load_certificate(const std::vector<unsigned char>& cert, mbedtls_x509_crt& target);
+            bool common_init(bool server);
 
-            mbedtls_entropy_context entropy{};
-            mbedtls_ctr_drbg_context ctr_drbg{};
             mbedtls_ssl_config conf{};
-            mbedtls_x509_crt ca_cert{};
-            mbedtls_x509_crt ca_chain{};
-            mbedtls_x509_crt server_cert{};
-            mbedtls_pk_context pk_key{};
+            std::shared_ptr<SharedCertificate> ca_cert{};
+            std::shared_ptr<SharedCertificate> server_cert{};
+            std::shared_ptr<SharedPrivateKey> pk_key{};
+#ifdef MBEDTLS_SSL_CACHE_C
+            mbedtls_ssl_cache_context server_sessions{};
+#endif
+#ifdef MBEDTLS_SSL_TICKET_C
+            mbedtls_ssl_ticket_context ticket_keys{};
+#endif
+            std::shared_ptr<ClientSessionCache> client_sessions{};
     };
 }
@@ -0,0 +1,110 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/x509_crt.h>
+#include <mbedtls/pk.h>
+
+namespace smooth::core::network
+{
+    /// Process-wide random number generator for TLS, seeded once on first use instead of once per
+    /// MBedTLSContext. Thread-safe.
+    class SharedRandom
+    {
+        public:
+            /// Returns a value indicating if the generator could be seeded.
+            static bool is_ready();
+
+            /// Random number function, compatible with mbedtls_ssl_conf_rng() and friends.
+            /// The context argument is unused.
+            static int random(void* ctx, unsigned char* output, size_t len);
+
+        private:
+            SharedRandom();
+
+            ~SharedRandom();
+
+            static SharedRandom& instance();
+
+            std::mutex guard{};
+            mbedtls_entropy_context entropy{};
+            mbedtls_ctr_drbg_context ctr_drbg{};
+            bool seeded = false;
+    };
+
+    /// A parsed certificate (chain), shared between all contexts that load the same data so that it
+    /// is only parsed, and held in memory, once. Read-only once parsed.
+    class SharedCertificate
+    {
+        public:
+            /// Gets the parsed certificate for the given data, parsing it if no other context holds it.
+            /// \param data PEM or DER data. PEM data must include the terminating 0.
+            /// \return The certificate, or nullptr if the data could not be parsed.
+            static std::shared_ptr<SharedCertificate> get(const std::vector<unsigned char>& data);
+
+            SharedCertificate();
+
+            ~SharedCertificate();
+
+            SharedCertificate(const SharedCertificate&) = delete;
+
+            SharedCertificate& operator=(const SharedCertificate&) = delete;
+
+            mbedtls_x509_crt* get_crt()
+            {
+                return &crt;
+            }
+
+        private:
+            mbedtls_x509_crt crt{};
+    };
+
+    /// A parsed private key, shared in the same way as SharedCertificate.
+    /// Private key operations on a shared key rely on MBEDTLS_THREADING_C when used from several tasks.
+    class SharedPrivateKey
+    {
+        public:
+            /// Gets the parsed key for the given data, parsing it if no other context holds it.
+            /// \param data PEM or DER data. PEM data must include the terminating 0.
+            /// \param password Password of the key, empty if not encrypted.
+            /// \return The key, or nullptr if the data could not be parsed.
+            static std::shared_ptr<SharedPrivateKey> get(const std::vector<unsigned char>& data,
+                                                         const std::vector<unsigned char>& password);
+
+            SharedPrivateKey();
+
+            ~SharedPrivateKey();
+
+            SharedPrivateKey(const SharedPrivateKey&) = delete;
+
+            SharedPrivateKey& operator=(const SharedPrivateKey&) = delete;
+
+            mbedtls_pk_context* get_pk()
+            {
+                return &pk;
+            }
+
+        private:
+            mbedtls_pk_context pk{};
+    };
+}
@@ -19,26 +19,28 @@ limitations under the License.
 
 #include <mutex>
 #include <memory>
-#include "smooth/core/util/CircularBuffer.h"
+#include "smooth/core/util/AdaptiveBuffer.h"
 #include "IPacketReceiveBuffer.h"
+#include "BufferDepth.h"
 
 namespace smooth::core::network
 {
-    /// PacketReceiveBuffer is a buffer that can hold Size items of type Packet
-    /// and helps with assembling of data packets.
+    /// PacketReceiveBuffer is a buffer that can hold a runtime configurable number of items of type Packet
+    /// and helps with assembling of data packets. Completed packets are never overwritten; callers must
+    /// check is_full() before receiving more data.
     /// Packet must provide the IPacketAssembly interface (either directly or via inheritance)
     /// and fulfill the following contract:
     /// * Default constructable
     /// * Must be copyable
     /// \tparam Packet The type of packet to assemble
-    /// \tparam Size  The Number of items to hold in the buffer.
-    template<typename Protocol, int Size, typename Packet = typename Protocol::packet_type>
+    template<typename Protocol, typename Packet = typename Protocol::packet_type>
     class PacketReceiveBuffer
         : public IPacketReceiveBuffer<Protocol>
     {
         public:
-            explicit PacketReceiveBuffer(std::unique_ptr<Protocol> proto)
-                    : proto(std::move(proto))
+            explicit PacketReceiveBuffer(std::unique_ptr<Protocol> proto, BufferDepth depth = BufferDepth{})
+                    : proto(std::move(proto)),
+                      buffer(depth.initial, depth.max)
             {
             }
 
@@ -67,13 +69,54 @@ namespace smooth::core::network
             void data_received(int length) override
             {
                 std::unique_lock<std::mutex> lock(guard);
-                proto->data_received(current_item, length);
+                data_received_internal(length);
+            }
+
+            /// Performs an entire receive operation while only taking the lock once. This replaces the
+            /// sequence amount_wanted(), get_write_pos(), data_received(), is_error(), is_packet_complete()
+            /// and prepare_new_packet() that otherwise is needed for each read from the socket.
+            /// \param reader Callable as int(uint8_t* write_pos, int wanted_length). Must write at most
+            /// wanted_length bytes to write_pos and return the number of bytes written, 0 if the
+            /// connection has been closed or < 0 on error, i.e. the same semantics as recv().
+            /// \param on_complete Callable as void(), called when the current packet is complete, just before a
+            /// new packet is prepared. It is called while the lock is held so it must not call back into the buffer.
+            /// \return The result of the receive operation. If the protocol has buffered data, that is used and
+            /// reader isn't called.
+            template<typename Reader, typename OnComplete>
+            ReceiveResult receive(Reader&& reader, OnComplete&& on_complete)
+            {
+                std::unique_lock<std::mutex> lock(guard);
+                ReceiveResult res{};
+
+                auto wanted_length = proto->get_wanted_amount(current_item);
+                auto* write_pos = proto->get_write_pos(current_item);
 
-                if (proto->is_complete(current_item))
+                // Use data the protocol already has before reading more.
+                res.read_count = proto->read_buffered(write_pos, wanted_length);
+                res.buffered = res.read_count > 0;
+
+                if (!res.buffered)
                 {
-                    buffer.put(current_item);
-                    in_progress = false;
+                    res.read_count = reader(write_pos, wanted_length);
+                }
+
+                if (res.read_count > 0)
+                {
+                    data_received_internal(res.read_count);
+
+                    if (proto->is_error())
+                    {
+                        res.assembly_error = true;
+                        prepare_new_packet_internal();
+                    }
+                    else if (proto->is_complete(current_item))
+                    {
+                        on_complete();
+                        prepare_new_packet_internal();
+                    }
                 }
+
+                return res;
             }
 
             bool is_packet_complete() override
@@ -111,12 +154,28 @@ namespace smooth::core::network
                 return in_progress;
             }
 
-            void prepare_new_packet() override
+            /// Discards the data received for the packet currently being assembled, and resets the protocol.
+            /// Completed packets are kept.
+            void discard_packet_in_progress()
             {
                 std::unique_lock<std::mutex> lock(guard);
+                in_progress = false;
                 ReplacePacketWithDefault();
-                in_progress = true;
-                proto->packet_consumed();
+                proto->reset();
+            }
+
+            /// Returns the number of completed packets the buffer can accept before it is full.
+            int free_capacity()
+            {
+                std::unique_lock<std::mutex> lock(guard);
+
+                return buffer.get_max_depth() - buffer.available_items();
+            }
+
+            void prepare_new_packet() override
+            {
+                std::unique_lock<std::mutex> lock(guard);
+                prepare_new_packet_internal();
             }
 
             bool is_error() override
@@ -126,11 +185,32 @@ namespace smooth::core::network
                 return proto->is_error();
             }
 
+            bool has_buffered_data() override
+            {
+                std::unique_lock<std::mutex> lock(guard);
+
+                return proto->has_buffered_data();
+            }
+
             Protocol& get_proto() const
             {
                 return *proto;
             }
 
+            /// Returns the current depth of the buffer, i.e. the number of packets it can hold before it has to grow.
+            int get_depth()
+            {
+                std::unique_lock<std::mutex> lock(guard);
+
+                return buffer.get_depth();
+            }
+
+            void set_depth(BufferDepth depth)
+            {
+                std::unique_lock<std::mutex> lock(guard);
+                buffer.set_depth(depth.initial, depth.max);
+            }
+
         private:
             void ReplacePacketWithDefault()
             {
@@ -138,10 +218,30 @@ namespace smooth::core::network
                 new(&current_item) Packet();
             }
 
+            void data_received_internal(int length)
+            {
+                proto->data_received(current_item, length);
+
+                // A packet the protocol failed to assemble is never handed to the application.
+                if (!proto->is_error() && proto->is_complete(current_item))
+                {
+                    // The socket stops reading while is_full() returns true so there is always room here.
+                    buffer.put(current_item);
+                    in_progress = false;
+                }
+            }
+
+            void prepare_new_packet_internal()
+            {
+                ReplacePacketWithDefault();
+                in_progress = true;
+                proto->packet_consumed();
+            }
+
             std::mutex guard{};
             bool in_progress = false;
             Packet current_item{};
             std::unique_ptr<Protocol> proto;
-            smooth::core::util::CircularBuffer<Packet, Size> buffer{};
+            smooth::core::util::AdaptiveBuffer<Packet> buffer;
     };
 }
@@ -17,13 +17,17 @@ limitations under the License.
 
 #pragma once
 
-#include "smooth/core/util/CircularBuffer.h"
+#include "smooth/core/util/AdaptiveBuffer.h"
 #include "IPacketSendBuffer.h"
+#include "BufferDepth.h"
+#include "FileRegion.h"
+#include <algorithm>
 #include <mutex>
+#include <vector>
 
 namespace smooth::core::network
 {
-    /// PacketSendBuffer is a buffer that can hold Size packets of type T, with
+    /// PacketSendBuffer is a buffer that can hold a runtime configurable number of packets of type T, with
     /// byte access to each individual element which makes it easy to perform
     /// send() operations directly on each packet.
     /// T must provide the IPacketDisassembly interface (either directly or via inheritance) and fulfill the following
@@ -31,23 +35,21 @@ namespace smooth::core::network
     /// * Default constructable
     /// * Must be copyable
     /// \tparam Packet The packet type
-    /// \tparam Size Number of items to hold in the buffer
-    template<typename Protocol, int Size, typename Packet = typename Protocol::packet_type>
+    template<typename Protocol, typename Packet = typename Protocol::packet_type>
     class PacketSendBuffer
         : public IPacketSendBuffer<Protocol>
     {
         public:
-            bool put(const Packet& item)
+            explicit PacketSendBuffer(BufferDepth depth = BufferDepth{})
+                    : buffer(depth.initial, depth.max)
             {
-                std::lock_guard<std::mutex> lock(guard);
-                bool res = !buffer.is_full();
+            }
 
-                if (res)
-                {
-                    buffer.put(item);
-                }
+            bool put(const Packet& item) override
+            {
+                std::lock_guard<std::mutex> lock(guard);
 
-                return res;
+                return buffer.put(item);
             }
 
             bool is_in_progress() override
@@ -68,31 +70,207 @@ namespace smooth::core::network
             {
                 std::lock_guard<std::mutex> lock(guard);
 
-                return current_item.get_send_length() - bytes_sent;
+                return remaining_data_length();
             }
 
             void data_has_been_sent(int length) override
             {
                 std::lock_guard<std::mutex> lock(guard);
-                bytes_sent += length;
+                data_has_been_sent_internal(static_cast<std::size_t>(std::max(0, length)));
+            }
+
+            void prepare_next_packet() override
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                prepare_next_packet_internal();
+            }
+
+            /// Makes sure a packet is in progress, preparing the next one if needed, while only taking the lock once.
+            /// \return true if there is a packet in progress, false if there is nothing to send.
+            bool prepare_next_packet_if_idle()
+            {
+                std::lock_guard<std::mutex> lock(guard);
 
-                if (bytes_sent >= current_item.get_send_length())
+                if (!in_progress)
                 {
-                    in_progress = false;
+                    prepare_next_packet_internal();
                 }
+
+                return in_progress;
             }
 
-            void prepare_next_packet() override
+            /// Performs an entire send operation on the current packet while only taking the lock once. This replaces
+            /// the sequence get_data_to_send(), get_remaining_data_length(), data_has_been_sent() and is_in_progress()
+            /// that otherwise is needed for each write to the socket.
+            /// \param writer Callable as int(const uint8_t* data, int length, bool more_follows), returning the number
+            /// of bytes sent or < 0 on error, i.e. the same semantics as send(). more_follows is true when a file region
+            /// or further packets are queued after the data. It is called while the lock is held so it must not
+            /// call back into the buffer.
+            /// \param file_writer Callable as int(const FileRegion& file, std::size_t already_sent, std::size_t length),
+            /// with the same semantics as writer. Called instead of writer once the data of a packet carrying a file
+            /// region has been sent.
+            /// \return The result of the send operation.
+            template<typename Writer, typename FileWriter>
+            SendResult send(Writer&& writer, FileWriter&& file_writer)
             {
                 std::lock_guard<std::mutex> lock(guard);
-                in_progress = buffer.get(current_item);
-                bytes_sent = 0;
+                SendResult res{};
+
+                const auto data_length = send_length();
+                const auto* file = current_item.get_file_region();
+
+                if (file && bytes_sent >= data_length)
+                {
+                    const auto file_sent = bytes_sent - data_length;
+                    res.sent_count = file_writer(*file, file_sent, file->get_length() - file_sent);
+                }
+                else
+                {
+                    res.sent_count = writer(current_item.get_data() + bytes_sent,
+                                            remaining_data_length(),
+                                            file != nullptr || !buffer.is_empty());
+                }
+
+                if (res.sent_count > 0)
+                {
+                    data_has_been_sent_internal(static_cast<std::size_t>(res.sent_count));
+                }
+
+                res.packet_complete = !in_progress;
+
+                return res;
+            }
+
+            /// As send(writer, file_writer), for sockets that can't send file regions.
+            template<typename Writer>
+            SendResult send(Writer&& writer)
+            {
+                return send(std::forward<Writer>(writer),
+                            [](const FileRegion&, std::size_t, std::size_t) {
+                                return -1;
+                            });
+            }
+
+            /// Sends several whole packets at once while only taking the lock once, e.g. one datagram per packet.
+            /// Packets are never partially sent so this must not be mixed with send() on the same buffer.
+            /// \param max_count Maximum number of packets to send.
+            /// \param stage Callable as void(Packet& packet), called for each packet to send, oldest first.
+            /// \param flush Callable as int(), sending the staged packets and returning the number of packets
+            /// sent, or < 0 on error. Packets not sent remain in the buffer.
+            /// Both are called while the lock is held so they must not call back into the buffer.
+            /// \return The result of the send operation, sent_count being the number of packets sent and
+            /// packet_complete set when they were the last ones in the buffer.
+            template<typename Stage, typename Flush>
+            SendResult send_batch(int max_count, Stage&& stage, Flush&& flush)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                SendResult res{};
+                int count = 0;
+
+                if (in_progress)
+                {
+                    stage(current_item);
+                    ++count;
+                }
+
+                for (int i = 0; count < max_count && i < buffer.available_items(); ++i, ++count)
+                {
+                    stage(buffer.peek(i));
+                }
+
+                if (count > 0)
+                {
+                    res.sent_count = flush();
+
+                    if (res.sent_count > 0)
+                    {
+                        auto from_buffer = res.sent_count;
+
+                        if (in_progress)
+                        {
+                            in_progress = false;
+                            bytes_sent = 0;
+                            --from_buffer;
+                        }
+
+                        buffer.drop(from_buffer);
+                    }
+                }
+
+                // Only complete once drained, packets beyond max_count may still be waiting.
+                res.packet_complete = res.sent_count > 0 && !in_progress && buffer.is_empty();
+
+                return res;
+            }
+
+            /// Sends the queued data coalesced into writes of up to max_length bytes, while only taking the lock once.
+            /// When the rest of the current packet doesn't fill a write, the following packets are copied into staging
+            /// behind it so that, for example, a small header and the body following it are written together.
+            /// Packets must not carry file regions.
+            /// \param staging Buffer used to gather the data of several packets, owned by the caller.
+            /// \param max_length Maximum number of bytes to hand to the writer.
+            /// \param repeat_length If > 0, exactly this many bytes from the start of the queued data are handed
+            /// to the writer instead, for writers that require a write to be repeated with the same length.
+            /// \param writer Callable as int(const uint8_t* data, int length), returning the number of bytes sent
+            /// or < 0 on error. It is called while the lock is held so it must not call back into the buffer.
+            /// \return The result of the send operation.
+            template<typename Writer>
+            CoalescedSendResult send_coalesced(std::vector<uint8_t>& staging,
+                                               int max_length,
+                                               int repeat_length,
+                                               Writer&& writer)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                CoalescedSendResult res{};
+
+                if (!in_progress)
+                {
+                    prepare_next_packet_internal();
+                }
+
+                if (in_progress)
+                {
+                    const auto wanted = repeat_length > 0 ? repeat_length : max_length;
+                    const auto remaining = remaining_data_length();
+                    const uint8_t* data = current_item.get_data() + bytes_sent;
+
+                    if (remaining >= wanted || buffer.is_empty())
+                    {
+                        // The current packet fills the write on its own, no need to copy it.
+                        res.write_length = std::min(remaining, wanted);
+                    }
+                    else
+                    {
+                        staging.clear();
+                        staging.insert(staging.end(), data, data + remaining);
+
+                        for (int i = 0; i < buffer.available_items() && static_cast<int>(staging.size()) < wanted; ++i)
+                        {
+                            auto& next = buffer.peek(i);
+                            auto amount = std::min(next.get_send_length(), wanted - static_cast<int>(staging.size()));
+                            staging.insert(staging.end(), next.get_data(), next.get_data() + amount);
+                        }
+
+                        data = staging.data();
+                        res.write_length = static_cast<int>(staging.size());
+                    }
+
+                    res.sent_count = writer(data, res.write_length);
+
+                    if (res.sent_count > 0)
+                    {
+                        res.packets_completed = consume_internal(res.sent_count);
+                    }
+                }
+
+                return res;
             }
 
             void clear() override
             {
                 std::lock_guard<std::mutex> lock(guard);
                 buffer.clear();
+                current_item = Packet{};
                 in_progress = false;
                 bytes_sent = 0;
             }
@@ -104,11 +282,92 @@ namespace smooth::core::network
                 return !in_progress && buffer.is_empty();
             }
 
+            bool is_full() override
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return buffer.is_full();
+            }
+
+            /// Returns the current depth of the buffer, i.e. the number of packets it can hold before it has to grow.
+            int get_depth()
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return buffer.get_depth();
+            }
+
+            void set_depth(BufferDepth depth)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                buffer.set_depth(depth.initial, depth.max);
+            }
+
         private:
+            /// The length of the data of the current packet, i.e. excluding any file region.
+            std::size_t send_length()
+            {
+                return static_cast<std::size_t>(std::max(0, current_item.get_send_length()));
+            }
+
+            /// The number of bytes of the data of the current packet not yet sent.
+            int remaining_data_length()
+            {
+                return static_cast<int>(send_length() - std::min(bytes_sent, send_length()));
+            }
+
+            void data_has_been_sent_internal(std::size_t length)
+            {
+                bytes_sent += length;
+
+                const auto* file = current_item.get_file_region();
+                const auto total_length = send_length() + (file ? file->get_length() : 0);
+
+                if (bytes_sent >= total_length)
+                {
+                    in_progress = false;
+
+                    if (file)
+                    {
+                        // Don't keep the file open until the next packet is sent.
+                        current_item = Packet{};
+                    }
+                }
+            }
+
+            /// Marks length bytes as sent, spanning as many packets as needed.
+            /// \return The number of packets completed.
+            int consume_internal(int length)
+            {
+                int completed = 0;
+
+                while (length > 0 && in_progress)
+                {
+                    auto amount = std::min(length, remaining_data_length());
+                    length -= amount;
+                    data_has_been_sent_internal(static_cast<std::size_t>(amount));
+
+                    if (!in_progress)
+                    {
+                        ++completed;
+                        prepare_next_packet_internal();
+                    }
+                }
+
+                return completed;
+            }
+
+            void prepare_next_packet_internal()
+            {
+                in_progress = buffer.get(current_item);
+                bytes_sent = 0;
+            }
+
             Packet current_item{};
             std::mutex guard{};
-            int bytes_sent = 0;
+            /// Bytes of the current packet sent, including those of its file region which may exceed 2 GiB.
+            std::size_t bytes_sent = 0;
             bool in_progress = false;
-            smooth::core::util::CircularBuffer<Packet, Size> buffer{};
+            smooth::core::util::AdaptiveBuffer<Packet> buffer;
     };
 }
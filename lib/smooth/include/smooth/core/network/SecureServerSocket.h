@@ -31,6 +31,19 @@ namespace smooth::core::network
         : public ServerSocket<Client, Protocol, ClientContext>
     {
         public:
+            template<typename... ProtocolArguments>
+            static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
+            create(smooth::core::Task& task,
+                   ClientPoolSize pool_size,
+                   int backlog,
+                   const std::vector<unsigned char>& ca_chain,
+                   const std::vector<unsigned char>& own_cert,
+                   const std::vector<unsigned char>& private_key,
+                   const std::vector<unsigned char>& password,
+                   ProtocolArguments... proto_args);
+
+            /// Creates a secure server socket with a fixed number of clients.
+            /// \param max_client_count The number of clients, i.e. simultaneous connections.
             template<typename... ProtocolArguments>
             static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
             create(smooth::core::Task& task,
@@ -42,30 +55,87 @@ namespace smooth::core::network
                    const std::vector<unsigned char>& password,
                    ProtocolArguments... proto_args);
 
+            /// Creates a secure server socket with tuning options.
+            /// \param options Options applied to the listening socket, and to each accepted socket.
+            template<typename... ProtocolArguments>
+            static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
+            create(smooth::core::Task& task,
+                   ClientPoolSize pool_size,
+                   int backlog,
+                   const SocketOptions& options,
+                   const std::vector<unsigned char>& ca_chain,
+                   const std::vector<unsigned char>& own_cert,
+                   const std::vector<unsigned char>& private_key,
+                   const std::vector<unsigned char>& password,
+                   ProtocolArguments... proto_args);
+
+            ~SecureServerSocket() override
+            {
+                TlsHandshakeWorker::instance().release(this->pool.get_pool_size().max);
+            }
+
         protected:
             template<typename... ProtocolArguments>
             SecureServerSocket(smooth::core::Task& task,
-                               int max_client_count,
+                               ClientPoolSize pool_size,
                                int backlog,
+                               const SocketOptions& options,
                                const std::vector<unsigned char>& ca_chain,
                                const std::vector<unsigned char>& own_cert,
                                const std::vector<unsigned char>& private_key,
                                const std::vector<unsigned char>& password,
                                ProtocolArguments... proto_args)
                     : ServerSocket<Client, Protocol, ClientContext>(task,
-                                                                    max_client_count,
+                                                                    pool_size,
                                                                     backlog,
+                                                                    options,
                                                                     proto_args...)
             {
-                server_context.init_server(ca_chain, own_cert, private_key, password);
+                // Make room for all clients of the pool to be in the middle of a handshake at the same time.
+                TlsHandshakeWorker::instance().reserve(pool_size.max);
+
+                if (server_context.init_server(ca_chain, own_cert, private_key, password))
+                {
+                    // Let returning clients resume their session instead of repeating the full handshake.
+                    server_context.enable_server_session_cache(pool_size.max, session_lifetime, true);
+                }
             }
 
-            void readable(ISocketBackOff& ops) override;
+            void add_client(std::shared_ptr<smooth::core::network::InetAddress> ip,
+                            int accepted_socket_id,
+                            bool configured) override;
 
         private:
+            /// How long a client may resume its session, whether held in the server's cache or in a session ticket.
+            static constexpr std::chrono::seconds session_lifetime{ 3600 };
+
             MBedTLSContext server_context{};
     };
 
+    template<typename Client, typename Protocol, typename ClientContext>
+    template<typename... ProtocolArguments>
+    std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>> SecureServerSocket<Client, Protocol,
+                                                                                      ClientContext>::create(
+        smooth::core::Task& task,
+        ClientPoolSize pool_size,
+        int backlog,
+        const std::vector<unsigned char>& ca_chain,
+        const std::vector<unsigned char>& own_cert,
+        const std::vector<unsigned char>& private_key,
+        const std::vector<unsigned char>& password,
+        ProtocolArguments... proto_args)
+    {
+        return create(task,
+                      pool_size,
+                      backlog,
+                      SocketOptions{},
+                      ca_chain,
+                      own_cert,
+                      private_key,
+                      password,
+                      proto_args...);
+    }
+
     template<typename Client, typename Protocol, typename ClientContext>
     template<typename... ProtocolArguments>
     std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>> SecureServerSocket<Client, Protocol,
@@ -78,11 +148,37 @@ namespace smooth::core::network
         const std::vector<unsigned char>& private_key,
         const std::vector<unsigned char>& password,
         ProtocolArguments... proto_args)
+    {
+        return create(task,
+                      ClientPoolSize{ max_client_count },
+                      backlog,
+                      SocketOptions{},
+                      ca_chain,
+                      own_cert,
+                      private_key,
+                      password,
+                      proto_args...);
+    }
+
+    template<typename Client, typename Protocol, typename ClientContext>
+    template<typename... ProtocolArguments>
+    std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>> SecureServerSocket<Client, Protocol,
+                                                                                      ClientContext>::create(
+        smooth::core::Task& task,
+        ClientPoolSize pool_size,
+        int backlog,
+        const SocketOptions& options,
+        const std::vector<unsigned char>& ca_chain,
+        const std::vector<unsigned char>& own_cert,
+        const std::vector<unsigned char>& private_key,
+        const std::vector<unsigned char>& password,
+        ProtocolArguments... proto_args)
     {
         return smooth::core::util::create_protected_shared<SecureServerSocket<Client, Protocol, ClientContext>>(
                 task,
-                max_client_count,
+                pool_size,
                 backlog,
+                options,
                 ca_chain,
                 own_cert,
                 private_key,
@@ -91,21 +187,22 @@ namespace smooth::core::network
     }
 
     template<typename Client, typename Protocol, typename ClientContext>
-    void SecureServerSocket<Client, Protocol, ClientContext>::readable(ISocketBackOff& ops)
+    void SecureServerSocket<Client, Protocol, ClientContext>::add_client(
+        std::shared_ptr<smooth::core::network::InetAddress> ip,
+        int accepted_socket_id,
+        bool configured)
     {
-        const auto& [ip, accepted_socket_id] = this->accept_request(ops);
-
-        if (ip)
-        {
-            auto client = this->pool.get();
-            auto socket = SecureSocket<Protocol>::create(ip,
-                                                         accepted_socket_id,
-                                                         client->get_buffers(),
-                                                         server_context.create_context(),
-                                                         client->get_send_timeout());
-
-            client->set_client_context(this->client_context);
-            client->set_socket(socket);
-        }
+        auto client = this->pool.get();
+        auto socket = SecureSocket<Protocol>::create(ip,
+                                                     accepted_socket_id,
+                                                     client->get_buffers(),
+                                                     server_context.create_context(),
+                                                     client->get_send_timeout(),
+                                                     std::chrono::milliseconds{ 0 },
+                                                     this->socket_options,
+                                                     configured);
+
+        client->set_client_context(this->client_context);
+        client->set_socket(socket);
     }
 }
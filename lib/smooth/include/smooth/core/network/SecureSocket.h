@@ -17,57 +17,21 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <sys/socket.h>
 #include "Socket.h"
 #include "MbedTLSContext.h"
+#include "TlsHandshakeWorker.h"
+#include "TlsBio.h"
 #include <mbedtls/error.h>
 
 namespace smooth::core::network
 {
-    static int ssl_recv(void* ctx, uint8_t* buf, size_t len)
-    {
-        auto socket = reinterpret_cast<ISocket*>(ctx);
-        errno = 0;
-
-        auto amount_received = socket_cast(recv(socket->get_socket_id(), buf, len, 0));
-
-        if (amount_received < 0)
-        {
-            if (errno == EWOULDBLOCK)
-            {
-                amount_received = MBEDTLS_ERR_SSL_WANT_READ;
-            }
-        }
-
-        return amount_received;
-    }
-
-    static int ssl_send(void* ctx, const uint8_t* buff, size_t len)
-    {
-        auto socket = reinterpret_cast<ISocket*>(ctx);
-        errno = 0;
-
-        int amount_sent = socket_cast(send(socket->get_socket_id(), buff, len, ISocket::SEND_FLAGS));
-
-        if (amount_sent < 0)
-        {
-            if (errno == EWOULDBLOCK)
-            {
-                amount_sent = MBEDTLS_ERR_SSL_WANT_WRITE;
-            }
-        }
-        else if (amount_sent < static_cast<int>(len))
-        {
-            // More data to send
-            amount_sent = MBEDTLS_ERR_SSL_WANT_WRITE;
-        }
-
-        return amount_sent;
-    }
-
     template<typename Protocol, typename Packet = typename Protocol::packet_type>
     class SecureSocket
-        : public Socket<Protocol, Packet>
+        : public Socket<Protocol, Packet>,
+        public ITlsHandshake
     {
         public:
             friend class smooth::core::network::SocketDispatcher;
@@ -76,13 +40,15 @@ namespace smooth::core::network
             /// \param send_timeout The amount of time to wait for outgoing data to actually be sent to remote
             /// endpoint (i.e. the maximum time between send() being called and the socket being writable again).
             /// If this time is exceeded, the socket will be closed.
+            /// \param options Tuning options applied to the socket when it is created.
             /// \return a std::shared_ptr pointing to an instance of a ISocket object, or nullptr if no socket could be
             /// created.
             static std::shared_ptr<SecureSocket<Protocol>>
             create(std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                    std::unique_ptr<SSLContext> secure_context,
                    std::chrono::milliseconds send_timeout = std::chrono::milliseconds(5000),
-                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 });
+                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 },
+                   const SocketOptions& options = SocketOptions{});
 
             static std::shared_ptr<SecureSocket<Protocol>>
             create(std::shared_ptr<smooth::core::network::InetAddress> ip,
@@ -90,23 +56,32 @@ namespace smooth::core::network
                    std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                    std::unique_ptr<SSLContext> secure_context,
                    std::chrono::milliseconds timeout = std::chrono::milliseconds(5000),
-                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 });
+                   std::chrono::milliseconds receive_timeout = std::chrono::milliseconds{ 0 },
+                   const SocketOptions& options = SocketOptions{},
+                   bool configured = false);
 
-            void set_existing_socket(const std::shared_ptr<InetAddress>& address, int socket_id) override;
+            void set_existing_socket(const std::shared_ptr<InetAddress>& address,
+                                     int socket_id,
+                                     bool configured = false) override;
+
+            bool can_send_file() const override
+            {
+                // File contents must pass through the TLS layer.
+                return false;
+            }
 
         protected:
             SecureSocket(std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                          std::unique_ptr<SSLContext> context)
                     : Socket<Protocol, Packet>(std::move(buffer_container)),
-                      secure_context(std::move(context))
+                      secure_context(std::move(context)),
+                      bio(this->socket_id, this->counters)
             {
-                mbedtls_ssl_set_bio(*secure_context,
-            this,
-            ssl_send,
-            ssl_recv,
-            nullptr);
+                bio.attach(*secure_context);
             }
 
+            void stop_internal() override;
+
             void readable(ISocketBackOff& ops) override;
 
             void writable() override;
@@ -117,14 +92,83 @@ namespace smooth::core::network
 
             bool has_data_to_transmit() override;
 
+            bool has_receive_capacity() override;
+
+            bool has_buffered_data() override;
+
+            bool has_send_expired() const override
+            {
+                return !is_handshake_offloaded() && Socket<Protocol, Packet>::has_send_expired();
+            }
+
+            bool has_receive_expired() const override
+            {
+                return !is_handshake_offloaded() && Socket<Protocol, Packet>::has_receive_expired();
+            }
+
         private:
             static constexpr const char* tag = "SecureSocket";
             std::unique_ptr<SSLContext> secure_context{};
+            TlsBio bio;
+
+            /// Gathers queued packets into full records.
+            std::vector<uint8_t> staging{};
+
+            /// Length of a write mbedTLS has asked to have repeated, 0 if none.
+            int pending_write_length = 0;
+
+            /// Who runs the handshake. While the TlsHandshakeWorker owns the SSL context the dispatcher leaves
+            /// the socket alone, and its timeouts are put on hold, until it has taken the socket back.
+            enum class HandshakeOffload
+            {
+                /// The dispatcher.
+                None,
+                /// The TlsHandshakeWorker, which has it queued or is running it.
+                Running,
+                /// The TlsHandshakeWorker is done, waiting for the dispatcher to take the socket back.
+                Done
+            };
+
+            std::atomic<HandshakeOffload> handshake_offload{ HandshakeOffload::None };
+
+            /// Held by the worker while running the handshake, keeping the socket from being closed under it.
+            std::mutex handshake_guard{};
+
+            /// What the handshake is waiting for, so that the socket is only selected for the
+            /// direction that lets the handshake progress.
+            enum class HandshakeWait
+            {
+                Any,
+                Read,
+                Write
+            };
+
+            std::atomic<HandshakeWait> handshake_wait{ HandshakeWait::Any };
 
             bool is_handshake_complete(const SSLContext& ctx) const;
 
             void do_handshake_step();
 
+            void run_handshake() override;
+
+            /// Runs handshake steps until the handshake has to wait for the peer, has completed or has failed.
+            /// \return true if the handshake failed.
+            bool run_handshake_steps();
+
+            /// Takes the socket back from the TlsHandshakeWorker once it is done, restarting the timeouts.
+            /// Called on the dispatcher's task, which is the only one touching the timers.
+            /// \return true if the socket is not offloaded.
+            bool reclaim_handshake();
+
+            [[nodiscard]] bool is_handshake_offloaded() const
+            {
+                return handshake_offload != HandshakeOffload::None;
+            }
+
+            /// Handles the result of a handshake step.
+            /// \return true if the handshake failed.
+            bool handle_handshake_result(int res);
+
             bool needs_tls_transfer(int code) const
             {
                 return code == MBEDTLS_ERR_SSL_WANT_READ
@@ -143,12 +187,12 @@ namespace smooth::core::network
         std::weak_ptr<BufferContainer<Protocol>> buffer_container,
         std::unique_ptr<SSLContext> context,
         std::chrono::milliseconds send_timeout,
-        std::chrono::milliseconds receive_timeout)
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options,
+        bool configured)
     {
-        auto s = create(buffer_container, std::move(context));
-        s->set_send_timeout(send_timeout);
-        s->set_receive_timeout(receive_timeout);
-        s->set_existing_socket(ip, socket_id);
+        auto s = create(buffer_container, std::move(context), send_timeout, receive_timeout, options);
+        s->set_existing_socket(ip, socket_id, configured);
 
         return s;
     }
@@ -158,27 +202,30 @@ namespace smooth::core::network
         std::weak_ptr<BufferContainer<Protocol>> buffer_container,
         std::unique_ptr<SSLContext> context,
         std::chrono::milliseconds send_timeout,
-        std::chrono::milliseconds receive_timeout)
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options)
     {
         auto s = smooth::core::util::create_protected_shared<SecureSocket<Protocol, Packet>>(buffer_container,
         std::move(context));
         s->set_send_timeout(send_timeout);
         s->set_receive_timeout(receive_timeout);
+        s->set_socket_options(options);
 
         return s;
     }
 
     template<typename Protocol, typename Packet>
     void SecureSocket<Protocol, Packet>::set_existing_socket(const std::shared_ptr<InetAddress>& address,
-                                                             int socket_id)
+                                                             int socket_id,
+                                                             bool configured)
     {
-        Socket<Protocol, Packet>::set_existing_socket(address, socket_id);
+        Socket<Protocol, Packet>::set_existing_socket(address, socket_id, configured);
     }
 
     template<typename Protocol, typename Packet>
     void SecureSocket<Protocol, Packet>::readable(ISocketBackOff& ops)
     {
-        if (this->is_active())
+        if (this->is_active() && !is_handshake_offloaded())
         {
             this->elapsed_receive_time.start();
 
@@ -196,7 +243,7 @@ namespace smooth::core::network
     template<typename Protocol, typename Packet>
     void SecureSocket<Protocol, Packet>::writable()
     {
-        if (this->is_active() && this->signal_new_connection())
+        if (this->is_active() && !is_handshake_offloaded() && this->signal_new_connection())
         {
             this->elapsed_send_time.start();
 
@@ -220,64 +267,49 @@ namespace smooth::core::network
 
         do
         {
+            // When the receive buffer is full, decrypted or read ahead data is left where it is; once the
+            // application has consumed a packet, has_buffered_data() brings the dispatcher back.
             if (rx.is_full())
             {
-                // Receiver is full. Since mbedtls_ssl_read() moves data from the underlying socket, we get no
-                // no more readable-events on it, which results in the SocketDispatcher no longer calling
-                // readable() on this socket, in turn preventing this function be called again to read the
-                // remaining decrypted data. As such we have to wait a bit so the application consumes at
-                // least one packet.
-                std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
-
-                // Likely better solution: Set an artificial readable-indicator on the socket telling the
-                // SocketDispatcher there are more data to be read, forcing a readable()-call on the socket.
+                break;
             }
-            else
-            {
-                int wanted_length = rx.amount_wanted();
-                auto read_amount = 0;
 
-                {
-                    auto write_pos = rx.get_write_pos();
-                    read_amount = mbedtls_ssl_read(*secure_context,
-                                                   static_cast<uint8_t*>(write_pos),
-                                                   static_cast<size_t>(wanted_length));
-                }
+            auto res = rx.receive([this](uint8_t* write_pos, int wanted_length) {
+                                      return mbedtls_ssl_read(*secure_context,
+                                                              write_pos,
+                                                              static_cast<size_t>(wanted_length));
+                                  },
+                                  [this, &container, &rx]() {
+                                      this->counters.add_packet_received();
+                                      event::DataAvailableEvent<Protocol> d(&rx);
+                                      container->get_data_available()->push(d);
+                                  });
+
+            if (res.read_count > 0 && !res.buffered)
+            {
+                this->counters.add_received(res.read_count);
+            }
 
-                if (read_amount == 0)
-                {
-                    this->stop("Underlying socket closed (mbedtls_ssl_read returned 0)");
-                }
-                else if (read_amount < 0)
-                {
-                    if (!needs_tls_transfer(read_amount))
-                    {
-                        char buf[128];
-                        mbedtls_strerror(read_amount, buf, sizeof(buf));
-                        this->stop(buf);
-                    }
-                }
-                else
+            if (res.read_count == 0)
+            {
+                this->stop("Underlying socket closed (mbedtls_ssl_read returned 0)");
+            }
+            else if (res.read_count < 0)
+            {
+                if (!needs_tls_transfer(res.read_count))
                 {
-                    rx.data_received(read_amount);
-
-                    if (rx.is_error())
-                    {
-                        Log::error(tag, "Assembly error");
-                        rx.prepare_new_packet();
-                        this->stop("Assembly error");
-                    }
-                    else if (rx.is_packet_complete())
-                    {
-                        event::DataAvailableEvent<Protocol> d(&rx);
-                        container->get_data_available()->push(d);
-                        rx.prepare_new_packet();
-                    }
+                    char buf[128];
+                    mbedtls_strerror(res.read_count, buf, sizeof(buf));
+                    this->stop(buf);
                 }
             }
+            else if (res.assembly_error)
+            {
+                Log::error(tag, "Assembly error");
+                this->stop("Assembly error");
+            }
         }
-        while (this->is_active()
-               && mbedtls_ssl_get_bytes_avail(*secure_context) > 0);
+        while (this->is_active() && has_buffered_data());
     }
 
     template<typename Protocol, typename Packet>
@@ -286,45 +318,74 @@ namespace smooth::core::network
         this->elapsed_receive_time.start();
 
         auto& tx = container->get_tx_buffer();
-        auto data_to_send = tx.get_data_to_send();
 
-        auto length = tx.get_remaining_data_length();
+        // Packets are coalesced into records of the largest size allowed, which takes a negotiated
+        // maximum fragment length into account.
+        auto max_payload = mbedtls_ssl_get_max_out_record_payload(*secure_context);
 
-        auto amount_sent = 0;
+        if (max_payload <= 0)
+        {
+            max_payload = MBEDTLS_SSL_MAX_CONTENT_LEN;
+        }
+
+        CoalescedSendResult res{};
+        bool packets_completed = false;
 
         do
         {
-            amount_sent = mbedtls_ssl_write(*secure_context,
-                                            data_to_send,
-                                            static_cast<size_t>(length));
-
-            if (!needs_tls_transfer(amount_sent))
+            res = tx.send_coalesced(staging,
+                                    max_payload,
+                                    pending_write_length,
+                                    [this](const uint8_t* data_to_send, int length) {
+                                        return mbedtls_ssl_write(*secure_context,
+                                                                 data_to_send,
+                                                                 static_cast<size_t>(length));
+                                    });
+
+            if (needs_tls_transfer(res.sent_count))
             {
-                if (amount_sent > 0)
+                // The record is held by mbedTLS, which wants the write repeated with the same length.
+                pending_write_length = res.write_length;
+                this->counters.add_send_stall();
+                this->elapsed_send_time.start();
+            }
+            else
+            {
+                pending_write_length = 0;
+
+                if (res.sent_count > 0)
                 {
-                    tx.data_has_been_sent(amount_sent);
+                    this->counters.add_sent(res.sent_count);
 
-                    // Was a complete packet sent?
-                    if (tx.is_in_progress())
-                    {
-                        this->elapsed_send_time.start();
-                    }
-                    else
+                    for (int i = 0; i < res.packets_completed; ++i)
                     {
-                        // Let the application know it may now send another packet.
-                        event::TransmitBufferEmptyEvent event(this->shared_from_this());
-                        container->get_tx_empty()->push(event);
+                        this->counters.add_packet_sent();
                     }
-                }
 
-                if (amount_sent < 0 && !needs_tls_transfer(amount_sent))
+                    packets_completed |= res.packets_completed > 0;
+                }
+                else if (res.sent_count < 0)
                 {
-                    log_mbedtls_error("SecureSocket", "mbedtls_ssl_write", amount_sent);
+                    log_mbedtls_error("SecureSocket", "mbedtls_ssl_write", res.sent_count);
                     this->stop("Error writing");
                 }
             }
         }
-        while (needs_tls_transfer(amount_sent));
+        while (res.sent_count > 0 && !tx.is_empty());
+
+        if (tx.is_empty())
+        {
+            // Don't hold on to the memory while idle.
+            staging.clear();
+            staging.shrink_to_fit();
+        }
+
+        if (packets_completed)
+        {
+            // Let the application know it may now send more packets.
+            event::TransmitBufferEmptyEvent event(this->shared_from_this());
+            container->get_tx_empty()->push(event);
+        }
     }
 
     template<typename Protocol, typename Packet>
@@ -339,24 +400,160 @@ namespace smooth::core::network
         this->elapsed_receive_time.start();
         this->elapsed_send_time.start();
 
-        auto res = mbedtls_ssl_handshake_step(*secure_context);
+        // Hand the handshake over to the worker; until it is done the socket is neither read nor written
+        // by the dispatcher.
+        handshake_offload = HandshakeOffload::Running;
+        std::shared_ptr<ITlsHandshake> self = std::static_pointer_cast<SecureSocket<Protocol, Packet>>(
+            this->shared_from_this());
+
+        if (!TlsHandshakeWorker::instance().perform(self))
+        {
+            // Rather than leaving the socket waiting for a handshake that never runs, run it here.
+            Log::warning(tag, "Handshake queue full, running handshake on the dispatcher");
+            handshake_offload = HandshakeOffload::None;
+
+            if (run_handshake_steps())
+            {
+                this->stop("Error during handshake");
+            }
+        }
+    }
+
+    template<typename Protocol, typename Packet>
+    void SecureSocket<Protocol, Packet>::run_handshake()
+    {
+        auto failed = run_handshake_steps();
+
+        // The timeouts are restarted by the dispatcher, when it takes the socket back.
+        handshake_offload = HandshakeOffload::Done;
+
+        if (failed)
+        {
+            this->stop("Error during handshake");
+        }
+    }
+
+    template<typename Protocol, typename Packet>
+    bool SecureSocket<Protocol, Packet>::run_handshake_steps()
+    {
+        bool failed = false;
+        std::lock_guard<std::mutex> lock(handshake_guard);
+
+        if (this->is_active())
+        {
+            int res;
+
+            // Run as many steps as possible without waiting for the peer; with restartable ECC
+            // enabled a step may also return early, in which case it is simply resumed.
+            do
+            {
+                res = mbedtls_ssl_handshake_step(*secure_context);
+            }
+            while ((res == 0 && !is_handshake_complete(*secure_context))
+#ifdef MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS
+                   || res == MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS
+#endif
+            );
+
+            failed = handle_handshake_result(res);
+        }
+
+        return failed;
+    }
+
+    template<typename Protocol, typename Packet>
+    bool SecureSocket<Protocol, Packet>::reclaim_handshake()
+    {
+        auto done = HandshakeOffload::Done;
+
+        if (handshake_offload.compare_exchange_strong(done, HandshakeOffload::None))
+        {
+            this->elapsed_receive_time.start();
+            this->elapsed_send_time.start();
+        }
+
+        return !is_handshake_offloaded();
+    }
+
+    template<typename Protocol, typename Packet>
+    bool SecureSocket<Protocol, Packet>::handle_handshake_result(int res)
+    {
+        bool failed = false;
+        handshake_wait = HandshakeWait::Any;
 
         if (needs_tls_transfer(res))
         {
             // Handshake not yet complete
+            if (res == MBEDTLS_ERR_SSL_WANT_READ)
+            {
+                handshake_wait = HandshakeWait::Read;
+            }
+            else if (res == MBEDTLS_ERR_SSL_WANT_WRITE)
+            {
+                handshake_wait = HandshakeWait::Write;
+            }
         }
         else if (res < 0)
         {
             // Handshake failed
             log_mbedtls_error("SecureSocket", "mbedtls_ssl_handshake_step", res);
-            this->stop("Error during handshake");
+            secure_context->handshake_failed();
+            failed = true;
         }
+        else if (is_handshake_complete(*secure_context))
+        {
+            // Keep the session so the next connection may resume it.
+            secure_context->handshake_completed();
+        }
+
+        return failed;
+    }
+
+    template<typename Protocol, typename Packet>
+    void SecureSocket<Protocol, Packet>::stop_internal()
+    {
+        // Wait for the worker, if running, so that the socket isn't closed mid-handshake.
+        std::lock_guard<std::mutex> lock(handshake_guard);
+        Socket<Protocol, Packet>::stop_internal();
     }
 
     template<typename Protocol, typename Packet>
     bool SecureSocket<Protocol, Packet>::has_data_to_transmit()
     {
-        return !is_handshake_complete(*secure_context)
-               || Socket<Protocol, Packet>::has_data_to_transmit();
+        bool res = false;
+
+        if (reclaim_handshake())
+        {
+            res = is_handshake_complete(*secure_context)
+                  ? Socket<Protocol, Packet>::has_data_to_transmit()
+                  : handshake_wait != HandshakeWait::Read;
+        }
+
+        return res;
+    }
+
+    template<typename Protocol, typename Packet>
+    bool SecureSocket<Protocol, Packet>::has_buffered_data()
+    {
+        return !is_handshake_offloaded()
+               && is_handshake_complete(*secure_context)
+               && (bio.has_buffered_data()
+                   || mbedtls_ssl_check_pending(*secure_context) != 0
+                   || Socket<Protocol, Packet>::has_buffered_data());
+    }
+
+    template<typename Protocol, typename Packet>
+    bool SecureSocket<Protocol, Packet>::has_receive_capacity()
+    {
+        bool res = false;
+
+        if (reclaim_handshake())
+        {
+            res = is_handshake_complete(*secure_context)
+                  ? Socket<Protocol, Packet>::has_receive_capacity()
+                  : handshake_wait != HandshakeWait::Write;
+        }
+
+        return res;
     }
 }
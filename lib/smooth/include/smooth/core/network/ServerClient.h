@@ -48,9 +48,15 @@ namespace smooth::core::network
         public std::enable_shared_from_this<FinalClientTypeName>
     {
         public:
+            /// Constructor
+            /// \param task The task to which events are delivered.
+            /// \param pool The pool the client belongs to.
+            /// \param proto The protocol
+            /// \param depth The number of packets the receive and transmit buffers of the client may hold.
             ServerClient(smooth::core::Task& task,
                          smooth::core::network::ClientPool<FinalClientTypeName>& pool,
-                         std::unique_ptr<Protocol> proto);
+                         std::unique_ptr<Protocol> proto,
+                         BufferDepth depth = BufferDepth{});
 
             ~ServerClient() override = default;
 
@@ -124,13 +130,15 @@ namespace smooth::core::network
 
             smooth::core::network::ClientPool<FinalClientTypeName>& pool;
             ClientContext* client_context{ nullptr };
+            int pool_slot{ -1 };
     };
 
     template<typename FinalClientTypeName, typename Protocol, typename ClientContext>
     ServerClient<FinalClientTypeName, Protocol, ClientContext>::ServerClient(
         smooth::core::Task& task, smooth::core::network::ClientPool<FinalClientTypeName>& pool,
-        std::unique_ptr<Protocol> proto)
-            : container(std::make_shared<BufferContainer<Protocol>>(task, *this, *this, *this, std::move(proto))),
+        std::unique_ptr<Protocol> proto,
+        BufferDepth depth)
+            : container(std::make_shared<BufferContainer<Protocol>>(task, *this, *this, *this, std::move(proto), depth)),
               pool(pool)
     {
     }
@@ -31,6 +31,8 @@ limitations under the License.
 #include "smooth/core/network/event/ConnectionStatusEvent.h"
 #include "smooth/core/network/CommonSocket.h"
 #include "smooth/core/network/Socket.h"
+#include "smooth/core/timer/Timer.h"
+#include "smooth/core/timer/TimerExpiredEvent.h"
 #include "smooth/core/util/create_protected.h"
 
 #ifndef ESP_PLATFORM
@@ -46,13 +48,35 @@ namespace smooth::core::network
 {
     template<typename Client, typename Protocol, typename ClientContext>
     class ServerSocket
-        : public CommonSocket
+        : public CommonSocket,
+        private smooth::core::ipc::IEventListener<smooth::core::timer::TimerExpiredEvent>
     {
         public:
+            /// Creates a server socket.
+            /// \param task The task on which the clients receive their events.
+            /// \param pool_size The number of clients, i.e. simultaneous connections, either a fixed count or
+            /// an elastic size where clients are created on demand and trimmed when idle.
+            /// \param backlog The listen backlog.
+            template<typename... ProtocolArguments>
+            static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
+            create(smooth::core::Task& task, ClientPoolSize pool_size, int backlog, ProtocolArguments... proto_args);
+
+            /// Creates a server socket with a fixed number of clients.
+            /// \param max_client_count The number of clients, i.e. simultaneous connections.
             template<typename... ProtocolArguments>
             static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
             create(smooth::core::Task& task, int max_client_count, int backlog, ProtocolArguments... proto_args);
 
+            /// Creates a server socket with tuning options.
+            /// \param options Options applied to the listening socket, and to each accepted socket.
+            template<typename... ProtocolArguments>
+            static std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>>
+            create(smooth::core::Task& task,
+                   ClientPoolSize pool_size,
+                   int backlog,
+                   const SocketOptions& options,
+                   ProtocolArguments... proto_args);
+
             bool start(std::shared_ptr<InetAddress> bind_to) override;
 
             void set_client_context(ClientContext* ctx)
@@ -70,14 +94,41 @@ namespace smooth::core::network
 
             void writable() override;
 
-            virtual std::tuple<std::shared_ptr<smooth::core::network::InetAddress>, int>
-            accept_request(ISocketBackOff& ops);
+            /// Accepts a pending connection.
+            /// \return The address of the remote endpoint and the accepted socket, or nullptr if there
+            /// is no pending connection or an error occurred.
+            virtual std::tuple<std::shared_ptr<smooth::core::network::InetAddress>, int> accept_request();
+
+            /// Hands an accepted connection over to a client from the pool.
+            /// \param ip The address of the remote endpoint.
+            /// \param accepted_socket_id The accepted socket.
+            /// \param configured true if the accepted socket already is non-blocking and has inherited
+            /// the options of the server socket.
+            virtual void add_client(std::shared_ptr<smooth::core::network::InetAddress> ip,
+                                    int accepted_socket_id,
+                                    bool configured);
+
+            /// Returns a value indicating if accepted sockets are non-blocking and have the socket options applied,
+            /// i.e. accept4() is available and accepted sockets inherit the options of the listening socket.
+            static constexpr bool accepts_configured_sockets()
+            {
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+                return true;
+#else
+                return false;
+#endif
+            }
 
             bool has_data_to_transmit() override
             {
                 return false;
             }
 
+            bool has_receive_capacity() override
+            {
+                return true;
+            }
+
             bool internal_start() override;
 
             void publish_connected_status() override
@@ -90,19 +141,34 @@ namespace smooth::core::network
 
             template<typename... ProtocolArguments>
             ServerSocket(smooth::core::Task& task,
-                         int max_client_count,
+                         ClientPoolSize pool_size,
                          int backlog,
+                         const SocketOptions& options,
                          ProtocolArguments... proto_args)
                     : CommonSocket(),
-                      pool(task, max_client_count), backlog(backlog)
+                      pool(task, pool_size), backlog(backlog)
             {
+                set_socket_options(options);
                 pool.create_clients(proto_args...);
+
+                if (pool_size.is_elastic() && pool_size.idle_timeout.count() > 0)
+                {
+                    // Trimming happens on the clients' task, where they are also returned to the pool.
+                    trim_events = TrimQueue::create(2, task, *this);
+                    trim_timer = smooth::core::timer::Timer::create(0, trim_events, true, pool_size.idle_timeout);
+                    trim_timer->start();
+                }
             }
 
             ClientPool<Client> pool;
             ClientContext* client_context{ nullptr };
         private:
+            void event(const smooth::core::timer::TimerExpiredEvent& event) override;
+
             int backlog{ 0 };
+            using TrimQueue = smooth::core::ipc::TaskEventQueue<smooth::core::timer::TimerExpiredEvent>;
+            std::shared_ptr<TrimQueue> trim_events{};
+            smooth::core::timer::TimerOwner trim_timer{};
     };
 
     template<typename Client, typename Protocol, typename ClientContext>
@@ -112,15 +178,8 @@ namespace smooth::core::network
 
         if (!is_active())
         {
-            ip = std::move(bind_to);
-
-            // Always do resolve ip to ensure that we are update-to-date.
-            res = ip->resolve_ip() && ip->is_valid();
-
-            if (res)
-            {
-                SocketDispatcher::instance().perform_op(SocketOperation::Op::Start, shared_from_this());
-            }
+            // Always resolve the ip to ensure that we are up-to-date, within the TTL of the DnsCache.
+            res = start_with_address(std::move(bind_to));
         }
 
         return res;
@@ -128,55 +187,56 @@ namespace smooth::core::network
 
     template<typename Client, typename Protocol, typename ClientContext>
     std::tuple<std::shared_ptr<smooth::core::network::InetAddress>, int> ServerSocket<Client, Protocol,
-                                                                                      ClientContext>::accept_request(
-        ISocketBackOff& ops)
+                                                                                      ClientContext>::accept_request()
     {
-        using namespace smooth::core::logging;
-
         auto res = std::make_tuple<std::shared_ptr<smooth::core::network::InetAddress>, int>(nullptr, 0);
 
-        if (pool.empty())
-        {
-            Log::warning("ServerSocket", "No client available at this time");
-            ops.back_off(socket_id, DefaultReceiveTimeout);
-        }
-        else
-        {
-            sockaddr addr{};
-            socklen_t len{ AF_INET6 };
+        sockaddr_storage addr{};
+        socklen_t len{ sizeof(addr) };
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+        auto remote = reinterpret_cast<sockaddr*>(&addr);
+#pragma GCC diagnostic pop
 
-            auto accepted_socket = accept(socket_id, &addr, &len);
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+        auto accepted_socket = accept4(socket_id, remote, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        auto accepted_socket = accept(socket_id, remote, &len);
+#endif
 
-            if (accepted_socket == INVALID_SOCKET)
+        if (accepted_socket == INVALID_SOCKET)
+        {
+            // Running out of pending connections is the normal end of an accept burst.
+            if (errno != EWOULDBLOCK)
             {
                 std::string msg = "Error accepting: ";
                 msg += strerror(errno);
                 loge(msg.c_str());
             }
-            else
-            {
-                std::shared_ptr<smooth::core::network::InetAddress> ip{};
+        }
+        else
+        {
+            std::shared_ptr<smooth::core::network::InetAddress> ip{};
 
-                if (addr.sa_family == AF_INET)
-                {
+            if (addr.ss_family == AF_INET)
+            {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-align"
-                    auto ipv4_address = reinterpret_cast<sockaddr_in*>(&addr);
+                auto ipv4_address = reinterpret_cast<sockaddr_in*>(&addr);
 #pragma GCC diagnostic pop
-                    ip = std::make_shared<smooth::core::network::IPv4>(*ipv4_address);
-                }
-                else
-                {
+                ip = std::make_shared<smooth::core::network::IPv4>(*ipv4_address);
+            }
+            else
+            {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-align"
-                    auto ipv6_address = reinterpret_cast<sockaddr_in6*>(&addr);
+                auto ipv6_address = reinterpret_cast<sockaddr_in6*>(&addr);
 #pragma GCC diagnostic pop
-                    ip = std::make_shared<smooth::core::network::IPv6>(*ipv6_address);
-                }
-
-                Log::info("ServerSocket", "Connection accepted");
-                res = std::make_tuple<>(ip, accepted_socket);
+                ip = std::make_shared<smooth::core::network::IPv6>(*ipv6_address);
             }
+
+            smooth::core::logging::Log::debug("ServerSocket", "Connection accepted");
+            res = std::make_tuple<>(ip, accepted_socket);
         }
 
         return res;
@@ -185,19 +245,48 @@ namespace smooth::core::network
     template<typename Client, typename Protocol, typename ClientContext>
     void ServerSocket<Client, Protocol, ClientContext>::readable(ISocketBackOff& ops)
     {
-        const auto& [ip, accepted_socket_id] = accept_request(ops);
-
-        if (ip)
+        if (pool.empty())
         {
-            auto client = pool.get();
-            auto socket = Socket<Protocol>::create(ip,
-                                                   accepted_socket_id,
-                                                   client->get_buffers(),
-                                                   client->get_send_timeout());
-
-            client->set_client_context(client_context);
-            client->set_socket(socket);
+            smooth::core::logging::Log::warning("ServerSocket", "No client available at this time");
+            ops.back_off(socket_id, DefaultReceiveTimeout);
         }
+        else
+        {
+            // Drain the backlog in one go, instead of one connection per call, so that a burst of connections
+            // doesn't have to wait for a dispatcher iteration each. Whatever is left once the pool runs
+            // out is accepted on a later call, when clients have been returned.
+            bool accepted = true;
+
+            while (accepted && !pool.empty())
+            {
+                const auto& [ip, accepted_socket_id] = accept_request();
+                accepted = ip != nullptr;
+
+                if (accepted)
+                {
+                    add_client(ip, accepted_socket_id, accepts_configured_sockets());
+                }
+            }
+        }
+    }
+
+    template<typename Client, typename Protocol, typename ClientContext>
+    void ServerSocket<Client, Protocol, ClientContext>::add_client(
+        std::shared_ptr<smooth::core::network::InetAddress> ip,
+        int accepted_socket_id,
+        bool configured)
+    {
+        auto client = pool.get();
+        auto socket = Socket<Protocol>::create(ip,
+                                               accepted_socket_id,
+                                               client->get_buffers(),
+                                               client->get_send_timeout(),
+                                               DefaultReceiveTimeout,
+                                               socket_options,
+                                               configured);
+
+        client->set_client_context(client_context);
+        client->set_socket(socket);
     }
 
     template<typename Client, typename Protocol, typename ClientContext>
@@ -205,6 +294,12 @@ namespace smooth::core::network
     {
     }
 
+    template<typename Client, typename Protocol, typename ClientContext>
+    void ServerSocket<Client, Protocol, ClientContext>::event(const smooth::core::timer::TimerExpiredEvent& /*event*/)
+    {
+        pool.trim();
+    }
+
     template<typename Client, typename Protocol, typename ClientContext>
     void ServerSocket<Client, Protocol, ClientContext>::stop_internal()
     {
@@ -264,15 +359,38 @@ namespace smooth::core::network
         return res;
     }
 
+    template<typename Client, typename Protocol, typename ClientContext>
+    template<typename... ProtocolArguments>
+    std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>> ServerSocket<Client, Protocol,
+                                                                                ClientContext>::create(
+        smooth::core::Task& task, ClientPoolSize pool_size, int backlog, ProtocolArguments... proto_args)
+    {
+        return create(task, pool_size, backlog, SocketOptions{}, proto_args...);
+    }
+
     template<typename Client, typename Protocol, typename ClientContext>
     template<typename... ProtocolArguments>
     std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>> ServerSocket<Client, Protocol,
                                                                                 ClientContext>::create(
         smooth::core::Task& task, int max_client_count, int backlog, ProtocolArguments... proto_args)
+    {
+        return create(task, ClientPoolSize{ max_client_count }, backlog, SocketOptions{}, proto_args...);
+    }
+
+    template<typename Client, typename Protocol, typename ClientContext>
+    template<typename... ProtocolArguments>
+    std::shared_ptr<ServerSocket<Client, Protocol, ClientContext>> ServerSocket<Client, Protocol,
+                                                                                ClientContext>::create(
+        smooth::core::Task& task,
+        ClientPoolSize pool_size,
+        int backlog,
+        const SocketOptions& options,
+        ProtocolArguments... proto_args)
     {
         return smooth::core::util::create_protected_shared<ServerSocket<Client, Protocol, ClientContext>>(task,
-                                                                                                          max_client_count,
+                                                                                                          pool_size,
                                                                                                           backlog,
+                                                                                                          options,
                                                                                                           proto_args...);
     }
 
@@ -291,9 +409,11 @@ namespace smooth::core::network
             }
             else
             {
+                // Options are applied before listen() so that accepted sockets inherit the buffer sizes
+                // and so that Fast Open is enabled on the listening socket.
                 res = set_non_blocking();
-                int no_delay = 1;
-                res &= setsockopt(socket_id, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay)) == 0;
+                res &= apply_socket_options();
+                res &= apply_fast_open(true);
 
                 if (res)
                 {
@@ -25,6 +25,7 @@ limitations under the License.
 #include "CommonSocket.h"
 #include "ServerClient.h"
 #include "BufferContainer.h"
+#include "FileRegion.h"
 #include "smooth/core/util/CircularBuffer.h"
 #include "smooth/core/ipc/TaskEventQueue.h"
 #include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
@@ -73,19 +74,26 @@ namespace smooth::core::network
             /// \param send_timeout The amount of time to wait for outgoing data to actually be sent to remote
             /// endpoint (i.e. the maximum time between send() being called and the socket being writable again).
             /// If this time is exceeded, the socket will be closed.
+            /// \param options Tuning options applied to the socket when it is created.
             /// \return a std::shared_ptr pointing to an instance of a ISocket object, or nullptr if no socket could be
             /// created.
             static std::shared_ptr<Socket<Protocol>>
             create(std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                    std::chrono::milliseconds send_timeout = DefaultSendTimeout,
-                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout);
+                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout,
+                   const SocketOptions& options = SocketOptions{});
 
+            /// Creates a socket for an already connected socket, e.g. one accepted by a server socket.
+            /// \param configured true if the socket already is non-blocking and has the options applied, such as
+            /// when accepted with accept4() from a listening socket having the same options.
             static std::shared_ptr<Socket<Protocol>>
             create(std::shared_ptr<smooth::core::network::InetAddress> ip,
                    int socket_id,
                    std::weak_ptr<BufferContainer<Protocol>> buffer_container,
                    std::chrono::milliseconds send_timeout = DefaultSendTimeout,
-                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout);
+                   std::chrono::milliseconds receive_timeout = DefaultReceiveTimeout,
+                   const SocketOptions& options = SocketOptions{},
+                   bool configured = false);
 
             ~Socket() override = default;
 
@@ -95,7 +103,9 @@ namespace smooth::core::network
 
             void writable() override;
 
-            virtual void set_existing_socket(const std::shared_ptr<InetAddress>& address, int socket_id);
+            virtual void set_existing_socket(const std::shared_ptr<InetAddress>& address,
+                                             int socket_id,
+                                             bool configured = false);
 
             bool send(const Packet& packet);
 
@@ -104,6 +114,11 @@ namespace smooth::core::network
                 return false;
             }
 
+            bool can_send_file() const override
+            {
+                return FileRegion::is_supported();
+            }
+
         protected:
             Socket(std::weak_ptr<BufferContainer<Protocol>> buffer_container);
 
@@ -138,17 +153,21 @@ namespace smooth::core::network
                 return res;
             }
 
+            bool has_receive_capacity() override;
+
+            bool has_buffered_data() override;
+
             void publish_connected_status() override;
 
             void stop_internal() override;
 
             std::shared_ptr<BufferContainer<Protocol>> get_container_or_close();
 
-            bool set_no_delay();
-
             std::weak_ptr<BufferContainer<Protocol>> buffers{};
         private:
             void clear_buffers();
+
+            static constexpr std::size_t max_file_send_size = 64 * 1024;
     };
 
     template<typename Protocol, typename Packet>
@@ -157,12 +176,12 @@ namespace smooth::core::network
         int socket_id,
         std::weak_ptr<BufferContainer<Protocol>> buffer_container,
         std::chrono::milliseconds send_timeout,
-        std::chrono::milliseconds receive_timeout)
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options,
+        bool configured)
     {
-        auto s = create(buffer_container, send_timeout, receive_timeout);
-        s->set_send_timeout(send_timeout);
-        s->set_receive_timeout(receive_timeout);
-        s->set_existing_socket(ip, socket_id);
+        auto s = create(buffer_container, send_timeout, receive_timeout, options);
+        s->set_existing_socket(ip, socket_id, configured);
 
         return s;
     }
@@ -171,11 +190,13 @@ namespace smooth::core::network
     std::shared_ptr<Socket<Protocol>> Socket<Protocol, Packet>::create(
         std::weak_ptr<BufferContainer<Protocol>> buffer_container,
         std::chrono::milliseconds send_timeout,
-        std::chrono::milliseconds receive_timeout)
+        std::chrono::milliseconds receive_timeout,
+        const SocketOptions& options)
     {
         auto s = smooth::core::util::create_protected_shared<Socket<Protocol, Packet>>(buffer_container);
         s->set_send_timeout(send_timeout);
         s->set_receive_timeout(receive_timeout);
+        s->set_socket_options(options);
 
         return s;
     }
@@ -198,15 +219,9 @@ namespace smooth::core::network
         if (!active)
         {
             elapsed_send_time.stop_and_zero();
-            this->ip = ip;
-
-            // Always do resolve ip to ensure that we are update-to-date.
-            res = ip->resolve_ip() && ip->is_valid();
 
-            if (res)
-            {
-                SocketDispatcher::instance().perform_op(SocketOperation::Op::Start, shared_from_this());
-            }
+            // Always resolve the ip to ensure that we are up-to-date, within the TTL of the DnsCache.
+            res = start_with_address(std::move(ip));
         }
 
         return res;
@@ -227,7 +242,7 @@ namespace smooth::core::network
             }
             else
             {
-                res = set_non_blocking() && set_no_delay();
+                res = set_non_blocking() && apply_socket_options() && apply_fast_open(false);
             }
         }
         else
@@ -239,19 +254,31 @@ namespace smooth::core::network
     }
 
     template<typename Protocol, typename Packet>
-    bool Socket<Protocol, Packet>::set_no_delay()
+    bool Socket<Protocol, Packet>::has_receive_capacity()
     {
-        int no_delay = 1;
-        auto res = setsockopt(socket_id, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay)) == 0;
+        bool res = true;
+        auto cont = buffers.lock();
 
-        if (!res)
+        if (cont && cont->get_rx_buffer().is_full())
         {
-            loge("Failed to set no delay socket option");
+            res = false;
+
+            // We're not reading because the application hasn't consumed the received packets yet,
+            // that is not a reason to consider the other end silent.
+            this->elapsed_receive_time.start();
         }
 
         return res;
     }
 
+    template<typename Protocol, typename Packet>
+    bool Socket<Protocol, Packet>::has_buffered_data()
+    {
+        auto cont = buffers.lock();
+
+        return cont && cont->get_rx_buffer().has_buffered_data();
+    }
+
     template<typename Protocol, typename Packet>
     void Socket<Protocol, Packet>::readable(ISocketBackOff&)
     {
@@ -306,23 +333,15 @@ namespace smooth::core::network
                 auto& tx = cont->get_tx_buffer();
 
                 // Any data to send?
-                if (tx.is_empty())
+                if (tx.prepare_next_packet_if_idle())
                 {
-                    // Let the application know it may send a packet.
-                    smooth::core::network::event::TransmitBufferEmptyEvent event(shared_from_this());
-                    cont->get_tx_empty()->push(event);
+                    write_data(cont);
                 }
                 else
                 {
-                    if (!tx.is_in_progress())
-                    {
-                        tx.prepare_next_packet();
-                    }
-
-                    if (tx.is_in_progress())
-                    {
-                        write_data(cont);
-                    }
+                    // Let the application know it may send a packet.
+                    smooth::core::network::event::TransmitBufferEmptyEvent event(shared_from_this());
+                    cont->get_tx_empty()->push(event);
                 }
             }
         }
@@ -333,43 +352,48 @@ namespace smooth::core::network
     {
         auto& rx = container->get_rx_buffer();
 
-        // How much data to assemble the current packet?
-        int wanted_length = rx.amount_wanted();
-
-        // Try to read the desired amount
-        ssize_t read_count = 0;
-        {
-            auto write_pos = rx.get_write_pos();
-            read_count = recv(socket_id, static_cast<void*>(write_pos), static_cast<size_t>(wanted_length), 0);
-        }
-
-        if (read_count == 0)
+        // Keep going while the protocol holds data for more packets, e.g. pipelined requests,
+        // as long as there is room for them.
+        do
         {
-            stop("Underlying socket closed (recv returned 0)");
-        }
-        else if (read_count < 0)
-        {
-            if (errno != EWOULDBLOCK)
+            // Read as much as the current packet wants, and hand it to the application if complete,
+            // while only locking the receive buffer once.
+            auto res = rx.receive([this](uint8_t* write_pos, int wanted_length) {
+                                      counters.add_receive_call();
+
+                                      return socket_cast(recv(socket_id,
+                                                              static_cast<void*>(write_pos),
+                                                              static_cast<size_t>(wanted_length),
+                                                              0));
+                                  },
+                                  [this, &container, &rx]() {
+                                      counters.add_packet_received();
+                                      event::DataAvailableEvent<Protocol> d(&rx);
+                                      container->get_data_available()->push(d);
+                                  });
+
+            if (res.read_count > 0 && !res.buffered)
             {
-                stop("Error during receive");
+                counters.add_received(res.read_count);
             }
-        }
-        else
-        {
-            rx.data_received(socket_cast(read_count));
 
-            if (rx.is_error())
+            if (res.read_count == 0)
             {
-                rx.prepare_new_packet();
-                stop("Assembly error");
+                stop("Underlying socket closed (recv returned 0)");
+            }
+            else if (res.read_count < 0)
+            {
+                if (errno != EWOULDBLOCK)
+                {
+                    stop("Error during receive");
+                }
             }
-            else if (rx.is_packet_complete())
+            else if (res.assembly_error)
             {
-                event::DataAvailableEvent<Protocol> d(&rx);
-                container->get_data_available()->push(d);
-                rx.prepare_new_packet();
+                stop("Assembly error");
             }
         }
+        while (is_active() && !rx.is_full() && rx.has_buffered_data());
 
         elapsed_receive_time.start();
     }
@@ -383,28 +407,46 @@ namespace smooth::core::network
         // is that send( id, some_data, some_length ) will be >= 1 and may or may not send the entire
         // packet.
         auto& tx = container->get_tx_buffer();
-        auto data_to_send = tx.get_data_to_send();
-        auto length = tx.get_remaining_data_length();
-        auto amount_sent = ::send(socket_id,
-                                  data_to_send,
-                                  static_cast<size_t>(length),
-                                  SEND_FLAGS);
-
-        if (amount_sent == -1)
+        std::size_t attempted = 0;
+        auto res = tx.send([this, &attempted](const uint8_t* data_to_send, int length, bool more_follows) {
+                               counters.add_send_call();
+                               attempted = static_cast<std::size_t>(length);
+
+                               return socket_cast(::send(socket_id,
+                                                         data_to_send,
+                                                         static_cast<size_t>(length),
+                                                         get_send_flags(more_follows)));
+                           },
+                           [this, &attempted](const FileRegion& file, std::size_t already_sent, std::size_t length) {
+                               // Limit each call so that a large file doesn't starve other sockets.
+                               attempted = std::min(length, max_file_send_size);
+
+                               return file.send_to(socket_id, already_sent, attempted);
+                           });
+
+        if (res.sent_count == -1)
         {
             stop("Failure during send");
         }
         else
         {
-            tx.data_has_been_sent(static_cast<int>(amount_sent));
+            counters.add_sent(res.sent_count);
 
             // Was a complete packet sent?
-            if (tx.is_in_progress())
+            if (!res.packet_complete)
             {
+                // Only a short send means the send buffer was full, not a file region sent in several parts.
+                if (static_cast<std::size_t>(res.sent_count) < attempted)
+                {
+                    counters.add_send_stall();
+                }
+
                 elapsed_send_time.start();
             }
             else
             {
+                counters.add_packet_sent();
+
                 // Let the application know it may now send another packet.
                 smooth::core::network::event::TransmitBufferEmptyEvent event(shared_from_this());
                 container->get_tx_empty()->push(event);
@@ -477,16 +519,22 @@ namespace smooth::core::network
     }
 
     template<typename Protocol, typename Packet>
-    void Socket<Protocol, Packet>::set_existing_socket(const std::shared_ptr<InetAddress>& address, int socket_id)
+    void Socket<Protocol, Packet>::set_existing_socket(const std::shared_ptr<InetAddress>& address,
+                                                       int socket_id,
+                                                       bool configured)
     {
         this->ip = address;
         this->socket_id = socket_id;
         active = true;
         connected = true;
-        set_non_blocking();
-        set_no_delay();
 
-        SocketDispatcher::instance().perform_op(SocketOperation::Op::AddActiveSocket, shared_from_this());
+        if (!configured)
+        {
+            set_non_blocking();
+            apply_socket_options();
+        }
+
+        SocketDispatcher::instance().add_active_socket(shared_from_this());
     }
 
     template<typename Protocol, typename Packet>
@@ -513,6 +561,11 @@ namespace smooth::core::network
         if (cont)
         {
             res = cont->get_tx_buffer().put(packet);
+
+            if (!res)
+            {
+                counters.add_tx_buffer_full();
+            }
         }
 
         return res;
@@ -17,10 +17,12 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <vector>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wsign-conversion"
@@ -33,6 +35,10 @@ limitations under the License.
 #include "NetworkStatus.h"
 #include "SocketOperation.h"
 #include "ISocketBackOff.h"
+#include "InetAddress.h"
+#include "SocketStatistics.h"
+#include "smooth/core/timer/ElapsedTime.h"
+#include "smooth/core/network/event/DnsResolvedEvent.h"
 
 namespace smooth::core::network
 {
@@ -43,6 +49,7 @@ namespace smooth::core::network
         : public smooth::core::Task,
         public smooth::core::ipc::IEventListener<NetworkStatus>,
         public smooth::core::ipc::IEventListener<SocketOperation>,
+        public smooth::core::ipc::IEventListener<event::DnsResolvedEvent>,
         private ISocketBackOff
     {
         public:
@@ -57,12 +64,27 @@ namespace smooth::core::network
 
             void perform_op(SocketOperation::Op op, std::shared_ptr<ISocket> socket);
 
+            /// Adds an already connected socket to the active sockets. When called from the dispatcher's own task,
+            /// as server sockets do when accepting connections, the socket is added immediately instead of
+            /// taking a round-trip through the operation queue.
+            void add_active_socket(std::shared_ptr<ISocket> socket);
+
+            /// Resolves the address of a socket using the DnsResolver, and starts the socket once resolved.
+            /// If the address can't be resolved, the socket reports that it is disconnected.
+            /// \param socket The socket to start.
+            /// \param address The address the socket is to be started with.
+            void resolve_and_start(std::shared_ptr<ISocket> socket, std::shared_ptr<InetAddress> address);
+
+            void init() override;
+
             void tick() override;
 
             void event(const NetworkStatus& event) override;
 
             void event(const SocketOperation& event) override;
 
+            void event(const event::DnsResolvedEvent& event) override;
+
         protected:
         private:
             SocketDispatcher();
@@ -73,6 +95,9 @@ namespace smooth::core::network
 
             void set_timeout();
 
+            /// Hands the dispatcher and socket counters over to SystemStatistics, once per statistics_interval.
+            void report_statistics();
+
             void restart_inactive_sockets();
 
             void remove_socket_from_collection(std::vector<std::shared_ptr<ISocket>>& col,
@@ -88,6 +113,8 @@ namespace smooth::core::network
 
             void remove_backed_off_socket(int socket_id);
 
+            void remove_resolving_socket(const std::shared_ptr<ISocket>& socket);
+
             void back_off(int socket_id, std::chrono::milliseconds duration) override;
 
             std::map<int, std::shared_ptr<ISocket>> active_sockets;
@@ -97,6 +124,13 @@ namespace smooth::core::network
             std::shared_ptr<NetworkEventQueue> network_events;
             using SocketOperationQueue = smooth::core::ipc::TaskEventQueue<SocketOperation>;
             std::shared_ptr<SocketOperationQueue> socket_op;
+            using DnsEventQueue = smooth::core::ipc::TaskEventQueue<event::DnsResolvedEvent>;
+            std::shared_ptr<DnsEventQueue> dns_events;
+            std::vector<std::pair<std::shared_ptr<InetAddress>, std::shared_ptr<ISocket>>> resolving_sockets{};
+            std::atomic<std::thread::id> dispatcher_thread{};
+            DispatcherStats stats{};
+            smooth::core::timer::ElapsedTime statistics_timer{};
+            static constexpr std::chrono::seconds statistics_interval{ 1 };
 
             static void set_fd(FD socket_id, fd_set& fd);
 
@@ -105,6 +139,9 @@ namespace smooth::core::network
             fd_set read_set{};
             fd_set write_set{};
             timeval tv{};
+
+            /// Sockets holding received data select() doesn't know about, see ISocket::has_buffered_data().
+            std::vector<int> buffered_sockets{};
             bool has_ip = false;
             static constexpr const char* tag = "SocketDispatcher";
             std::unordered_map<int, std::chrono::steady_clock::time_point> backed_off{};
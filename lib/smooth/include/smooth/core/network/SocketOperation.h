@@ -17,6 +17,9 @@ limitations under the License.
 
 #pragma once
 
+#include <memory>
+#include "smooth/core/network/InetAddress.h"
+
 namespace smooth::core::network
 {
     class SocketOperation
@@ -26,13 +29,16 @@ namespace smooth::core::network
             {
                 Start,
                 Stop,
-                AddActiveSocket
+                AddActiveSocket,
+                ResolveAndStart
             };
 
             SocketOperation() = default;
 
-            SocketOperation(Op op, std::shared_ptr<core::network::ISocket> sock)
-                    : op(op), sock(std::move(sock))
+            SocketOperation(Op op,
+                            std::shared_ptr<core::network::ISocket> sock,
+                            std::shared_ptr<core::network::InetAddress> address = nullptr)
+                    : op(op), sock(std::move(sock)), address(std::move(address))
             {
             }
 
@@ -46,8 +52,15 @@ namespace smooth::core::network
                 return sock;
             }
 
+            /// Returns the address to resolve, for Op::ResolveAndStart.
+            [[nodiscard]] std::shared_ptr<core::network::InetAddress> get_address() const
+            {
+                return address;
+            }
+
         private:
             Op op = Op::Stop;
             std::shared_ptr<core::network::ISocket> sock{};
+            std::shared_ptr<core::network::InetAddress> address{};
     };
 }
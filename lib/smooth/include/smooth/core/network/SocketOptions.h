@@ -0,0 +1,60 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+namespace smooth::core::network
+{
+    /// Tuning options applied to a socket when it is created or accepted. The defaults give the same
+    /// behavior as a socket without options. Options not supported by the platform are ignored.
+    struct SocketOptions
+    {
+        /// Size of the kernel send buffer (SO_SNDBUF) in bytes, 0 to keep the system default.
+        int send_buffer_size = 0;
+
+        /// Size of the kernel receive buffer (SO_RCVBUF) in bytes, 0 to keep the system default.
+        /// On a server socket this is applied before listening so that it affects the window scaling
+        /// of accepted connections.
+        int receive_buffer_size = 0;
+
+        /// Disable Nagle's algorithm (TCP_NODELAY).
+        bool no_delay = true;
+
+        /// Enable TCP keepalive probes (SO_KEEPALIVE), letting the stack detect dead peers without
+        /// any application traffic.
+        bool keep_alive = false;
+
+        /// Idle time, in seconds, before the first keepalive probe is sent. 0 to keep the system default.
+        int keep_alive_idle = 0;
+
+        /// Time, in seconds, between keepalive probes. 0 to keep the system default.
+        int keep_alive_interval = 0;
+
+        /// Number of unanswered keepalive probes before the connection is dropped. 0 to keep the system default.
+        int keep_alive_count = 0;
+
+        /// When set, data is sent with MSG_MORE as long as more data of the current packet (such as a file
+        /// region following the headers) or further packets are queued, letting the stack coalesce them
+        /// into full segments instead of sending each part on its own.
+        bool coalesce_writes = false;
+
+        /// Enable TCP Fast Open (Linux only). On a server socket this is the length of the queue of
+        /// pending Fast Open requests; on a client socket any value > 0 lets the request data of a reconnect
+        /// be carried in the SYN. 0 disables Fast Open.
+        int fast_open = 0;
+    };
+}
@@ -0,0 +1,147 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace smooth::core::network
+{
+    /// A snapshot of the I/O counters of a socket.
+    struct SocketStats
+    {
+        int socket_id = -1;
+        /// Host and port of the remote endpoint, or the bound address for server sockets.
+        std::string address{};
+        bool is_server = false;
+        uint64_t bytes_received = 0;
+        uint64_t bytes_sent = 0;
+        uint64_t packets_received = 0;
+        uint64_t packets_sent = 0;
+        /// Number of times the kernel send buffer was full, leaving a packet partially sent.
+        uint64_t send_stalls = 0;
+        /// Number of times the transmit buffer was full when the application tried to send a packet.
+        uint64_t tx_buffer_full = 0;
+        /// Number of times the socket dispatcher has backed off from the socket.
+        uint64_t back_offs = 0;
+        /// Number of recv() and send() calls made on the socket.
+        uint64_t receive_calls = 0;
+        uint64_t send_calls = 0;
+    };
+
+    /// Live I/O counters of a socket. They are mostly updated by the socket dispatcher, but also by the
+    /// application when sending, so they are atomic. Relaxed ordering is enough as they are only ever summed up.
+    class SocketCounters
+    {
+        public:
+            void add_received(int bytes)
+            {
+                bytes_received.fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+            }
+
+            void add_sent(int bytes)
+            {
+                bytes_sent.fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+            }
+
+            void add_packet_received()
+            {
+                packets_received.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void add_packet_sent()
+            {
+                packets_sent.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void add_send_stall()
+            {
+                send_stalls.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void add_tx_buffer_full()
+            {
+                tx_buffer_full.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void add_back_off()
+            {
+                back_offs.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void add_receive_call()
+            {
+                receive_calls.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void add_send_call()
+            {
+                send_calls.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /// Copies the counters into a snapshot.
+            void copy_to(SocketStats& stats) const
+            {
+                stats.bytes_received = bytes_received.load(std::memory_order_relaxed);
+                stats.bytes_sent = bytes_sent.load(std::memory_order_relaxed);
+                stats.packets_received = packets_received.load(std::memory_order_relaxed);
+                stats.packets_sent = packets_sent.load(std::memory_order_relaxed);
+                stats.send_stalls = send_stalls.load(std::memory_order_relaxed);
+                stats.tx_buffer_full = tx_buffer_full.load(std::memory_order_relaxed);
+                stats.back_offs = back_offs.load(std::memory_order_relaxed);
+                stats.receive_calls = receive_calls.load(std::memory_order_relaxed);
+                stats.send_calls = send_calls.load(std::memory_order_relaxed);
+            }
+
+        private:
+            std::atomic<uint64_t> bytes_received{ 0 };
+            std::atomic<uint64_t> bytes_sent{ 0 };
+            std::atomic<uint64_t> packets_received{ 0 };
+            std::atomic<uint64_t> packets_sent{ 0 };
+            std::atomic<uint64_t> send_stalls{ 0 };
+            std::atomic<uint64_t> tx_buffer_full{ 0 };
+            std::atomic<uint64_t> back_offs{ 0 };
+            std::atomic<uint64_t> receive_calls{ 0 };
+            std::atomic<uint64_t> send_calls{ 0 };
+    };
+
+    /// A snapshot of the counters of the socket dispatcher loop, accumulated since start.
+    struct DispatcherStats
+    {
+        /// Number of iterations of the dispatcher loop.
+        uint64_t iterations = 0;
+        /// Number of times select() returned with at least one ready socket.
+        uint64_t wakeups = 0;
+        /// Total number of ready sockets over all wakeups.
+        uint64_t ready_fds = 0;
+        /// Largest number of ready sockets in a single wakeup.
+        uint32_t max_ready_fds = 0;
+        std::size_t active_sockets = 0;
+        /// Time spent blocked in select().
+        std::chrono::microseconds select_time{ 0 };
+        /// Time spent in the sockets' readable() and writable() respectively.
+        std::chrono::microseconds readable_time{ 0 };
+        std::chrono::microseconds writable_time{ 0 };
+
+        [[nodiscard]] double ready_fds_per_wakeup() const
+        {
+            return wakeups == 0 ? 0.0 : static_cast<double>(ready_fds) / static_cast<double>(wakeups);
+        }
+    };
+}
@@ -0,0 +1,76 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <mbedtls/ssl.h>
+#include "smooth/core/network/SocketStatistics.h"
+
+namespace smooth::core::network
+{
+    /// The I/O callbacks through which mbedTLS moves ciphertext to and from a socket.
+    /// mbedTLS asks for the header and the body of each record separately; rather than one recv() for
+    /// each, as much as is available, up to the size of the read-ahead buffer, is received at once and
+    /// following requests are served from the buffer.
+    class TlsBio
+    {
+        public:
+            /// \param socket_id The id of the socket. Read on each call since it changes when the socket is started.
+            /// \param counters Counters to count recv() and send() calls on.
+            TlsBio(const int& socket_id, SocketCounters& counters)
+                    : socket_id(socket_id),
+                      counters(counters)
+            {
+            }
+
+            TlsBio(const TlsBio&) = delete;
+
+            TlsBio& operator=(const TlsBio&) = delete;
+
+            /// Makes an mbedTLS context do its I/O through this object.
+            void attach(mbedtls_ssl_context* ssl);
+
+            /// Returns a value indicating if there is received data in the read-ahead buffer, data
+            /// that select() does not report.
+            [[nodiscard]] bool has_buffered_data() const
+            {
+                return position < end;
+            }
+
+            static int send(void* ctx, const unsigned char* buf, size_t len);
+
+            static int recv(void* ctx, unsigned char* buf, size_t len);
+
+        private:
+#ifdef ESP_PLATFORM
+            static constexpr std::size_t read_ahead_size = 1536;
+#else
+            static constexpr std::size_t read_ahead_size = 4096;
+#endif
+
+            int receive(unsigned char* buf, size_t len);
+
+            const int& socket_id;
+            SocketCounters& counters;
+            std::vector<unsigned char> read_ahead{};
+            std::size_t position = 0;
+            std::size_t end = 0;
+    };
+}
@@ -0,0 +1,100 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "smooth/core/Task.h"
+#include "smooth/core/ipc/TaskEventQueue.h"
+
+namespace smooth::core::network
+{
+    /// Implemented by sockets whose TLS handshake is run by the TlsHandshakeWorker.
+    class ITlsHandshake
+    {
+        public:
+            virtual ~ITlsHandshake() = default;
+
+            /// Runs handshake steps until the handshake has to wait for the peer, has completed or has failed.
+            /// Called on the TlsHandshakeWorker's task.
+            virtual void run_handshake() = 0;
+    };
+
+    /// A request to run a handshake, see TlsHandshakeWorker.
+    class TlsHandshakeRequest
+    {
+        public:
+            TlsHandshakeRequest() = default;
+
+            explicit TlsHandshakeRequest(std::weak_ptr<ITlsHandshake> handshake)
+                    : handshake(std::move(handshake))
+            {
+            }
+
+            [[nodiscard]] const std::weak_ptr<ITlsHandshake>& get_handshake() const
+            {
+                return handshake;
+            }
+
+        private:
+            std::weak_ptr<ITlsHandshake> handshake{};
+    };
+
+    /// The TlsHandshakeWorker runs the CPU heavy parts of TLS handshakes, i.e. the key exchange
+    /// and signature operations, on its own task so that the SocketDispatcher keeps servicing
+    /// established connections while a new one is being set up. The task runs on a lower priority
+    /// than the SocketDispatcher, letting the dispatcher preempt it.
+    /// Room is made for the handshakes of CONFIG_LWIP_MAX_SOCKETS sockets, plus what servers reserve
+    /// for the clients of their pools.
+    class TlsHandshakeWorker
+        : private smooth::core::Task,
+        public smooth::core::ipc::IEventListener<TlsHandshakeRequest>
+    {
+        public:
+            static TlsHandshakeWorker& instance();
+
+            /// Makes room for more handshakes to be queued at the same time.
+            /// \param count Number of handshakes, e.g. the maximum size of a server's client pool.
+            void reserve(int count);
+
+            /// Gives back room made by reserve().
+            void release(int count);
+
+            /// Queues a handshake to be run. The handshake is skipped if it has been
+            /// destroyed by the time it is up.
+            /// \return true if queued, false if there is no room for it.
+            [[nodiscard]] bool perform(std::weak_ptr<ITlsHandshake> handshake);
+
+            void event(const TlsHandshakeRequest& request) override;
+
+        private:
+            TlsHandshakeWorker();
+
+            bool take_next(TlsHandshakeRequest& request);
+
+            std::mutex guard{};
+            std::deque<TlsHandshakeRequest> pending{};
+            std::size_t capacity;
+
+            /// Wakes the task up when handshakes are queued. A single request is enough as the task
+            /// runs all queued handshakes each time it is woken up.
+            using WakeUpQueue = smooth::core::ipc::TaskEventQueue<TlsHandshakeRequest>;
+            std::shared_ptr<WakeUpQueue> wake_up;
+    };
+}
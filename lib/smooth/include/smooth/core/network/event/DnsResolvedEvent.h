@@ -0,0 +1,64 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include "smooth/core/network/InetAddress.h"
+
+namespace smooth::core::network::event
+{
+    /// Event sent by the DnsResolver when the resolution of an address has completed.
+    class DnsResolvedEvent
+    {
+        public:
+            DnsResolvedEvent() = default;
+
+            DnsResolvedEvent(const DnsResolvedEvent&) = default;
+
+            /// Constructor
+            /// \param address The address that was requested to be resolved.
+            /// \param resolved The copy of the address that holds the result, see InetAddress::assign().
+            DnsResolvedEvent(std::shared_ptr<InetAddress> address, std::shared_ptr<InetAddress> resolved)
+                    : address(std::move(address)),
+                      resolved(std::move(resolved))
+            {
+            }
+
+            /// Returns the address that was requested to be resolved.
+            [[nodiscard]] const std::shared_ptr<InetAddress>& get_address() const
+            {
+                return address;
+            }
+
+            /// Returns the copy of the address that holds the result.
+            [[nodiscard]] const std::shared_ptr<InetAddress>& get_resolved() const
+            {
+                return resolved;
+            }
+
+            /// Returns a value indicating if the address could be resolved.
+            [[nodiscard]] bool is_resolved() const
+            {
+                return resolved && resolved->is_valid();
+            }
+
+        private:
+            std::shared_ptr<InetAddress> address{};
+            std::shared_ptr<InetAddress> resolved{};
+    };
+}
@@ -0,0 +1,191 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace smooth::core::util
+{
+    /// A FIFO buffer with a depth set at runtime. Unlike CircularBuffer it never overwrites
+    /// unread data; put() fails when the buffer is full, leaving it up to the caller to apply backpressure.
+    /// Items are held in a ring of depth slots, allocated up front. If max_depth is larger than initial_depth,
+    /// the ring is reallocated with twice the depth (up to max_depth) whenever it fills up, and reallocated
+    /// with initial_depth slots, releasing the memory used, once the buffer has been drained. Not thread-safe.
+    /// \tparam T The type of item to hold, must be default constructible and move assignable.
+    template<typename T>
+    class AdaptiveBuffer
+    {
+        public:
+            /// Constructor
+            /// \param initial_depth The number of items the buffer holds before it has to grow, at least 1.
+            /// \param max_depth The maximum number of items the buffer may grow to. If less than initial_depth,
+            /// initial_depth is used, i.e. the depth is fixed.
+            AdaptiveBuffer(int initial_depth, int max_depth)
+            {
+                set_depth(initial_depth, max_depth);
+            }
+
+            AdaptiveBuffer(const AdaptiveBuffer&) = delete;
+
+            AdaptiveBuffer& operator=(const AdaptiveBuffer&) = delete;
+
+            /// Puts an item on the buffer, growing it if needed and allowed.
+            /// \param item The item to put on the buffer
+            /// \return true on success, false if the buffer is full.
+            bool put(const T& item)
+            {
+                if (count == slots.size())
+                {
+                    if (get_depth() >= max_depth)
+                    {
+                        return false;
+                    }
+
+                    resize(std::min(get_depth() * 2, max_depth));
+                }
+
+                slots[(first + count) % slots.size()] = item;
+                ++count;
+
+                return true;
+            }
+
+            /// Gets the oldest item from the buffer.
+            /// \param item Assigned the item taken from the buffer.
+            /// \return true on success, false if the buffer is empty.
+            bool get(T& item)
+            {
+                bool res = count > 0;
+
+                if (res)
+                {
+                    item = std::move(slots[first]);
+                    release_oldest(1);
+                }
+
+                return res;
+            }
+
+            /// Gives access to an item without removing it from the buffer.
+            /// \param index Position of the item, 0 being the oldest. Must be less than available_items().
+            [[nodiscard]] T& peek(int index)
+            {
+                return slots[(first + static_cast<std::size_t>(index)) % slots.size()];
+            }
+
+            [[nodiscard]] const T& peek(int index) const
+            {
+                return slots[(first + static_cast<std::size_t>(index)) % slots.size()];
+            }
+
+            /// Removes the oldest items from the buffer.
+            /// \param amount The number of items to remove. If larger than available_items() the buffer is emptied.
+            void drop(int amount)
+            {
+                release_oldest(std::min(static_cast<std::size_t>(std::max(0, amount)), count));
+            }
+
+            /// Returns a value indicating if the buffer is empty.
+            [[nodiscard]] bool is_empty() const
+            {
+                return count == 0;
+            }
+
+            /// Returns a value indicating if the buffer is full, i.e. it can't accept more items even by growing.
+            [[nodiscard]] bool is_full() const
+            {
+                return available_items() >= max_depth;
+            }
+
+            /// Returns the number of items in the buffer.
+            [[nodiscard]] int available_items() const
+            {
+                return static_cast<int>(count);
+            }
+
+            /// Returns the current depth of the buffer, i.e. the number of slots allocated.
+            [[nodiscard]] int get_depth() const
+            {
+                return static_cast<int>(slots.size());
+            }
+
+            /// Returns the depth the buffer may grow to.
+            [[nodiscard]] int get_max_depth() const
+            {
+                return max_depth;
+            }
+
+            /// Changes the depth of the buffer. Items already in the buffer are kept, even if they exceed the new depth.
+            /// \param initial The number of items the buffer holds before it has to grow, at least 1.
+            /// \param max The maximum number of items the buffer may grow to.
+            void set_depth(int initial, int max)
+            {
+                initial_depth = std::max(1, initial);
+                max_depth = std::max(initial_depth, max);
+                resize(std::clamp(available_items(), initial_depth, max_depth));
+            }
+
+            /// Clears the buffer and releases the memory used.
+            void clear()
+            {
+                count = 0;
+                resize(initial_depth);
+            }
+
+        private:
+            /// Moves the items into a new ring of the given depth, or of the number of items if that is larger.
+            void resize(int depth)
+            {
+                std::vector<T> resized(std::max(static_cast<std::size_t>(depth), count));
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    resized[i] = std::move(slots[(first + i) % slots.size()]);
+                }
+
+                slots = std::move(resized);
+                first = 0;
+            }
+
+            void release_oldest(std::size_t amount)
+            {
+                for (std::size_t i = 0; i < amount; ++i)
+                {
+                    // Release whatever memory the item holds, the slot is kept.
+                    slots[first] = T{};
+                    first = (first + 1) % slots.size();
+                }
+
+                count -= amount;
+
+                if (count == 0 && get_depth() > initial_depth)
+                {
+                    // Burst is over, shrink back.
+                    resize(initial_depth);
+                }
+            }
+
+            std::vector<T> slots{};
+            std::size_t first = 0;
+            std::size_t count = 0;
+            int initial_depth = 1;
+            int max_depth = 1;
+    };
+}
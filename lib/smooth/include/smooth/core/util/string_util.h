@@ -20,6 +20,7 @@ limitations under the License.
 #include <utility>
 #include <algorithm>
 #include <string>
+#include <string_view>
 #include <functional>
 #include "split.h"
 
@@ -76,14 +77,14 @@ namespace smooth::core::string_util
     }
 
     /// \brief Checks if 'to_find' exists in 's', case insensitive.
-    bool icontains(const std::string& s, const std::string& to_find);
+    bool icontains(std::string_view s, std::string_view to_find);
 
     /// \brief Replaces 'token' with 'replacement' in 's'
     void replace_all(std::string& s, const std::string& token, const std::string& replacement);
 
     /// \brief Compares s with s2, case sensitive.
-    int equals(const std::string& s, const std::string& s2);
+    bool equals(std::string_view s, std::string_view s2);
 
     /// \brief Compares s with s2, case insensitive.
-    int iequals(const std::string& s, const std::string& s2);
+    bool iequals(std::string_view s, std::string_view s2);
 }
@@ -0,0 +1,179 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "AcceptBenchmark.h"
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "smooth/core/logging/log.h"
+#include "Benchmark.h"
+
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace linux_benchmarks
+{
+    static constexpr int burst = 32;
+    static constexpr uint64_t connections_per_burst = static_cast<uint64_t>(burst);
+    static constexpr uint64_t bursts = 1'000;
+
+    /// Creates a non-blocking listening socket bound to an ephemeral port on the loopback interface.
+    static int create_listening_socket(sockaddr_in& addr)
+    {
+        int s = socket(AF_INET, SOCK_STREAM, 0);
+        addr = sockaddr_in{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof(addr);
+
+        int no_delay = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+
+        bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        getsockname(s, reinterpret_cast<sockaddr*>(&addr), &len);
+        listen(s, burst * 2);
+
+        return s;
+    }
+
+    /// Fills the backlog of the listening socket with a burst of connections.
+    static void connect_burst(const sockaddr_in& addr, std::array<int, burst>& clients)
+    {
+        for (auto& c : clients)
+        {
+            c = socket(AF_INET, SOCK_STREAM, 0);
+
+            // Reset on close so that the benchmark doesn't run out of ports due to TIME_WAIT.
+            linger l{ 1, 0 };
+            setsockopt(c, SOL_SOCKET, SO_LINGER, &l, sizeof(l));
+            connect(c, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+        }
+    }
+
+    static void close_all(std::array<int, burst>& sockets, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            close(sockets[static_cast<std::size_t>(i)]);
+        }
+    }
+
+    static bool wait_readable(int s)
+    {
+        fd_set read_set;
+        FD_ZERO(&read_set);
+        FD_SET(s, &read_set);
+        timeval tv{ 0, 10000 };
+
+        return select(s + 1, &read_set, nullptr, nullptr, &tv) > 0;
+    }
+
+    /// Accepts a single connection per wakeup and then configures it, like ServerSocket used to.
+    static int accept_per_readiness(int listener, std::array<int, burst>& accepted)
+    {
+        int count = 0;
+
+        while (count < burst && wait_readable(listener))
+        {
+            auto s = accept(listener, nullptr, nullptr);
+
+            if (s >= 0)
+            {
+                fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+                int no_delay = 1;
+                setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+                accepted[static_cast<std::size_t>(count++)] = s;
+            }
+        }
+
+        return count;
+    }
+
+    /// Drains the backlog after a single wakeup, accepted sockets inherit the options of the listening socket.
+    static int accept_batched(int listener, std::array<int, burst>& accepted)
+    {
+        int count = 0;
+
+        while (count < burst && wait_readable(listener))
+        {
+            int s;
+
+            while (count < burst && (s = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+            {
+                accepted[static_cast<std::size_t>(count++)] = s;
+            }
+        }
+
+        return count;
+    }
+
+    template<typename Accept>
+    static void measure(const char* name, int listener, const sockaddr_in& addr, Accept&& accept_func)
+    {
+        std::array<int, burst> clients{};
+        std::array<int, burst> accepted{};
+        nanoseconds total{ 0 };
+        uint64_t missing = 0;
+
+        for (uint64_t i = 0; i < bursts; ++i)
+        {
+            connect_burst(addr, clients);
+
+            // Time from the burst having arrived until the last connection has been accepted.
+            auto start = steady_clock::now();
+            auto count = accept_func(listener, accepted);
+            total += duration_cast<nanoseconds>(steady_clock::now() - start);
+
+            missing += static_cast<uint64_t>(burst - count);
+            close_all(accepted, count);
+            close_all(clients, burst);
+        }
+
+        print_result(name, bursts * connections_per_burst, total.count());
+
+        if (missing > 0)
+        {
+            Log::warning("Benchmarks", "{}: {} connections not accepted", name, missing);
+        }
+    }
+
+    void accept_benchmark()
+    {
+        sockaddr_in addr{};
+        int listener = create_listening_socket(addr);
+
+        if (listener < 0)
+        {
+            Log::error("Benchmarks", "Could not setup listening socket: {}", strerror(errno));
+        }
+        else
+        {
+            measure("accept_per_readiness", listener, addr, accept_per_readiness);
+            measure("accept_batched", listener, addr, accept_batched);
+        }
+
+        close(listener);
+    }
+}
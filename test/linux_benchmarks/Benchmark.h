@@ -0,0 +1,68 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace linux_benchmarks
+{
+    /// Prints the result of a benchmark as a single machine readable line on the form:
+    /// BENCH <name> iterations=<count> total_ns=<ns> ns_per_op=<ns> ops_per_s=<count>
+    /// \param name Name of the benchmark
+    /// \param operations Number of operations performed
+    /// \param total_ns Time spent performing the operations
+    inline void print_result(const char* name, uint64_t operations, int64_t total_ns)
+    {
+        auto ns_per_op = static_cast<double>(total_ns) / static_cast<double>(operations);
+
+        printf("BENCH %s iterations=%llu total_ns=%lld ns_per_op=%.2f ops_per_s=%.0f\n",
+               name,
+               static_cast<unsigned long long>(operations),
+               static_cast<long long>(total_ns),
+               ns_per_op,
+               1e9 / ns_per_op);
+    }
+
+    /// Runs func 'iterations' times, after a short warm-up, and prints the result using print_result().
+    /// \param name Name of the benchmark
+    /// \param iterations Number of times to call func
+    /// \param func The operation to measure
+    /// \param ops_per_iteration Number of operations performed by each call to func, e.g. datagrams per burst.
+    template<typename Func>
+    void run_benchmark(const char* name, uint64_t iterations, Func&& func, uint64_t ops_per_iteration = 1)
+    {
+        for (uint64_t i = 0; i < iterations / 10; ++i)
+        {
+            func();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            func();
+        }
+
+        auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        print_result(name, iterations * ops_per_iteration, total);
+    }
+}
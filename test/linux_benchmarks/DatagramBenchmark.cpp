@@ -0,0 +1,120 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "DatagramBenchmark.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/DatagramBatch.h"
+#include "Benchmark.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::core::network;
+
+namespace linux_benchmarks
+{
+    static constexpr int datagram_size = 64;
+    static constexpr int burst = DatagramBatch::default_batch_size;
+    static constexpr uint64_t datagrams_per_burst = static_cast<uint64_t>(burst);
+    static constexpr uint64_t bursts = 50'000;
+
+    /// Creates a non-blocking UDP socket bound to an ephemeral port on the loopback interface.
+    static int create_bound_socket(sockaddr_in& addr)
+    {
+        int s = socket(AF_INET, SOCK_DGRAM, 0);
+        addr = sockaddr_in{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof(addr);
+
+        // A receive buffer large enough to hold a whole burst.
+        int size = 1024 * 1024;
+        setsockopt(s, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+
+        bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        getsockname(s, reinterpret_cast<sockaddr*>(&addr), &len);
+
+        return s;
+    }
+
+    static bool connect_to(int s, const sockaddr_in& addr)
+    {
+        return connect(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+    }
+
+    void datagram_benchmark()
+    {
+        sockaddr_in sender_addr{};
+        sockaddr_in receiver_addr{};
+        int sender = create_bound_socket(sender_addr);
+        int receiver = create_bound_socket(receiver_addr);
+
+        if (sender < 0 || receiver < 0 || !connect_to(sender, receiver_addr) || !connect_to(receiver, sender_addr))
+        {
+            Log::error("Benchmarks", "Could not setup UDP sockets: {}", strerror(errno));
+        }
+        else
+        {
+            std::array<uint8_t, datagram_size> out{};
+            std::array<uint8_t, datagram_size> in{};
+            uint64_t lost = 0;
+
+            // Loopback delivers the datagrams during send() so a whole burst can be read back right away.
+            run_benchmark("udp_per_datagram", bursts, [&]() {
+                              for (int i = 0; i < burst; ++i)
+                              {
+                                  send(sender, out.data(), out.size(), 0);
+                              }
+
+                              for (int i = 0; i < burst; ++i)
+                              {
+                                  lost += recv(receiver, in.data(), in.size(), 0) == datagram_size ? 0U : 1U;
+                              }
+                          }, datagrams_per_burst);
+
+            DatagramBatch tx{ datagram_size };
+            DatagramBatch rx{ datagram_size };
+
+            run_benchmark("udp_batched", bursts, [&]() {
+                              for (int i = 0; i < burst; ++i)
+                              {
+                                  tx.stage(out.data(), datagram_size);
+                              }
+
+                              auto sent = tx.send(sender, 0);
+                              auto received = rx.receive(receiver, burst);
+                              lost += static_cast<uint64_t>(std::max(0, sent - received));
+                          }, datagrams_per_burst);
+
+            if (lost > 0)
+            {
+                Log::warning("Benchmarks", "{} datagrams lost", lost);
+            }
+        }
+
+        close(sender);
+        close(receiver);
+    }
+}
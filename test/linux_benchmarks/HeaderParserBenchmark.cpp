@@ -0,0 +1,187 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "HeaderParserBenchmark.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+#include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
+#include "smooth/core/util/string_util.h"
+#include "smooth/core/logging/log.h"
+#include "Benchmark.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::core;
+using namespace smooth::core::logging;
+
+namespace linux_benchmarks
+{
+    static constexpr uint64_t iterations = 200'000;
+
+    static const char* request = "GET /api/device/42/settings?fields=name,state HTTP/1.1\r\n"
+                                 "Host: smooth.local:8080\r\n"
+                                 "Connection: keep-alive\r\n"
+                                 "Cache-Control: max-age=0\r\n"
+                                 "Upgrade-Insecure-Requests: 1\r\n"
+                                 "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                                 "(KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36\r\n"
+                                 "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,"
+                                 "image/avif,image/webp,*/*;q=0.8\r\n"
+                                 "Referer: http://smooth.local:8080/index.html\r\n"
+                                 "Accept-Encoding: gzip, deflate, br\r\n"
+                                 "Accept-Language: en-US,en;q=0.9,sv;q=0.8\r\n"
+                                 "Cookie: session=0123456789abcdef0123456789abcdef; theme=dark\r\n"
+                                 "If-None-Match: \"5f3e2a1b-4c2\"\r\n"
+                                 "If-Modified-Since: Wed, 21 Oct 2015 07:28:00 GMT\r\n"
+                                 "DNT: 1\r\n"
+                                 "Sec-Fetch-Dest: document\r\n"
+                                 "Sec-Fetch-Mode: navigate\r\n"
+                                 "Sec-Fetch-Site: same-origin\r\n"
+                                 "\r\n";
+
+    /// The parsing done by RegularHTTPProtocol before HTTPHeaderParser was introduced.
+    class LegacyParser
+    {
+        public:
+            void parse(const std::vector<uint8_t>& data, std::unordered_map<std::string, std::string>& headers)
+            {
+                std::stringstream ss;
+
+                std::for_each(data.cbegin(), data.cend(), [&ss](auto& c) {
+                                  if (c != '\n')
+                                  {
+                                      ss << static_cast<char>(c);
+                                  }
+                              });
+
+                std::string s;
+
+                while (std::getline(ss, s, '\r'))
+                {
+                    if (!s.empty())
+                    {
+                        auto colon = std::find(s.begin(), s.end(), ':');
+
+                        if (colon == s.end())
+                        {
+                            std::smatch m;
+
+                            if (std::regex_match(s, m, request_line))
+                            {
+                                method = m[1].str();
+                                url = m[2].str();
+                                version = m[3].str();
+                            }
+                        }
+                        else if (std::distance(colon, s.end()) > 2)
+                        {
+                            auto& curr_header = headers[string_util::to_lower_copy({ s.begin(), colon })];
+
+                            if (curr_header.empty())
+                            {
+                                curr_header = { colon + 2, s.end() };
+                            }
+                            else
+                            {
+                                curr_header.append(", ").append({ colon + 2, s.end() });
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::string method{};
+            std::string url{};
+            std::string version{};
+
+        private:
+            const std::regex request_line{ R"!((.+)\ (.+)\ HTTP\/(\d\.\d))!" };
+    };
+
+    class NullResponse
+        : public IServerResponse, public IUpgradeToWebsocket
+    {
+        public:
+            void reply(std::unique_ptr<IResponseOperation>, bool) override
+            {
+            }
+
+            void reply_error(std::unique_ptr<IResponseOperation>) override
+            {
+            }
+
+            void upgrade_to_websocket() override
+            {
+            }
+
+        protected:
+            smooth::core::Task& get_task() override
+            {
+                // Never called, there are no websocket upgrades in the benchmark.
+                std::abort();
+            }
+
+            void upgrade_to_websocket_internal() override
+            {
+            }
+    };
+
+    void header_parser_benchmark()
+    {
+        const auto length = strlen(request);
+        const std::vector<uint8_t> data{ request, request + length };
+        int64_t sum = 0;
+
+        // The regular expressions were compiled once per connection, not per request.
+        LegacyParser legacy{};
+
+        run_benchmark("http_headers_stringstream_regex", iterations, [&]() {
+                          std::unordered_map<std::string, std::string> headers{};
+                          legacy.parse(data, headers);
+                          sum += static_cast<int64_t>(headers.size() + legacy.url.size());
+                      });
+
+        // Like RegularHTTPProtocol, a new parser and packet per request.
+        run_benchmark("http_headers_parser", iterations, [&]() {
+                          HTTPHeaderParser parser{};
+                          HeaderMap headers{};
+                          parser.parse({ request, length - 2 }, headers);
+                          sum += static_cast<int64_t>(headers.size() + parser.url().size());
+                      });
+
+        NullResponse response{};
+        RegularHTTPProtocol protocol{ 4096, 4096, response, response };
+
+        run_benchmark("http_headers_protocol", iterations, [&]() {
+                          HTTPPacket packet{};
+                          auto wanted = protocol.get_wanted_amount(packet);
+                          auto amount = std::min(static_cast<std::size_t>(wanted), length);
+                          memcpy(protocol.get_write_pos(packet), request, amount);
+                          protocol.data_received(packet, static_cast<int>(amount));
+                          sum += protocol.is_complete(packet) && packet.get_request_method() ? 1 : 0;
+                          protocol.packet_consumed();
+                      });
+
+        Log::debug("Benchmarks", "Header checksum {}", sum);
+    }
+}
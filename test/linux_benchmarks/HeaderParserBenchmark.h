@@ -0,0 +1,26 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+namespace linux_benchmarks
+{
+    /// Measures requests per second when parsing the headers of a browser-like request, comparing
+    /// the stringstream and regex based parsing RegularHTTPProtocol used to do with HTTPHeaderParser,
+    /// and running the request through RegularHTTPProtocol itself.
+    void header_parser_benchmark();
+}
@@ -0,0 +1,193 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "PacketBufferBenchmark.h"
+#include <array>
+#include <cstring>
+#include "smooth/core/network/IPacketAssembly.h"
+#include "smooth/core/network/IPacketDisassembly.h"
+#include "smooth/core/network/PacketReceiveBuffer.h"
+#include "smooth/core/network/PacketSendBuffer.h"
+#include "Benchmark.h"
+
+using namespace smooth::core::network;
+
+namespace linux_benchmarks
+{
+    static constexpr int packet_size = 64;
+    static constexpr uint64_t iterations = 2'000'000;
+
+    class BenchPacket
+        : public IPacketDisassembly
+    {
+        public:
+            int get_send_length() override
+            {
+                return packet_size;
+            }
+
+            const uint8_t* get_data() override
+            {
+                return data.data();
+            }
+
+            std::array<uint8_t, packet_size> data{};
+            int received = 0;
+    };
+
+    /// Fixed size packets, delivered in one piece.
+    class BenchProtocol
+        : public IPacketAssembly<BenchProtocol, BenchPacket>
+    {
+        public:
+            using packet_type = BenchPacket;
+
+            int get_wanted_amount(BenchPacket& packet) override
+            {
+                return packet_size - packet.received;
+            }
+
+            void data_received(BenchPacket& packet, int length) override
+            {
+                packet.received += length;
+            }
+
+            uint8_t* get_write_pos(BenchPacket& packet) override
+            {
+                return packet.data.data() + packet.received;
+            }
+
+            bool is_complete(BenchPacket& packet) const override
+            {
+                return packet.received == packet_size;
+            }
+
+            bool is_error() override
+            {
+                return false;
+            }
+
+            void packet_consumed() override
+            {
+            }
+
+            void reset() override
+            {
+            }
+    };
+
+    static std::array<uint8_t, packet_size> wire{};
+
+    static int fake_recv(uint8_t* write_pos, int wanted_length)
+    {
+        memcpy(write_pos, wire.data(), static_cast<size_t>(wanted_length));
+
+        return wanted_length;
+    }
+
+    static int fake_send(const uint8_t* data, int length, bool /*more_follows*/)
+    {
+        memcpy(wire.data(), data, static_cast<size_t>(length));
+
+        return length;
+    }
+
+    static void receive_benchmark()
+    {
+        PacketReceiveBuffer<BenchProtocol> rx{ std::make_unique<BenchProtocol>() };
+        rx.prepare_new_packet();
+        BenchPacket p{};
+
+        // The sequence formerly performed by Socket::readable() and Socket::read_data();
+        // 7 locks per packet, excluding get().
+        run_benchmark("rx_legacy_sequence", iterations, [&rx, &p]() {
+                          if (!rx.is_full())
+                          {
+                              int wanted_length = rx.amount_wanted();
+                              int read_count = 0;
+                              {
+                                  auto write_pos = rx.get_write_pos();
+                                  read_count = fake_recv(static_cast<uint8_t*>(write_pos), wanted_length);
+                              }
+
+                              rx.data_received(read_count);
+
+                              if (rx.is_error())
+                              {
+                                  rx.prepare_new_packet();
+                              }
+                              else if (rx.is_packet_complete())
+                              {
+                                  rx.prepare_new_packet();
+                              }
+                          }
+
+                          rx.get(p);
+                      });
+
+        // Socket::readable() followed by a single receive(); 2 locks per packet, excluding get().
+        run_benchmark("rx_transaction", iterations, [&rx, &p]() {
+                          if (!rx.is_full())
+                          {
+                              rx.receive(fake_recv, []() {});
+                          }
+
+                          rx.get(p);
+                      });
+    }
+
+    static void send_benchmark()
+    {
+        PacketSendBuffer<BenchProtocol> tx{};
+        BenchPacket p{};
+
+        // The sequence formerly performed by Socket::send_next_packet() and Socket::write_data();
+        // 7 locks per packet, excluding put().
+        run_benchmark("tx_legacy_sequence", iterations, [&tx, &p]() {
+                          tx.put(p);
+
+                          if (!tx.is_in_progress())
+                          {
+                              tx.prepare_next_packet();
+                          }
+
+                          if (tx.is_in_progress())
+                          {
+                              auto data_to_send = tx.get_data_to_send();
+                              auto length = tx.get_remaining_data_length();
+                              tx.data_has_been_sent(fake_send(data_to_send, length, false));
+                              tx.is_in_progress();
+                          }
+                      });
+
+        // prepare_next_packet_if_idle() followed by a single send(); 2 locks per packet, excluding put().
+        run_benchmark("tx_transaction", iterations, [&tx, &p]() {
+                          tx.put(p);
+
+                          if (tx.prepare_next_packet_if_idle())
+                          {
+                              tx.send(fake_send);
+                          }
+                      });
+    }
+
+    void packet_buffer_benchmark()
+    {
+        receive_benchmark();
+        send_benchmark();
+    }
+}
@@ -0,0 +1,98 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "RouterBenchmark.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/application/network/http/regular/Router.h"
+#include "smooth/core/logging/log.h"
+#include "Benchmark.h"
+
+using namespace smooth::application::network::http::regular;
+using namespace smooth::core::logging;
+
+namespace linux_benchmarks
+{
+    static constexpr int route_count = 1'000;
+    static constexpr uint64_t iterations = 2'000'000;
+
+    /// Routes spread over a few top level paths, like those of a typical REST API.
+    static std::string route(int i)
+    {
+        static const char* areas[] = { "/api/device/", "/api/sensor/", "/api/config/", "/static/" };
+
+        return std::string{ areas[i % 4] } + "item" + std::to_string(i) + "/value";
+    }
+
+    void router_benchmark()
+    {
+        std::unordered_map<std::string, int> map{};
+        Router<int> router{};
+        Router<int> parameter_router{};
+        std::vector<std::string> urls{};
+        std::vector<std::string> parameter_urls{};
+
+        for (int i = 0; i < route_count; ++i)
+        {
+            auto r = route(i);
+            map[r] = i;
+            router.add(r, i);
+            urls.emplace_back(std::move(r));
+
+            parameter_router.add("/api/device" + std::to_string(i) + "/:id/value", i);
+            parameter_urls.emplace_back("/api/device" + std::to_string(i) + "/" + std::to_string(i * 7) + "/value");
+        }
+
+        std::size_t index = 0;
+        int64_t sum = 0;
+
+        run_benchmark("route_unordered_map", iterations, [&]() {
+                          auto it = map.find(urls[index]);
+                          sum += it == map.end() ? 0 : it->second;
+                          index = (index + 1) % urls.size();
+                      });
+
+        RouteParameters params{};
+
+        run_benchmark("route_router", iterations, [&]() {
+                          auto res = router.find(urls[index], params);
+                          sum += res == nullptr ? 0 : *res;
+                          index = (index + 1) % urls.size();
+                      });
+
+        run_benchmark("route_router_parameter", iterations, [&]() {
+                          auto res = parameter_router.find(parameter_urls[index], params);
+                          sum += res == nullptr ? 0 : *res + static_cast<int64_t>(params.get("id").size());
+                          index = (index + 1) % parameter_urls.size();
+                      });
+
+        // Misses fall through to the file system in HTTPServer.
+        const std::string miss = "/api/device/item5/other";
+
+        run_benchmark("route_unordered_map_miss", iterations, [&]() {
+                          sum += map.find(miss) == map.end() ? 1 : 0;
+                      });
+
+        run_benchmark("route_router_miss", iterations, [&]() {
+                          sum += router.find(miss, params) == nullptr ? 1 : 0;
+                      });
+
+        // Keeps the lookups from being optimized away.
+        Log::debug("Benchmarks", "Route checksum {}", sum);
+    }
+}
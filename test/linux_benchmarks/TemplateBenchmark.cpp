@@ -0,0 +1,146 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "TemplateBenchmark.h"
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include "smooth/application/network/http/regular/TemplateProcessor.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/FSLock.h"
+#include "smooth/core/util/string_util.h"
+#include "smooth/core/logging/log.h"
+#include "Benchmark.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::core::filesystem;
+using namespace smooth::core::logging;
+
+namespace linux_benchmarks
+{
+    static constexpr std::size_t content_chunk_size = 4096;
+
+    class Retriever
+        : public ITemplateDataRetriever
+    {
+        public:
+            std::string get(const std::string& key) const override
+            {
+                auto it = data.find(key);
+
+                return it == data.end() ? "" : it->second;
+            }
+
+        private:
+            std::unordered_map<std::string, std::string> data{ { "{{title}}", "Status" },
+                                                               { "{{name}}", "Bob" },
+                                                               { "{{food}}", "an ice cream" },
+                                                               { "{{uptime}}", "3 days" },
+                                                               { "{{free_heap}}", "123456" },
+                                                               { "{{ip-address}}", "192.168.0.2" },
+                                                               { "{{firmware_version}}", "1.2.3" } };
+    };
+
+    /// The rendering done by TemplateProcessor before templates were parsed once and cached.
+    static std::size_t legacy_render(const Path& path, const ITemplateDataRetriever& retriever)
+    {
+        static const std::regex token{ R"!(\{\{[\d\_\-a-zA-Z]+\}\})!", std::regex::ECMAScript };
+
+        std::string data;
+        File{ path }.read(data);
+        std::smatch match{};
+
+        while (std::regex_search(data, match, token))
+        {
+            const auto& found_token = match[0].str();
+            smooth::core::string_util::replace_all(data, found_token, retriever.get(found_token));
+        }
+
+        return data.size();
+    }
+
+    static std::size_t render(TemplateProcessor& processor, const Path& path)
+    {
+        std::size_t size = 0;
+        auto response = processor.process_template(path);
+        auto status = ResponseStatus::HasMoreData;
+        std::vector<uint8_t> data{};
+
+        while (status == ResponseStatus::HasMoreData)
+        {
+            data.clear();
+            status = response->get_data(content_chunk_size, data);
+            size += data.size();
+        }
+
+        return size;
+    }
+
+    static void run(const char* name, const Path& path, uint64_t iterations)
+    {
+        auto retriever = std::make_shared<Retriever>();
+        TemplateProcessor processor{ { ".html" }, retriever };
+        std::size_t legacy_size = 0;
+        std::size_t size = 0;
+
+        run_benchmark((std::string{ "template_regex_" } + name).c_str(), iterations, [&]() {
+                          legacy_size += legacy_render(path, *retriever);
+                      });
+
+        run_benchmark((std::string{ "template_parsed_" } + name).c_str(), iterations, [&]() {
+                          size += render(processor, path);
+                      });
+
+        if (legacy_size != size)
+        {
+            Log::error("Benchmarks", "Template renderings differ in size: {} vs. {}", legacy_size, size);
+        }
+    }
+
+    void template_benchmark()
+    {
+        FSLock::set_limit(5);
+
+        // Copied to the build directory, next to the executable.
+        const auto small = Path{ "test_data" } / "template.html";
+        std::string text{};
+
+        if (!File{ small }.read(text) || text.empty())
+        {
+            Log::error("Benchmarks", "Template benchmark needs {}, run from the build directory.", small);
+        }
+        else
+        {
+            const Path large{ "/tmp/smooth_template_benchmark.html" };
+            std::string large_text{};
+
+            for (int i = 0; i < 50; ++i)
+            {
+                large_text += text;
+            }
+
+            if (File{ large }.write(large_text))
+            {
+                run("small", small, 20'000);
+                run("large", large, 500);
+                std::remove(large);
+            }
+        }
+    }
+}
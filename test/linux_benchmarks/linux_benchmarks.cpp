@@ -0,0 +1,62 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "linux_benchmarks.h"
+#include <cstdio>
+#include <cstdlib>
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/logging/log.h"
+#include "PacketBufferBenchmark.h"
+#include "DatagramBenchmark.h"
+#include "AcceptBenchmark.h"
+#include "RouterBenchmark.h"
+#include "HeaderParserBenchmark.h"
+#include "TemplateBenchmark.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+
+namespace linux_benchmarks
+{
+    App::App()
+            : Application(smooth::core::APPLICATION_BASE_PRIO, std::chrono::seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        Log::info("Benchmarks", "Running benchmarks");
+
+        packet_buffer_benchmark();
+        datagram_benchmark();
+        accept_benchmark();
+        router_benchmark();
+        header_parser_benchmark();
+        template_benchmark();
+    }
+
+    void App::tick()
+    {
+        Log::info("Benchmarks", "All benchmarks done");
+
+        // Background tasks (timers, socket dispatcher) are never joined so skip static destruction.
+        fflush(stdout);
+        std::_Exit(EXIT_SUCCESS);
+    }
+}
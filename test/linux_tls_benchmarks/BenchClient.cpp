@@ -0,0 +1,116 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "BenchClient.h"
+
+using namespace std::chrono;
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::core::network::event;
+
+namespace linux_tls_benchmarks
+{
+    BenchClient::BenchClient(Task& task, IClientObserver& observer, std::shared_ptr<InetAddress> server)
+            : observer(observer),
+              server(std::move(server)),
+              buffers(std::make_shared<BufferContainer<BenchProtocol>>(task,
+                                                                       *this,
+                                                                       *this,
+                                                                       *this,
+                                                                       std::make_unique<BenchProtocol>()))
+    {
+    }
+
+    void BenchClient::connect(MBedTLSContext& tls)
+    {
+        buffers->clear();
+        handshake_done = false;
+        frames_left = 0;
+        ack_queued = true;
+        socket = SecureSocket<BenchProtocol>::create(buffers, tls.create_context());
+        connect_start = steady_clock::now();
+        socket->start(server);
+    }
+
+    void BenchClient::disconnect()
+    {
+        if (socket)
+        {
+            socket->stop("Benchmark round done");
+        }
+    }
+
+    void BenchClient::transfer(std::size_t size, int count)
+    {
+        payload_size = size;
+        frames_left = count;
+        ack_queued = false;
+        send_frames();
+    }
+
+    void BenchClient::send_frames()
+    {
+        while (frames_left > 0 && socket->send(BenchPacket{ payload_size }))
+        {
+            --frames_left;
+        }
+
+        if (frames_left == 0 && !ack_queued)
+        {
+            ack_queued = socket->send(BenchPacket{ 0 });
+        }
+    }
+
+    void BenchClient::event(const TransmitBufferEmptyEvent&)
+    {
+        send_frames();
+    }
+
+    void BenchClient::event(const DataAvailableEvent<BenchProtocol>& event)
+    {
+        BenchPacket packet;
+
+        if (event.get(packet) && packet.is_ack())
+        {
+            if (!handshake_done)
+            {
+                handshake_done = true;
+                handshake_time = steady_clock::now() - connect_start;
+                observer.connected(*this);
+            }
+            else
+            {
+                observer.transfer_completed(*this);
+            }
+        }
+    }
+
+    void BenchClient::event(const ConnectionStatusEvent& event)
+    {
+        if (event.is_connected())
+        {
+            // The TCP connection is up, the frame is sent once the handshake has completed and
+            // answered once it has been received, which makes the reply mark the end of the handshake.
+            socket->send(BenchPacket{ 0 });
+        }
+        else
+        {
+            socket.reset();
+            observer.disconnected(*this);
+        }
+    }
+}
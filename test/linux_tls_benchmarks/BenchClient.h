@@ -0,0 +1,101 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include "smooth/core/Task.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/InetAddress.h"
+#include "smooth/core/network/MbedTLSContext.h"
+#include "smooth/core/network/SecureSocket.h"
+#include "smooth/core/network/event/ConnectionStatusEvent.h"
+#include "smooth/core/network/event/DataAvailableEvent.h"
+#include "smooth/core/network/event/TransmitBufferEmptyEvent.h"
+#include "BenchProtocol.h"
+
+namespace linux_tls_benchmarks
+{
+    class BenchClient;
+
+    /// Receives the progress of a BenchClient.
+    class IClientObserver
+    {
+        public:
+            virtual ~IClientObserver() = default;
+
+            /// Called once the client has been answered over a new connection, i.e. the handshake is done.
+            virtual void connected(BenchClient& client) = 0;
+
+            /// Called when the connection has been closed.
+            virtual void disconnected(BenchClient& client) = 0;
+
+            /// Called once all data of a transfer has been received by the server.
+            virtual void transfer_completed(BenchClient& client) = 0;
+    };
+
+    /// The client side of a benchmark connection.
+    class BenchClient
+        : public smooth::core::ipc::IEventListener<smooth::core::network::event::TransmitBufferEmptyEvent>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::DataAvailableEvent<BenchProtocol>>,
+        public smooth::core::ipc::IEventListener<smooth::core::network::event::ConnectionStatusEvent>
+    {
+        public:
+            BenchClient(smooth::core::Task& task,
+                        IClientObserver& observer,
+                        std::shared_ptr<smooth::core::network::InetAddress> server);
+
+            /// Connects to the server.
+            /// \param tls The context to create the TLS context of the connection from.
+            void connect(smooth::core::network::MBedTLSContext& tls);
+
+            void disconnect();
+
+            /// Sends frames to the server, IClientObserver::transfer_completed() is called once they have been received.
+            /// \param payload_size Size of the payload of each frame
+            /// \param count Number of frames to send
+            void transfer(std::size_t payload_size, int count);
+
+            /// Returns the time from connect() until the server first answered.
+            [[nodiscard]] std::chrono::nanoseconds get_handshake_time() const
+            {
+                return handshake_time;
+            }
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent& event) override;
+
+            void event(const smooth::core::network::event::DataAvailableEvent<BenchProtocol>& event) override;
+
+            void event(const smooth::core::network::event::ConnectionStatusEvent& event) override;
+
+        private:
+            void send_frames();
+
+            IClientObserver& observer;
+            std::shared_ptr<smooth::core::network::InetAddress> server;
+            std::shared_ptr<smooth::core::network::BufferContainer<BenchProtocol>> buffers;
+            std::shared_ptr<smooth::core::network::SecureSocket<BenchProtocol>> socket{};
+            std::chrono::steady_clock::time_point connect_start{};
+            std::chrono::nanoseconds handshake_time{};
+            bool handshake_done = false;
+            std::size_t payload_size = 0;
+            int frames_left = 0;
+            bool ack_queued = true;
+    };
+}
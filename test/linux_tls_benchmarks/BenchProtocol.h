@@ -0,0 +1,149 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "smooth/core/network/IPacketDisassembly.h"
+#include "smooth/core/network/IPacketAssembly.h"
+
+namespace linux_tls_benchmarks
+{
+    /// A frame made up of a 4 byte payload length, in network byte order, followed by the payload.
+    /// A frame without payload asks the receiver to reply with an empty frame, which, as frames are
+    /// handled in order, tells the sender that everything sent before it has been received.
+    class BenchPacket
+        : public smooth::core::network::IPacketDisassembly
+    {
+        public:
+            static constexpr std::size_t header_size = 4;
+
+            BenchPacket() = default;
+
+            explicit BenchPacket(std::size_t payload_size)
+                    : data(header_size + payload_size, 0xA5)
+            {
+                data[0] = static_cast<uint8_t>(payload_size >> 24);
+                data[1] = static_cast<uint8_t>(payload_size >> 16);
+                data[2] = static_cast<uint8_t>(payload_size >> 8);
+                data[3] = static_cast<uint8_t>(payload_size);
+            }
+
+            int get_send_length() override
+            {
+                return static_cast<int>(data.size());
+            }
+
+            const uint8_t* get_data() override
+            {
+                return data.data();
+            }
+
+            /// Returns the payload length as given by the header.
+            [[nodiscard]] std::size_t get_payload_size() const
+            {
+                return static_cast<std::size_t>(data[0]) << 24
+                       | static_cast<std::size_t>(data[1]) << 16
+                       | static_cast<std::size_t>(data[2]) << 8
+                       | static_cast<std::size_t>(data[3]);
+            }
+
+            [[nodiscard]] bool is_ack() const
+            {
+                return data.size() >= header_size && get_payload_size() == 0;
+            }
+
+            std::vector<uint8_t>& buffer()
+            {
+                return data;
+            }
+
+        private:
+            std::vector<uint8_t> data{};
+    };
+
+    class BenchProtocol
+        : public smooth::core::network::IPacketAssembly<BenchProtocol, BenchPacket>
+    {
+        public:
+            using packet_type = BenchPacket;
+
+            static constexpr std::size_t max_payload_size = 64 * 1024;
+
+            int get_wanted_amount(BenchPacket& packet) override
+            {
+                if (received == 0)
+                {
+                    packet.buffer().resize(BenchPacket::header_size);
+                }
+
+                return static_cast<int>(packet.buffer().size() - received);
+            }
+
+            void data_received(BenchPacket& packet, int length) override
+            {
+                received += static_cast<std::size_t>(length);
+
+                if (received == BenchPacket::header_size)
+                {
+                    auto payload_size = packet.get_payload_size();
+                    error = payload_size > max_payload_size;
+
+                    if (!error)
+                    {
+                        packet.buffer().resize(BenchPacket::header_size + payload_size);
+                    }
+                }
+
+                complete = !error && received == packet.buffer().size();
+            }
+
+            uint8_t* get_write_pos(BenchPacket& packet) override
+            {
+                return packet.buffer().data() + received;
+            }
+
+            bool is_complete(BenchPacket& /*packet*/) const override
+            {
+                return complete;
+            }
+
+            bool is_error() override
+            {
+                return error;
+            }
+
+            void packet_consumed() override
+            {
+                received = 0;
+                complete = false;
+            }
+
+            void reset() override
+            {
+                packet_consumed();
+                error = false;
+            }
+
+        private:
+            std::size_t received = 0;
+            bool complete = false;
+            bool error = false;
+    };
+}
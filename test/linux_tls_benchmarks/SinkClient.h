@@ -0,0 +1,74 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include "smooth/core/network/ServerClient.h"
+#include "smooth/core/network/BufferContainer.h"
+#include "smooth/core/network/event/DataAvailableEvent.h"
+#include "BenchProtocol.h"
+
+namespace linux_tls_benchmarks
+{
+    /// The server side of a benchmark connection. Discards received frames, answering those without payload.
+    class SinkClient
+        : public smooth::core::network::ServerClient<SinkClient, BenchProtocol, void>
+    {
+        public:
+            SinkClient(smooth::core::Task& task, smooth::core::network::ClientPool<SinkClient>& pool)
+                    : ServerClient<SinkClient, BenchProtocol, void>(task, pool, std::make_unique<BenchProtocol>())
+            {
+            }
+
+            void event(const smooth::core::network::event::DataAvailableEvent<BenchProtocol>& event) override
+            {
+                BenchPacket packet;
+
+                if (event.get(packet) && packet.is_ack())
+                {
+                    auto buffers = get_buffers().lock();
+
+                    if (buffers)
+                    {
+                        buffers->get_tx_buffer().put(BenchPacket{ 0 });
+                    }
+                }
+            }
+
+            void event(const smooth::core::network::event::TransmitBufferEmptyEvent& /*event*/) override
+            {
+            }
+
+            void connected() override
+            {
+            }
+
+            void disconnected() override
+            {
+            }
+
+            void reset_client() override
+            {
+            }
+
+            std::chrono::milliseconds get_send_timeout() override
+            {
+                return std::chrono::seconds{ 5 };
+            }
+    };
+}
@@ -0,0 +1,352 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "TlsHandshakeBenchmark.h"
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <malloc.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/MbedTLSContext.h"
+#include "smooth/core/network/IPacketDisassembly.h"
+#include "smooth/core/network/PacketSendBuffer.h"
+#include "smooth/core/network/TlsBio.h"
+#include "../linux_benchmarks/Benchmark.h"
+#include "../secure_server_socket_test/certificates.h"
+
+using namespace smooth::core::logging;
+using namespace smooth::core::network;
+using linux_benchmarks::run_benchmark;
+
+namespace linux_tls_benchmarks
+{
+    static constexpr uint64_t handshakes = 100;
+    static constexpr uint64_t setups = 1'000;
+    static constexpr std::size_t held_connections = 32;
+    static constexpr int bulk_messages = 5'000;
+    static constexpr std::size_t header_size = 100;
+    static constexpr std::size_t body_size = 1'000;
+
+    /// mbedtls_x509_crt_parse() wants the size of the buffer including the terminating 0.
+    static std::vector<unsigned char> to_pem(const char* src)
+    {
+        std::vector<unsigned char> res{ src, src + strlen(src) };
+        res.push_back('\0');
+
+        return res;
+    }
+
+    static int bio_send(void* ctx, const unsigned char* buf, size_t len)
+    {
+        return static_cast<int>(::send(*static_cast<int*>(ctx), buf, len, MSG_NOSIGNAL));
+    }
+
+    static int bio_recv(void* ctx, unsigned char* buf, size_t len)
+    {
+        return static_cast<int>(::recv(*static_cast<int*>(ctx), buf, len, 0));
+    }
+
+    static bool complete_handshake(SSLContext& ctx)
+    {
+        int res;
+
+        do
+        {
+            res = mbedtls_ssl_handshake(ctx);
+        }
+        while (res == MBEDTLS_ERR_SSL_WANT_READ || res == MBEDTLS_ERR_SSL_WANT_WRITE);
+
+        return res == 0;
+    }
+
+    static bool handshake(SSLContext& ctx, int& socket)
+    {
+        mbedtls_ssl_set_bio(ctx, &socket, bio_send, bio_recv, nullptr);
+
+        return complete_handshake(ctx);
+    }
+
+    /// Connects a client to the server over a socket pair and runs the handshake on both ends.
+    static bool connect_once(MBedTLSContext& server, MBedTLSContext& client)
+    {
+        int sockets[2];
+
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+        {
+            return false;
+        }
+
+        auto server_ctx = server.create_context();
+        auto client_ctx = client.create_context();
+        bool server_ok = false;
+
+        std::thread server_side([&server_ctx, &sockets, &server_ok]() {
+                                    server_ok = handshake(*server_ctx, sockets[0]);
+                                });
+
+        auto client_ok = handshake(*client_ctx, sockets[1]);
+
+        if (client_ok)
+        {
+            client_ctx->handshake_completed();
+        }
+
+        // Unblocks the server should the client have given up half way.
+        shutdown(sockets[1], SHUT_RDWR);
+        server_side.join();
+
+        close(sockets[0]);
+        close(sockets[1]);
+
+        return client_ok && server_ok;
+    }
+
+    static std::size_t heap_in_use()
+    {
+        return mallinfo2().uordblks;
+    }
+
+    /// Measures the cost of setting up server contexts and connections, in time and heap.
+    static void setup_benchmark(const std::vector<unsigned char>& ca_chain,
+                                const std::vector<unsigned char>& own_cert,
+                                const std::vector<unsigned char>& private_key)
+    {
+        MBedTLSContext server{};
+        server.init_server(ca_chain, own_cert, private_key, {});
+
+        // Each server context reuses the certificates, key and random generator of the first one.
+        run_benchmark("tls_server_context_setup", setups / 10, [&]() {
+                          MBedTLSContext ctx{};
+                          ctx.init_server(ca_chain, own_cert, private_key, {});
+                      });
+
+        run_benchmark("tls_connection_setup", setups, [&]() {
+                          auto ctx = server.create_context();
+                      });
+
+        std::vector<std::unique_ptr<SSLContext>> connections{};
+        connections.reserve(held_connections);
+        auto before = heap_in_use();
+
+        for (std::size_t i = 0; i < held_connections; ++i)
+        {
+            connections.emplace_back(server.create_context());
+        }
+
+        printf("BENCH tls_connection_heap connections=%zu bytes_per_connection=%zu\n",
+               held_connections,
+               (heap_in_use() - before) / held_connections);
+    }
+
+    /// A packet of a fixed size, standing in for the header or body of an HTTP response.
+    class BulkPacket
+        : public IPacketDisassembly
+    {
+        public:
+            BulkPacket() = default;
+
+            explicit BulkPacket(std::size_t size)
+                    : data(size, 'x')
+            {
+            }
+
+            int get_send_length() override
+            {
+                return static_cast<int>(data.size());
+            }
+
+            const uint8_t* get_data() override
+            {
+                return data.data();
+            }
+
+        private:
+            std::vector<uint8_t> data{};
+    };
+
+    struct BulkProtocol
+    {
+        using packet_type = BulkPacket;
+    };
+
+    /// Sends messages, each made up of a header and a body packet, from a client to a server and prints
+    /// the throughput along with the number of send() and recv() calls made after the handshake.
+    /// \param coalesce If true, packets are coalesced into full records, otherwise each packet is a record.
+    static bool bulk_benchmark(const char* name, MBedTLSContext& server, MBedTLSContext& client, bool coalesce)
+    {
+        int sockets[2];
+
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+        {
+            return false;
+        }
+
+        auto server_ctx = server.create_context();
+        auto client_ctx = client.create_context();
+        SocketCounters server_counters{};
+        SocketCounters client_counters{};
+        TlsBio server_bio{ sockets[0], server_counters };
+        TlsBio client_bio{ sockets[1], client_counters };
+        server_bio.attach(*server_ctx);
+        client_bio.attach(*client_ctx);
+
+        const auto expected = static_cast<std::size_t>(bulk_messages) * (header_size + body_size);
+        std::size_t received = 0;
+        SocketStats server_start{};
+        SocketStats server_end{};
+
+        std::thread server_side([&]() {
+                                    if (complete_handshake(*server_ctx))
+                                    {
+                                        server_counters.copy_to(server_start);
+                                        std::vector<unsigned char> buf(MBEDTLS_SSL_MAX_CONTENT_LEN);
+
+                                        while (received < expected)
+                                        {
+                                            auto res = mbedtls_ssl_read(*server_ctx, buf.data(), buf.size());
+
+                                            if (res <= 0)
+                                            {
+                                                break;
+                                            }
+
+                                            received += static_cast<std::size_t>(res);
+                                        }
+
+                                        server_counters.copy_to(server_end);
+                                    }
+                                });
+
+        bool ok = complete_handshake(*client_ctx);
+        SocketStats client_start{};
+        client_counters.copy_to(client_start);
+
+        auto max_payload = mbedtls_ssl_get_max_out_record_payload(*client_ctx);
+        PacketSendBuffer<BulkProtocol> tx{ BufferDepth{ 2, 2 } };
+        std::vector<uint8_t> staging{};
+
+        auto writer = [&client_ctx](const uint8_t* data, int length) {
+                          return mbedtls_ssl_write(*client_ctx, data, static_cast<size_t>(length));
+                      };
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; ok && i < bulk_messages; ++i)
+        {
+            tx.put(BulkPacket{ header_size });
+            tx.put(BulkPacket{ body_size });
+
+            while (ok && !tx.is_empty())
+            {
+                if (coalesce)
+                {
+                    ok = tx.send_coalesced(staging, max_payload, 0, writer).sent_count > 0;
+                }
+                else
+                {
+                    if (!tx.is_in_progress())
+                    {
+                        tx.prepare_next_packet();
+                    }
+
+                    ok = tx.send([&writer](const uint8_t* data, int length, bool) {
+                                     return writer(data, length);
+                                 }).sent_count > 0;
+                }
+            }
+        }
+
+        if (!ok)
+        {
+            // Unblocks the server.
+            shutdown(sockets[1], SHUT_RDWR);
+        }
+
+        server_side.join();
+
+        auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        SocketStats client_end{};
+        client_counters.copy_to(client_end);
+
+        close(sockets[0]);
+        close(sockets[1]);
+
+        ok &= received == expected;
+
+        if (ok)
+        {
+            printf("BENCH %s messages=%d total_ns=%lld mb_per_s=%.1f send_calls=%llu recv_calls=%llu\n",
+                   name,
+                   bulk_messages,
+                   static_cast<long long>(total),
+                   static_cast<double>(expected) / static_cast<double>(total) * 1e3,
+                   static_cast<unsigned long long>(client_end.send_calls - client_start.send_calls),
+                   static_cast<unsigned long long>(server_end.receive_calls - server_start.receive_calls));
+        }
+
+        return ok;
+    }
+
+    void tls_handshake_benchmark()
+    {
+        auto ca_chain = to_pem(ca_chain_data);
+        auto own_cert = to_pem(server_cert_data);
+        auto private_key = to_pem(private_key_data);
+
+        MBedTLSContext server{};
+        MBedTLSContext full_client{};
+        MBedTLSContext resuming_client{};
+
+        if (!server.init_server(ca_chain, own_cert, private_key, {})
+            || !server.enable_server_session_cache(8, std::chrono::seconds{ 3600 }, true)
+            || !full_client.init_client(ca_chain)
+            || !resuming_client.init_client(ca_chain))
+        {
+            Log::error("Benchmarks", "Could not set up TLS contexts");
+            return;
+        }
+
+        resuming_client.enable_client_session_cache();
+
+        setup_benchmark(ca_chain, own_cert, private_key);
+
+        bool ok = true;
+
+        run_benchmark("tls_handshake_full", handshakes, [&]() {
+                          ok &= connect_once(server, full_client);
+                      });
+
+        // The warm-up of run_benchmark() performs the initial full handshake.
+        run_benchmark("tls_handshake_resumed", handshakes, [&]() {
+                          ok &= connect_once(server, resuming_client);
+                      });
+
+        ok &= bulk_benchmark("tls_bulk_record_per_packet", server, full_client, false);
+        ok &= bulk_benchmark("tls_bulk_coalesced", server, full_client, true);
+
+        if (!ok)
+        {
+            Log::error("Benchmarks", "TLS handshake or transfer failed");
+        }
+    }
+}
@@ -0,0 +1,26 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+namespace linux_tls_benchmarks
+{
+    /// Measures TLS on the level of MBedTLSContext, without sockets or tasks: context setup time and heap,
+    /// a full handshake versus one resuming a previous session, and bulk transfer with and without coalesced
+    /// records, each over a socket pair.
+    void tls_handshake_benchmark();
+}
@@ -0,0 +1,303 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "linux_tls_benchmarks.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/SecureServerSocket.h"
+#include "TlsHandshakeBenchmark.h"
+#include "../secure_server_socket_test/certificates.h"
+
+using namespace std::chrono;
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace smooth::core::network;
+
+namespace linux_tls_benchmarks
+{
+    static constexpr int client_count = 8;
+
+    // The first round of each handshake phase is a warm-up and isn't measured.
+    static constexpr int rounds = 11;
+    static constexpr uint16_t port = 8445;
+    static constexpr std::size_t bytes_per_client = 2 * 1024 * 1024;
+    static constexpr std::array<std::size_t, 5> payload_sizes{ 64, 512, 1400, 4096, 16000 };
+    static constexpr auto phase_timeout = seconds{ 60 };
+    static const char* tag = "TlsBenchmarks";
+
+    /// mbedtls_x509_crt_parse() wants the size of the buffer including the terminating 0.
+    static std::vector<unsigned char> to_pem(const char* src)
+    {
+        std::vector<unsigned char> res{ src, src + strlen(src) };
+        res.push_back('\0');
+
+        return res;
+    }
+
+    static long long heap_in_use()
+    {
+        return static_cast<long long>(mallinfo2().uordblks);
+    }
+
+    static double to_us(nanoseconds ns)
+    {
+        return static_cast<double>(ns.count()) / 1e3;
+    }
+
+    App::App()
+            : Application(smooth::core::APPLICATION_BASE_PRIO, milliseconds(100))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        // Runs to completion before any socket is created.
+        tls_handshake_benchmark();
+
+        // Lets the socket dispatcher know there is a network.
+        get_wifi().connect_to_ap();
+
+        auto ca_chain = to_pem(ca_chain_data);
+        auto own_cert = to_pem(server_cert_data);
+        auto private_key = to_pem(private_key_data);
+        std::vector<unsigned char> password{};
+
+        // Room for the server side of the connections of one round to linger while those of the next are accepted.
+        server = SecureServerSocket<SinkClient, BenchProtocol, void>::create(*this,
+                                                                             ClientPoolSize{ client_count * 2 },
+                                                                             client_count,
+                                                                             ca_chain,
+                                                                             own_cert,
+                                                                             private_key,
+                                                                             password);
+
+        if (server
+            && full_client_tls.init_client(ca_chain)
+            && resuming_client_tls.init_client(ca_chain))
+        {
+            resuming_client_tls.enable_client_session_cache();
+            server->start(std::make_shared<IPv4>("127.0.0.1", port));
+
+            auto address = std::make_shared<IPv4>("127.0.0.1", port);
+
+            for (int i = 0; i < client_count; ++i)
+            {
+                clients.emplace_back(std::make_unique<BenchClient>(*this, *this, address));
+            }
+
+            Log::info(tag, "Running TLS benchmarks with {} clients", client_count);
+        }
+        else
+        {
+            Log::error(tag, "Could not set up TLS contexts");
+            finish(false);
+        }
+    }
+
+    void App::tick()
+    {
+        if (!started)
+        {
+            // Give the server socket a chance to start listening.
+            started = true;
+            phase_start = steady_clock::now();
+            start_round();
+        }
+        else if (steady_clock::now() - phase_start > phase_timeout)
+        {
+            Log::error(tag, "Benchmark timed out");
+            finish(false);
+        }
+    }
+
+    void App::start_round()
+    {
+        connected_count = 0;
+        heap_before = heap_in_use();
+        round_start = steady_clock::now();
+
+        auto& tls = phase == Phase::FullHandshakes ? full_client_tls : resuming_client_tls;
+
+        for (auto& c : clients)
+        {
+            c->connect(tls);
+        }
+    }
+
+    void App::connected(BenchClient& client)
+    {
+        if (round > 0)
+        {
+            latencies.push_back(client.get_handshake_time());
+        }
+
+        if (++connected_count == client_count)
+        {
+            round_connected();
+        }
+    }
+
+    void App::round_connected()
+    {
+        if (round > 0)
+        {
+            phase_time += steady_clock::now() - round_start;
+        }
+
+        if (phase == Phase::FullHandshakes && round == 1)
+        {
+            // The server runs in the same process so this covers both ends of each connection.
+            printf("BENCH tls_server_connection_heap connections=%d bytes_per_connection=%lld\n",
+                   client_count,
+                   (heap_in_use() - heap_before) / client_count);
+        }
+
+        if (++round < rounds)
+        {
+            disconnected_count = 0;
+
+            for (auto& c : clients)
+            {
+                c->disconnect();
+            }
+        }
+        else if (phase == Phase::FullHandshakes)
+        {
+            report_handshakes("tls_server_handshake_full");
+            phase = Phase::ResumedHandshakes;
+            round = 0;
+            disconnected_count = 0;
+
+            for (auto& c : clients)
+            {
+                c->disconnect();
+            }
+        }
+        else
+        {
+            report_handshakes("tls_server_handshake_resumed");
+
+            // Keep the connections for the bulk transfers.
+            phase = Phase::Bulk;
+            start_transfer();
+        }
+    }
+
+    void App::disconnected(BenchClient& /*client*/)
+    {
+        if (phase == Phase::FullHandshakes || phase == Phase::ResumedHandshakes)
+        {
+            if (++disconnected_count == client_count)
+            {
+                start_round();
+            }
+        }
+        else if (phase == Phase::Bulk)
+        {
+            Log::error(tag, "Connection lost during bulk transfer");
+            finish(false);
+        }
+    }
+
+    void App::report_handshakes(const char* name)
+    {
+        std::sort(latencies.begin(), latencies.end());
+
+        const auto count = latencies.size();
+        const auto p50 = latencies[count / 2];
+        const auto p99 = latencies[std::min(count - 1, count * 99 / 100)];
+
+        printf("BENCH %s connections=%d handshakes=%zu total_ns=%lld handshakes_per_s=%.0f p50_us=%.0f p99_us=%.0f\n",
+               name,
+               client_count,
+               count,
+               static_cast<long long>(phase_time.count()),
+               static_cast<double>(count) * 1e9 / static_cast<double>(phase_time.count()),
+               to_us(p50),
+               to_us(p99));
+
+        latencies.clear();
+        phase_time = nanoseconds{ 0 };
+        phase_start = steady_clock::now();
+    }
+
+    static int frames_per_client(std::size_t payload_size)
+    {
+        return static_cast<int>(std::max(std::size_t{ 1 }, bytes_per_client / payload_size));
+    }
+
+    void App::start_transfer()
+    {
+        auto payload_size = payload_sizes[size_index];
+        completed_count = 0;
+        round_start = steady_clock::now();
+        phase_start = round_start;
+
+        for (auto& c : clients)
+        {
+            c->transfer(payload_size, frames_per_client(payload_size));
+        }
+    }
+
+    void App::transfer_completed(BenchClient& /*client*/)
+    {
+        if (++completed_count == client_count)
+        {
+            auto total = duration_cast<nanoseconds>(steady_clock::now() - round_start).count();
+            auto payload_size = payload_sizes[size_index];
+            auto bytes = static_cast<std::size_t>(client_count)
+                         * static_cast<std::size_t>(frames_per_client(payload_size))
+                         * payload_size;
+
+            printf("BENCH tls_server_bulk_%zu connections=%d payload_size=%zu bytes=%zu total_ns=%lld mb_per_s=%.1f\n",
+                   payload_size,
+                   client_count,
+                   payload_size,
+                   bytes,
+                   static_cast<long long>(total),
+                   static_cast<double>(bytes) * 1e3 / static_cast<double>(total));
+
+            if (++size_index < payload_sizes.size())
+            {
+                start_transfer();
+            }
+            else
+            {
+                finish(true);
+            }
+        }
+    }
+
+    void App::finish(bool success)
+    {
+        phase = Phase::Done;
+        Log::info(tag, "TLS benchmarks done");
+
+        // Background tasks (timers, socket dispatcher) are never joined so skip static destruction.
+        fflush(stdout);
+        std::_Exit(success ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+}
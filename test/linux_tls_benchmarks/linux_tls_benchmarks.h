@@ -0,0 +1,91 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/network/MbedTLSContext.h"
+#include "smooth/core/network/ServerSocket.h"
+#include "BenchClient.h"
+#include "BenchProtocol.h"
+#include "SinkClient.h"
+
+namespace linux_tls_benchmarks
+{
+    /// Measures the TLS performance of SecureServerSocket and SecureSocket over loopback, using a number of
+    /// concurrent clients: handshake rate and latency, with and without session resumption, heap used per
+    /// connection and bulk throughput for several packet sizes. Results are printed as one line per benchmark:
+    /// BENCH <name> <key>=<value>...
+    /// These are named tls_server_*. The context level benchmarks, run first by tls_handshake_benchmark(),
+    /// keep their tls_* names.
+    class App
+        : public smooth::core::Application,
+        public IClientObserver
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void tick() override;
+
+            void connected(BenchClient& client) override;
+
+            void disconnected(BenchClient& client) override;
+
+            void transfer_completed(BenchClient& client) override;
+
+        private:
+            enum class Phase
+            {
+                FullHandshakes,
+                ResumedHandshakes,
+                Bulk,
+                Done
+            };
+
+            void start_round();
+
+            void round_connected();
+
+            void report_handshakes(const char* name);
+
+            void start_transfer();
+
+            void finish(bool success);
+
+            Phase phase = Phase::FullHandshakes;
+            bool started = false;
+            std::shared_ptr<smooth::core::network::ServerSocket<SinkClient, BenchProtocol, void>> server{};
+            smooth::core::network::MBedTLSContext full_client_tls{};
+            smooth::core::network::MBedTLSContext resuming_client_tls{};
+            std::vector<std::unique_ptr<BenchClient>> clients{};
+            int round = 0;
+            int connected_count = 0;
+            int disconnected_count = 0;
+            int completed_count = 0;
+            long long heap_before = 0;
+            std::size_t size_index = 0;
+            std::vector<std::chrono::nanoseconds> latencies{};
+            std::chrono::nanoseconds phase_time{};
+            std::chrono::steady_clock::time_point round_start{};
+            std::chrono::steady_clock::time_point phase_start{};
+    };
+}
@@ -0,0 +1,53 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include "smooth/application/network/http/http_utils.h"
+
+using namespace smooth::application::network::http::utils;
+
+SCENARIO("Checking acceptable content-codings")
+{
+    GIVEN("Various Accept-Encoding headers")
+    {
+        THEN("Listed codings are accepted, case insensitive")
+        {
+            REQUIRE(accepts_encoding("gzip, deflate, br", "gzip"));
+            REQUIRE(accepts_encoding("gzip, deflate, br", "br"));
+            REQUIRE(accepts_encoding("GZip", "gzip"));
+            REQUIRE_FALSE(accepts_encoding("deflate", "gzip"));
+            REQUIRE_FALSE(accepts_encoding("", "gzip"));
+            REQUIRE_FALSE(accepts_encoding("gzipped", "gzip"));
+        }
+
+        AND_THEN("Codings with a quality of zero are not accepted")
+        {
+            REQUIRE_FALSE(accepts_encoding("gzip;q=0, br", "gzip"));
+            REQUIRE_FALSE(accepts_encoding("gzip ; q=0.000", "gzip"));
+            REQUIRE(accepts_encoding("gzip;q=0.5", "gzip"));
+            REQUIRE(accepts_encoding("gzip;q=1", "gzip"));
+        }
+
+        AND_THEN("A wildcard accepts codings that aren't listed")
+        {
+            REQUIRE(accepts_encoding("*", "br"));
+            REQUIRE(accepts_encoding("deflate, *;q=0.1", "br"));
+            REQUIRE_FALSE(accepts_encoding("*;q=0", "br"));
+            REQUIRE_FALSE(accepts_encoding("br;q=0, *", "br"));
+        }
+    }
+}
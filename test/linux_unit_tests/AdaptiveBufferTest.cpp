@@ -0,0 +1,164 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+#include "smooth/core/util/AdaptiveBuffer.h"
+
+using namespace smooth::core::util;
+
+SCENARIO("Fixed depth AdaptiveBuffer")
+{
+    GIVEN("A buffer with a fixed depth of 3")
+    {
+        AdaptiveBuffer<int> buff{ 3, 3 };
+
+        WHEN("Filling it")
+        {
+            REQUIRE(buff.put(1));
+            REQUIRE(buff.put(2));
+            REQUIRE(buff.put(3));
+
+            THEN("It is full and does not overwrite data")
+            {
+                REQUIRE(buff.is_full());
+                REQUIRE_FALSE(buff.put(4));
+                REQUIRE(buff.get_depth() == 3);
+
+                int i = 0;
+                REQUIRE(buff.get(i));
+                REQUIRE(i == 1);
+                REQUIRE(buff.get(i));
+                REQUIRE(i == 2);
+                REQUIRE(buff.get(i));
+                REQUIRE(i == 3);
+                REQUIRE_FALSE(buff.get(i));
+                REQUIRE(buff.is_empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Adaptive depth AdaptiveBuffer")
+{
+    GIVEN("A buffer with an initial depth of 2 and a max depth of 5")
+    {
+        AdaptiveBuffer<int> buff{ 2, 5 };
+
+        WHEN("Putting more items than the initial depth")
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                REQUIRE(buff.put(i));
+            }
+
+            THEN("It grows")
+            {
+                REQUIRE(buff.get_depth() == 4);
+                REQUIRE_FALSE(buff.is_full());
+            }
+            AND_THEN("It grows no further than the max depth")
+            {
+                REQUIRE(buff.put(3));
+                REQUIRE(buff.put(4));
+                REQUIRE(buff.get_depth() == 5);
+                REQUIRE(buff.is_full());
+                REQUIRE_FALSE(buff.put(5));
+            }
+            AND_THEN("It shrinks back when drained")
+            {
+                int i = 0;
+
+                while (buff.get(i))
+                {
+                }
+
+                REQUIRE(i == 2);
+                REQUIRE(buff.get_depth() == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("Peeking and dropping items in an AdaptiveBuffer")
+{
+    GIVEN("A buffer with three items")
+    {
+        AdaptiveBuffer<int> buff{ 2, 4 };
+        REQUIRE(buff.put(1));
+        REQUIRE(buff.put(2));
+        REQUIRE(buff.put(3));
+
+        THEN("Items can be peeked at without removing them")
+        {
+            REQUIRE(buff.peek(0) == 1);
+            REQUIRE(buff.peek(2) == 3);
+            REQUIRE(buff.available_items() == 3);
+        }
+        AND_THEN("The oldest items can be dropped")
+        {
+            buff.drop(2);
+            REQUIRE(buff.available_items() == 1);
+            REQUIRE(buff.peek(0) == 3);
+        }
+        AND_THEN("Dropping more than available empties the buffer and shrinks it")
+        {
+            buff.drop(10);
+            REQUIRE(buff.is_empty());
+            REQUIRE(buff.get_depth() == 2);
+        }
+    }
+}
+
+SCENARIO("Wrapping around and growing an AdaptiveBuffer")
+{
+    GIVEN("A buffer with an initial depth of 3 whose oldest item is in the middle of the ring")
+    {
+        AdaptiveBuffer<int> buff{ 3, 6 };
+        int i = 0;
+        REQUIRE(buff.put(0));
+        REQUIRE(buff.put(1));
+        REQUIRE(buff.get(i));
+        REQUIRE(buff.put(2));
+        REQUIRE(buff.put(3));
+
+        WHEN("Growing it")
+        {
+            REQUIRE(buff.get_depth() == 3);
+            REQUIRE(buff.put(4));
+
+            THEN("The items keep their order")
+            {
+                REQUIRE(buff.get_depth() == 6);
+
+                for (int expected = 1; expected <= 4; ++expected)
+                {
+                    REQUIRE(buff.peek(expected - 1) == expected);
+                }
+
+                buff.drop(1);
+
+                for (int expected = 2; expected <= 4; ++expected)
+                {
+                    REQUIRE(buff.get(i));
+                    REQUIRE(i == expected);
+                }
+
+                REQUIRE(buff.get_depth() == 3);
+            }
+        }
+    }
+}
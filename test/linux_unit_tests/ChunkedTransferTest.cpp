@@ -0,0 +1,291 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <catch2/catch.hpp>
+#include "smooth/core/network/PacketReceiveBuffer.h"
+#include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/responses/ChunkedResponse.h"
+
+using namespace smooth::core::network;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::application::network::http::regular::responses;
+
+namespace
+{
+    class NullResponse
+        : public IServerResponse, public IUpgradeToWebsocket
+    {
+        public:
+            void reply(std::unique_ptr<IResponseOperation>, bool) override
+            {
+            }
+
+            void reply_error(std::unique_ptr<IResponseOperation>) override
+            {
+            }
+
+            void upgrade_to_websocket() override
+            {
+            }
+
+        protected:
+            smooth::core::Task& get_task() override
+            {
+                // Never called, no websocket upgrades here.
+                std::abort();
+            }
+
+            void upgrade_to_websocket_internal() override
+            {
+            }
+    };
+
+    /// Hands out data like recv() would, up to the wanted amount, and at most max_read bytes, per call.
+    class Reader
+    {
+        public:
+            explicit Reader(std::string data, std::size_t max_read = 1024)
+                    : data(std::move(data)),
+                      max_read(max_read)
+            {
+            }
+
+            int operator()(uint8_t* write_pos, int wanted_length)
+            {
+                auto amount = std::min({ data.size() - pos, static_cast<std::size_t>(wanted_length), max_read });
+                memcpy(write_pos, data.data() + pos, amount);
+                pos += amount;
+
+                return amount > 0 ? static_cast<int>(amount) : -1;
+            }
+
+            [[nodiscard]] bool done() const
+            {
+                return pos == data.size();
+            }
+
+        private:
+            std::string data;
+            std::size_t max_read;
+            std::size_t pos = 0;
+    };
+
+    std::string to_string(const std::vector<uint8_t>& data)
+    {
+        return std::string{ data.begin(), data.end() };
+    }
+}
+
+SCENARIO("Receiving requests with chunked transfer-encoding")
+{
+    GIVEN("A receive buffer for HTTP requests, with content chunks of 8 bytes")
+    {
+        NullResponse response{};
+        PacketReceiveBuffer<RegularHTTPProtocol> rx{
+            std::make_unique<RegularHTTPProtocol>(1024, 8, response, response), BufferDepth{ 10, 10 } };
+
+        auto receive_all = [&rx](Reader& reader) {
+                               bool ok = true;
+
+                               while (ok && (!reader.done() || rx.has_buffered_data()))
+                               {
+                                   auto res = rx.receive([&reader](uint8_t* write_pos, int wanted_length) {
+                                                             return reader(write_pos, wanted_length);
+                                                         },
+                                                         []() {});
+                                   ok = !res.assembly_error;
+                               }
+
+                               return ok;
+                           };
+
+        auto get_content = [&rx](std::vector<HTTPPacket>& packets) {
+                               std::string res{};
+                               HTTPPacket p{};
+
+                               while (rx.get(p))
+                               {
+                                   res += to_string(p.data());
+                                   packets.emplace_back(std::move(p));
+                                   p = HTTPPacket{};
+                               }
+
+                               return res;
+                           };
+
+        const std::string request = "POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                                    "5\r\nhello\r\n"
+                                    "b;name=value\r\n, chunked !\r\n"
+                                    "0\r\nTrailer: ignored\r\n\r\n"
+                                    "GET /next HTTP/1.1\r\n\r\n";
+
+        for (std::size_t max_read : { 1UL, 3UL, 1024UL })
+        {
+            WHEN("Receiving a chunked request followed by another request, " + std::to_string(max_read)
+                 + " bytes at a time")
+            {
+                Reader reader{ request, max_read };
+                REQUIRE(receive_all(reader));
+
+                THEN("The content is decoded and split into packets no larger than the content chunk size")
+                {
+                    std::vector<HTTPPacket> packets{};
+                    auto content = get_content(packets);
+                    REQUIRE(content == "hello, chunked !");
+
+                    // Content that arrives with the headers is delivered in the first packet, which may
+                    // then be larger than the content chunk size.
+                    REQUIRE(packets.size() >= (max_read == 1024 ? 2 : 4));
+
+                    for (std::size_t i = 0; i < packets.size() - 1; ++i)
+                    {
+                        auto& p = packets[i];
+                        REQUIRE(p.get_request_url() == "/upload");
+                        REQUIRE(p.is_continuation() == (i > 0));
+
+                        if (i > 0 && i < packets.size() - 2)
+                        {
+                            REQUIRE(p.data().size() == 8);
+                        }
+                    }
+
+                    REQUIRE_FALSE(packets[packets.size() - 2].is_continued());
+
+                    auto& next = packets.back();
+                    REQUIRE(next.get_request_url() == "/next");
+                    REQUIRE_FALSE(next.is_continuation());
+                    REQUIRE_FALSE(next.is_continued());
+                }
+            }
+        }
+
+        WHEN("Receiving a request with an invalid chunk size")
+        {
+            Reader reader{ "POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nxyz\r\nhello\r\n0\r\n\r\n" };
+
+            THEN("It is an error")
+            {
+                REQUIRE_FALSE(receive_all(reader));
+            }
+        }
+
+        WHEN("Receiving a chunk that isn't followed by CRLF")
+        {
+            Reader reader{ "POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nhello\r\n0\r\n\r\n" };
+
+            THEN("It is an error")
+            {
+                REQUIRE_FALSE(receive_all(reader));
+            }
+        }
+
+        WHEN("Chunked isn't the last transfer-coding")
+        {
+            Reader reader{ "POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked, gzip\r\nContent-Length: 3\r\n\r\n"
+                           "abc" };
+
+            THEN("It is an error since where the content ends is unknown")
+            {
+                REQUIRE_FALSE(receive_all(reader));
+            }
+        }
+    }
+}
+
+SCENARIO("Sending a response with chunked transfer-encoding")
+{
+    GIVEN("A response producing 25 bytes of content")
+    {
+        std::string content = "abcdefghijklmnopqrstuvwxy";
+        std::size_t pos = 0;
+        ChunkedResponse response{ ResponseCode::OK, "text/plain",
+                                  [&content, &pos](std::size_t max_amount, std::vector<uint8_t>& target) {
+                                      auto amount = std::min(max_amount, content.size() - pos);
+                                      target.insert(target.end(), content.begin() + static_cast<long>(pos),
+                                                    content.begin() + static_cast<long>(pos + amount));
+                                      pos += amount;
+
+                                      return pos < content.size();
+                                  } };
+
+        THEN("The headers announce chunked transfer-encoding")
+        {
+            REQUIRE(response.get_headers().at(TRANSFER_ENCODING) == "chunked");
+            REQUIRE(response.get_headers().count(CONTENT_LENGTH) == 0);
+        }
+
+        WHEN("Sending it 20 bytes at a time")
+        {
+            std::string sent{};
+            std::vector<uint8_t> target{};
+            auto res = ResponseStatus::HasMoreData;
+
+            while (res == ResponseStatus::HasMoreData)
+            {
+                target.clear();
+                res = response.get_data(20, target);
+                REQUIRE(target.size() <= 20);
+                sent += to_string(target);
+            }
+
+            THEN("It is sent as chunks, ending with the last chunk")
+            {
+                REQUIRE(res == ResponseStatus::LastData);
+                // Each chunk leaves room for its framing and the last chunk.
+                REQUIRE(sent == "09\r\nabcdefghi\r\n"
+                                "09\r\njklmnopqr\r\n"
+                                "07\r\nstuvwxy\r\n"
+                                "0\r\n\r\n");
+                REQUIRE(response.get_data(20, target) == ResponseStatus::NoData);
+            }
+        }
+
+        WHEN("The sent response is received")
+        {
+            std::string sent{ "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n" };
+            std::vector<uint8_t> target{};
+
+            while (response.get_data(100, target) == ResponseStatus::HasMoreData)
+            {
+            }
+
+            sent += to_string(target);
+
+            THEN("The content is the same")
+            {
+                NullResponse null_response{};
+                RegularHTTPProtocol proto{ 1024, 1024, null_response, null_response };
+                HTTPPacket p{};
+                Reader reader{ sent };
+
+                while (!proto.is_complete(p) && !proto.is_error())
+                {
+                    auto wanted = proto.get_wanted_amount(p);
+                    proto.data_received(p, reader(proto.get_write_pos(p), wanted));
+                }
+
+                REQUIRE_FALSE(proto.is_error());
+                REQUIRE(to_string(p.data()) == content);
+            }
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <thread>
+#include "smooth/core/Task.h"
+#include "smooth/core/network/ClientPool.h"
+
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace std::chrono;
+
+namespace
+{
+    class PoolTask
+        : public Task
+    {
+        public:
+            PoolTask()
+                    : Task(0, milliseconds(0))
+            {
+            }
+    };
+
+    class PoolClient
+    {
+        public:
+            PoolClient(Task& /*task*/, ClientPool<PoolClient>& /*pool*/, int id)
+                    : id(id)
+            {
+            }
+
+            void reset()
+            {
+                ++resets;
+            }
+
+            int id;
+            int resets = 0;
+            int pool_slot{ -1 };
+    };
+}
+
+SCENARIO("Fixed size ClientPool")
+{
+    GIVEN("A pool of two clients")
+    {
+        PoolTask task;
+        ClientPool<PoolClient> pool{ task, ClientPoolSize{ 2 } };
+        pool.create_clients(7);
+
+        THEN("All clients are created up front")
+        {
+            REQUIRE(pool.size() == 2);
+            REQUIRE_FALSE(pool.empty());
+        }
+        AND_THEN("It runs out of clients, and the last returned is handed out first")
+        {
+            auto a = pool.get();
+            auto b = pool.get();
+            REQUIRE(a);
+            REQUIRE(b);
+            REQUIRE(a->id == 7);
+            REQUIRE(pool.empty());
+            REQUIRE_FALSE(pool.get());
+
+            pool.return_client(a);
+            pool.return_client(b);
+            REQUIRE(a->resets == 1);
+            REQUIRE(pool.get() == b);
+            REQUIRE(pool.get() == a);
+        }
+    }
+}
+
+SCENARIO("Elastic ClientPool")
+{
+    GIVEN("A pool of one to three clients")
+    {
+        PoolTask task;
+        ClientPool<PoolClient> pool{ task, ClientPoolSize{ 1, 3, milliseconds(1) } };
+        pool.create_clients(0);
+
+        THEN("Only the initial client is created up front")
+        {
+            REQUIRE(pool.size() == 1);
+        }
+        AND_THEN("Clients are created on demand up to the max")
+        {
+            auto a = pool.get();
+            auto b = pool.get();
+            auto c = pool.get();
+            REQUIRE(c);
+            REQUIRE(pool.size() == 3);
+            REQUIRE(pool.empty());
+
+            AND_WHEN("They have been returned and are idle")
+            {
+                pool.return_client(a);
+                pool.return_client(b);
+                pool.return_client(c);
+                std::this_thread::sleep_for(milliseconds(5));
+                pool.trim();
+
+                THEN("The pool is trimmed back to the initial size")
+                {
+                    REQUIRE(pool.size() == 1);
+                    REQUIRE_FALSE(pool.empty());
+                    REQUIRE(pool.get() == c);
+                }
+            }
+        }
+    }
+}
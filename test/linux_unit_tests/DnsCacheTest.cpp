@@ -0,0 +1,109 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include "smooth/core/network/DnsCache.h"
+#include "smooth/core/network/IPv4.h"
+
+using namespace smooth::core::network;
+using namespace std::chrono;
+
+SCENARIO("DnsCache")
+{
+    auto& cache = DnsCache::instance();
+    cache.clear();
+    cache.set_ttl(seconds(60), seconds(5));
+
+    GIVEN("A cache with one resolved and one failed host")
+    {
+        cache.put("example.com", "93.184.216.34");
+        cache.put("nonexistent.invalid", "");
+
+        THEN("The resolved host is found")
+        {
+            std::string ip;
+            REQUIRE(cache.get("example.com", ip));
+            REQUIRE(ip == "93.184.216.34");
+        }
+        AND_THEN("The failed lookup is found with an empty address")
+        {
+            std::string ip = "x";
+            REQUIRE(cache.get("nonexistent.invalid", ip));
+            REQUIRE(ip.empty());
+        }
+        AND_THEN("Unknown hosts are not found")
+        {
+            std::string ip;
+            REQUIRE_FALSE(cache.get("example.org", ip));
+        }
+        AND_THEN("Removed hosts are not found")
+        {
+            std::string ip;
+            cache.remove("example.com");
+            REQUIRE_FALSE(cache.get("example.com", ip));
+        }
+    }
+
+    GIVEN("A cache with a zero TTL")
+    {
+        cache.set_ttl(seconds(0), seconds(0));
+        cache.put("example.com", "93.184.216.34");
+
+        THEN("Entries expire immediately")
+        {
+            std::string ip;
+            REQUIRE_FALSE(cache.get("example.com", ip));
+        }
+    }
+
+    cache.clear();
+    cache.set_ttl(seconds(60), seconds(5));
+}
+
+SCENARIO("Resolving a copy of an address")
+{
+    auto& cache = DnsCache::instance();
+    cache.clear();
+    cache.put("example.com", "93.184.216.34");
+
+    GIVEN("An unresolved address")
+    {
+        IPv4 address{ "example.com", 80 };
+        auto copy = address.clone();
+
+        WHEN("The copy is resolved")
+        {
+            REQUIRE(copy->resolve_ip_cached());
+            REQUIRE(copy->is_valid());
+
+            THEN("The original is untouched until the result is assigned")
+            {
+                REQUIRE_FALSE(address.is_valid());
+
+                address.assign(*copy);
+                REQUIRE(address.is_valid());
+                REQUIRE(address.get_resolved_ip() == "93.184.216.34");
+                REQUIRE(address.get_port() == 80);
+
+                const auto* sock_addr = reinterpret_cast<const sockaddr_in*>(address.get_socket_address());
+                REQUIRE(sock_addr->sin_family == AF_INET);
+                REQUIRE(ntohs(sock_addr->sin_port) == 80);
+            }
+        }
+    }
+
+    cache.clear();
+}
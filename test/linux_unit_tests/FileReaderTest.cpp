@@ -0,0 +1,176 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <catch2/catch.hpp>
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/FileReader.h"
+#include "smooth/core/filesystem/FSLock.h"
+#include "smooth/application/network/http/regular/responses/FileContentResponse.h"
+
+using namespace smooth::core::filesystem;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular::responses;
+
+namespace
+{
+    Path write_test_file(std::size_t size)
+    {
+        std::string content{};
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            content.push_back(static_cast<char>('a' + i % 26));
+        }
+
+        Path path{ "/tmp/smooth_file_reader_test.txt" };
+        REQUIRE(File{ path }.write(content));
+
+        return path;
+    }
+
+    std::string send_all(FileContentResponse& response, std::size_t chunk_size, bool prepare_next)
+    {
+        std::string res{};
+        auto status = ResponseStatus::HasMoreData;
+
+        while (status == ResponseStatus::HasMoreData)
+        {
+            std::vector<uint8_t> data{};
+            status = response.get_data(chunk_size, data);
+            REQUIRE(status != ResponseStatus::Error);
+            REQUIRE(data.size() <= chunk_size);
+            res.append(data.begin(), data.end());
+
+            if (prepare_next && status == ResponseStatus::HasMoreData)
+            {
+                response.prepare_next(chunk_size);
+            }
+        }
+
+        return res;
+    }
+}
+
+SCENARIO("Reading a file in parts")
+{
+    GIVEN("A file")
+    {
+        FSLock::set_limit(2);
+        auto path = write_test_file(100);
+        std::string expected{};
+        File{ path }.read(expected);
+
+        WHEN("Reading it with a FileReader")
+        {
+            FileReader reader{ path, 10 };
+            REQUIRE(reader.is_open());
+
+            THEN("It holds a file slot until destroyed and reads from where it was asked to")
+            {
+                REQUIRE(FSLock::open_files() == 1);
+
+                std::vector<uint8_t> data{};
+                REQUIRE(reader.read(data, 20));
+                REQUIRE(reader.read(data, 30));
+                REQUIRE(std::string(data.begin(), data.end()) == expected.substr(10, 50));
+
+                REQUIRE(reader.seek(95));
+                data.clear();
+                REQUIRE_FALSE(reader.read(data, 10));
+                REQUIRE(std::string(data.begin(), data.end()) == expected.substr(95));
+            }
+        }
+
+        AND_WHEN("All file slots are taken")
+        {
+            FSLock first{};
+            FSLock second{};
+            FileReader reader{ path, 0 };
+
+            THEN("The reader isn't opened")
+            {
+                REQUIRE_FALSE(reader.is_open());
+                REQUIRE(FSLock::open_files() == 2);
+            }
+        }
+
+        REQUIRE(FSLock::open_files() == 0);
+        std::remove(path);
+    }
+}
+
+SCENARIO("Sending a file with FileContentResponse")
+{
+    GIVEN("A file larger than the chunk size")
+    {
+        FSLock::set_limit(2);
+        auto path = write_test_file(10000);
+        std::string expected{};
+        File{ path }.read(expected);
+
+        WHEN("Sending it, reading ahead")
+        {
+            FileContentResponse response{ path };
+
+            THEN("The content is sent unchanged")
+            {
+                REQUIRE(send_all(response, 1024, true) == expected);
+                REQUIRE(FSLock::open_files() == 0);
+            }
+        }
+
+        AND_WHEN("Sending it without reading ahead")
+        {
+            FileContentResponse response{ path };
+
+            THEN("The content is sent unchanged")
+            {
+                REQUIRE(send_all(response, 999, false) == expected);
+            }
+        }
+
+        AND_WHEN("Sending it while all file slots are taken by others, for a while")
+        {
+            FileContentResponse response{ path };
+            auto first = std::make_unique<FSLock>();
+            auto second = std::make_unique<FSLock>();
+
+            std::thread other{ [&first, &second]() {
+                                   std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+                                   first.reset();
+                                   second.reset();
+                               } };
+
+            THEN("The file is read as soon as a slot is available")
+            {
+                std::vector<uint8_t> data{};
+                REQUIRE(response.get_data(1000, data) == ResponseStatus::HasMoreData);
+                other.join();
+
+                std::string sent{ data.begin(), data.end() };
+                sent += send_all(response, 1000, true);
+                REQUIRE(sent == expected);
+            }
+        }
+
+        std::remove(path);
+    }
+}
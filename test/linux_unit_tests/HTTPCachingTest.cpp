@@ -0,0 +1,104 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <chrono>
+#include <ctime>
+#include <catch2/catch.hpp>
+#include "smooth/application/network/http/http_utils.h"
+
+using namespace smooth::application::network::http::utils;
+using namespace std::chrono;
+
+SCENARIO("Formatting and parsing HTTP dates")
+{
+    GIVEN("Known dates")
+    {
+        THEN("They are formatted in the preferred format")
+        {
+            REQUIRE(make_http_time(time_t{ 0 }) == "Thu, 01 Jan 1970 00:00:00 GMT");
+            REQUIRE(make_http_time(time_t{ 784111777 }) == "Sun, 06 Nov 1994 08:49:37 GMT");
+            REQUIRE(make_http_time(time_t{ 951782400 }) == "Tue, 29 Feb 2000 00:00:00 GMT");
+            REQUIRE(make_http_time(time_t{ 4102444799 }) == "Thu, 31 Dec 2099 23:59:59 GMT");
+        }
+
+        AND_THEN("They are parsed")
+        {
+            REQUIRE(parse_http_time("Sun, 06 Nov 1994 08:49:37 GMT") == system_clock::from_time_t(784111777));
+            REQUIRE(parse_http_time("Tue, 29 Feb 2000 00:00:00 GMT") == system_clock::from_time_t(951782400));
+        }
+    }
+
+    GIVEN("Dates over many years")
+    {
+        THEN("Formatting matches gmtime(), and parsing gives the same time back")
+        {
+            for (time_t t = 0; t < 4102444800; t += 86400 * 37 + 3671)
+            {
+                tm expected{};
+                gmtime_r(&t, &expected);
+                char buff[64];
+                strftime(buff, sizeof(buff), "%a, %d %b %Y %H:%M:%S GMT", &expected);
+
+                auto formatted = make_http_time(t);
+                REQUIRE(formatted == buff);
+                REQUIRE(parse_http_time(formatted) == system_clock::from_time_t(t));
+                REQUIRE(timegm(expected) == t);
+            }
+        }
+    }
+
+    GIVEN("Malformed dates")
+    {
+        THEN("They are rejected")
+        {
+            for (const auto* date : { "", "Sun, 06 Nov 1994 08:49:37", "Sunday, 06-Nov-94 08:49:37 GMT",
+                                      "Sun Nov  6 08:49:37 1994", "Sun, 06 Nov 1994 08:49:37 UTC",
+                                      "Sun, 06 Nox 1994 08:49:37 GMT", "Sun, 32 Nov 1994 08:49:37 GMT",
+                                      "Sun, 06 Nov 1994 24:49:37 GMT", "Sun, 0x Nov 1994 08:49:37 GMT" })
+            {
+                REQUIRE(parse_http_time(date) == system_clock::time_point::min());
+            }
+        }
+    }
+}
+
+SCENARIO("Matching entity tags")
+{
+    GIVEN("An entity tag")
+    {
+        const std::string etag = R"("1a2b-5e0c3a01")";
+
+        THEN("Weak comparison ignores the weakness indicator")
+        {
+            REQUIRE(etag_matches(R"("1a2b-5e0c3a01")", etag, true));
+            REQUIRE(etag_matches(R"("x", W/"1a2b-5e0c3a01")", etag, true));
+            REQUIRE(etag_matches("*", etag, true));
+            REQUIRE(etag_matches(" * ", etag, true));
+            REQUIRE_FALSE(etag_matches(R"("1a2b-5e0c3a02")", etag, true));
+            REQUIRE_FALSE(etag_matches("", etag, true));
+            REQUIRE_FALSE(etag_matches("*", "", true));
+        }
+
+        AND_THEN("Strong comparison never matches weak entity tags")
+        {
+            REQUIRE(etag_matches(R"("1a2b-5e0c3a01")", etag, false));
+            REQUIRE_FALSE(etag_matches(R"(W/"1a2b-5e0c3a01")", etag, false));
+            REQUIRE_FALSE(etag_matches(R"("1a2b-5e0c3a01")", R"(W/"1a2b-5e0c3a01")", false));
+            REQUIRE_FALSE(etag_matches("Sun, 06 Nov 1994 08:49:37 GMT", etag, false));
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <catch2/catch.hpp>
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+
+using namespace smooth::application::network::http::regular;
+
+SCENARIO("HeaderMap")
+{
+    GIVEN("A map with a few headers")
+    {
+        HeaderMap headers{};
+        headers.add("Content-Type", "text/html");
+        headers.add("Accept", "text/html");
+        headers.add("accept", "application/json");
+
+        THEN("Lookups ignore case")
+        {
+            REQUIRE(headers.size() == 2);
+            REQUIRE(headers.get("content-type") == "text/html");
+            REQUIRE(headers.get("CONTENT-TYPE") == "text/html");
+            REQUIRE(headers.contains("Content-type"));
+            REQUIRE_FALSE(headers.contains("Content-Length"));
+            REQUIRE(headers.get("Content-Length").empty());
+        }
+        AND_THEN("Repeated headers are combined")
+        {
+            REQUIRE(headers.get("Accept") == "text/html, application/json");
+            REQUIRE(headers[1].first == "Accept");
+            REQUIRE(headers[1].second == "text/html, application/json");
+        }
+        AND_THEN("Values survive moving the map")
+        {
+            HeaderMap moved{ std::move(headers) };
+            REQUIRE(moved.get("content-type") == "text/html");
+        }
+        AND_THEN("Clearing empties the map")
+        {
+            headers.clear();
+            REQUIRE(headers.empty());
+            REQUIRE_FALSE(headers.contains("Accept"));
+        }
+    }
+}
+
+SCENARIO("Parsing request headers")
+{
+    GIVEN("A request")
+    {
+        std::string block = "GET /api/device?id=2 HTTP/1.1\r\n"
+                            "Host: example.com\r\n"
+                            "Connection:keep-alive \r\n"
+                            "Content-Length: 12\r\n"
+                            "X-Empty:\r\n"
+                            "Invalid : value\r\n"
+                            "No colon here\r\n";
+
+        HTTPHeaderParser parser{};
+        HeaderMap headers{};
+
+        THEN("The request line and headers are parsed")
+        {
+            REQUIRE(parser.parse(block, headers));
+            REQUIRE(parser.is_request());
+            REQUIRE(parser.method() == HTTPMethod::GET);
+            REQUIRE(parser.url() == "/api/device?id=2");
+            REQUIRE(parser.version() == "1.1");
+
+            REQUIRE(headers.size() == 4);
+            REQUIRE(headers.get("host") == "example.com");
+            REQUIRE(headers.get("connection") == "keep-alive");
+            REQUIRE(headers.get("content-length") == "12");
+            REQUIRE(headers.contains("x-empty"));
+            REQUIRE(headers.get("x-empty").empty());
+        }
+    }
+
+    GIVEN("A request with an unsupported method")
+    {
+        HTTPHeaderParser parser{};
+        HeaderMap headers{};
+
+        THEN("It is parsed, without method")
+        {
+            REQUIRE(parser.parse("OPTIONS * HTTP/1.1\r\n", headers));
+            REQUIRE(parser.is_request());
+            REQUIRE_FALSE(parser.method().has_value());
+            REQUIRE(parser.url() == "*");
+        }
+        AND_THEN("Methods are case sensitive")
+        {
+            REQUIRE(parser.parse("get / HTTP/1.1\r\n", headers));
+            REQUIRE_FALSE(parser.method().has_value());
+        }
+    }
+
+    GIVEN("Malformed request lines")
+    {
+        HTTPHeaderParser parser{};
+        HeaderMap headers{};
+
+        THEN("They are rejected")
+        {
+            REQUIRE_FALSE(parser.parse("GET /\r\n", headers));
+            REQUIRE_FALSE(parser.parse("GET  HTTP/1.1\r\n", headers));
+            REQUIRE_FALSE(parser.parse("GET / HTTP/1\r\n", headers));
+            REQUIRE_FALSE(parser.parse("", headers));
+        }
+    }
+}
+
+SCENARIO("Parsing response headers")
+{
+    HTTPHeaderParser parser{};
+    HeaderMap headers{};
+
+    GIVEN("A response")
+    {
+        THEN("The status line and headers are parsed")
+        {
+            REQUIRE(parser.parse("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n", headers));
+            REQUIRE_FALSE(parser.is_request());
+            REQUIRE(parser.version() == "1.1");
+            REQUIRE(parser.status() == 404);
+            REQUIRE(headers.get("Content-Length") == "0");
+        }
+        AND_THEN("The reason phrase may be empty")
+        {
+            REQUIRE(parser.parse("HTTP/1.0 200\r\n", headers));
+            REQUIRE(parser.status() == 200);
+        }
+    }
+
+    GIVEN("Malformed status lines")
+    {
+        THEN("They are rejected")
+        {
+            REQUIRE_FALSE(parser.parse("HTTP/1.1 20 OK\r\n", headers));
+            REQUIRE_FALSE(parser.parse("HTTP/1.1 2000 OK\r\n", headers));
+            REQUIRE_FALSE(parser.parse("HTTP/1.1 abc OK\r\n", headers));
+            REQUIRE_FALSE(parser.parse("HTTP/x.1 200 OK\r\n", headers));
+        }
+    }
+}
@@ -0,0 +1,218 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <catch2/catch.hpp>
+#include "smooth/core/network/PacketReceiveBuffer.h"
+#include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
+
+using namespace smooth::core::network;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+
+namespace
+{
+    class NullResponse
+        : public IServerResponse, public IUpgradeToWebsocket
+    {
+        public:
+            void reply(std::unique_ptr<IResponseOperation>, bool) override
+            {
+            }
+
+            void reply_error(std::unique_ptr<IResponseOperation>) override
+            {
+            }
+
+            void upgrade_to_websocket() override
+            {
+            }
+
+        protected:
+            smooth::core::Task& get_task() override
+            {
+                // Never called, no websocket upgrades here.
+                std::abort();
+            }
+
+            void upgrade_to_websocket_internal() override
+            {
+            }
+    };
+
+    /// Hands out data like recv() would, up to the wanted amount per call.
+    class Reader
+    {
+        public:
+            explicit Reader(std::string data)
+                    : data(std::move(data))
+            {
+            }
+
+            int operator()(uint8_t* write_pos, int wanted_length)
+            {
+                ++calls;
+                auto amount = std::min(data.size() - pos, static_cast<std::size_t>(wanted_length));
+                memcpy(write_pos, data.data() + pos, amount);
+                pos += amount;
+
+                return amount > 0 ? static_cast<int>(amount) : -1;
+            }
+
+            int calls = 0;
+        private:
+            std::string data;
+            std::size_t pos = 0;
+    };
+
+    std::string content_of(HTTPPacket& p)
+    {
+        return std::string{ p.data().begin(), p.data().end() };
+    }
+}
+
+SCENARIO("Pipelined HTTP requests")
+{
+    GIVEN("A receive buffer for HTTP requests")
+    {
+        NullResponse response{};
+        PacketReceiveBuffer<RegularHTTPProtocol> rx{
+            std::make_unique<RegularHTTPProtocol>(1024, 1024, response, response), BufferDepth{ 4, 4 } };
+
+        auto receive = [&rx](Reader& reader) {
+                           return rx.receive([&reader](uint8_t* write_pos, int wanted_length) {
+                                                 return reader(write_pos, wanted_length);
+                                             },
+                                             []() {});
+                       };
+
+        WHEN("Receiving three requests in one read")
+        {
+            Reader reader{ "GET /first HTTP/1.1\r\nHost: a\r\n\r\n"
+                           "POST /second HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+                           "GET /third HTTP/1.1\r\n\r\n" };
+
+            auto res = receive(reader);
+            REQUIRE(res.read_count > 0);
+            REQUIRE_FALSE(res.buffered);
+
+            THEN("The requests following the first one are assembled without reading again")
+            {
+                REQUIRE(rx.has_buffered_data());
+                REQUIRE(receive(reader).buffered);
+                REQUIRE(receive(reader).buffered);
+                REQUIRE_FALSE(rx.has_buffered_data());
+                REQUIRE(reader.calls == 1);
+
+                HTTPPacket p{};
+                REQUIRE(rx.get(p));
+                REQUIRE(p.get_request_method() == HTTPMethod::GET);
+                REQUIRE(p.get_request_url() == "/first");
+                REQUIRE(p.headers().get("host") == "a");
+                REQUIRE(p.data().empty());
+
+                REQUIRE(rx.get(p));
+                REQUIRE(p.get_request_method() == HTTPMethod::POST);
+                REQUIRE(p.get_request_url() == "/second");
+                REQUIRE(content_of(p) == "hello");
+
+                REQUIRE(rx.get(p));
+                REQUIRE(p.get_request_url() == "/third");
+                REQUIRE(p.data().empty());
+
+                REQUIRE_FALSE(rx.get(p));
+            }
+        }
+
+        WHEN("A pipelined request is split between reads")
+        {
+            Reader reader{ "POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nabcGET /b HT" };
+            REQUIRE(receive(reader).read_count > 0);
+            REQUIRE(rx.has_buffered_data());
+            REQUIRE(receive(reader).buffered);
+            REQUIRE_FALSE(rx.has_buffered_data());
+
+            THEN("The rest is read from the socket")
+            {
+                Reader rest{ "TP/1.1\r\n\r\n" };
+                auto res = receive(rest);
+                REQUIRE(res.read_count > 0);
+                REQUIRE_FALSE(res.buffered);
+
+                HTTPPacket p{};
+                REQUIRE(rx.get(p));
+                REQUIRE(content_of(p) == "abc");
+                REQUIRE(rx.get(p));
+                REQUIRE(p.get_request_url() == "/b");
+            }
+        }
+
+        WHEN("Receiving a request with conflicting Content-Length headers")
+        {
+            Reader reader{ "POST /a HTTP/1.1\r\nContent-Length: 5\r\nContent-Length: 10\r\n\r\n"
+                           "GET /smuggled HTTP/1.1\r\n\r\n" };
+
+            auto res = receive(reader);
+
+            THEN("It is an error and the body is not treated as the next request")
+            {
+                REQUIRE(res.assembly_error);
+                REQUIRE_FALSE(rx.has_buffered_data());
+
+                HTTPPacket p{};
+                REQUIRE_FALSE(rx.get(p));
+            }
+        }
+
+        WHEN("Receiving a request with an invalid Content-Length header")
+        {
+            Reader reader{ "POST /a HTTP/1.1\r\nContent-Length: abc\r\n\r\n"
+                           "GET /smuggled HTTP/1.1\r\n\r\n" };
+
+            auto res = receive(reader);
+
+            THEN("It is an error and the body is not treated as the next request")
+            {
+                REQUIRE(res.assembly_error);
+                REQUIRE_FALSE(rx.has_buffered_data());
+
+                HTTPPacket p{};
+                REQUIRE_FALSE(rx.get(p));
+            }
+        }
+
+        WHEN("Receiving a request with a Transfer-Encoding that isn't chunked")
+        {
+            Reader reader{ "POST /a HTTP/1.1\r\nTransfer-Encoding: chunked, gzip\r\nContent-Length: 5\r\n\r\n"
+                           "hello"
+                           "GET /smuggled HTTP/1.1\r\n\r\n" };
+
+            auto res = receive(reader);
+
+            THEN("It is an error")
+            {
+                REQUIRE(res.assembly_error);
+                REQUIRE_FALSE(rx.has_buffered_data());
+
+                HTTPPacket p{};
+                REQUIRE_FALSE(rx.get(p));
+            }
+        }
+    }
+}
@@ -0,0 +1,305 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <catch2/catch.hpp>
+#include "smooth/core/filesystem/FSLock.h"
+#include "smooth/core/network/IPacketDisassembly.h"
+#include "smooth/core/network/PacketSendBuffer.h"
+
+using namespace smooth::core::network;
+
+namespace
+{
+    class TextPacket
+        : public IPacketDisassembly
+    {
+        public:
+            TextPacket() = default;
+
+            explicit TextPacket(const std::string& text)
+                    : data(text.begin(), text.end())
+            {
+            }
+
+            int get_send_length() override
+            {
+                return static_cast<int>(data.size());
+            }
+
+            const uint8_t* get_data() override
+            {
+                return data.data();
+            }
+
+        private:
+            std::vector<uint8_t> data{};
+    };
+
+    struct TextProtocol
+    {
+        using packet_type = TextPacket;
+    };
+
+    using Buffer = PacketSendBuffer<TextProtocol>;
+
+    class FilePacket
+        : public TextPacket
+    {
+        public:
+            FilePacket() = default;
+
+            FilePacket(const std::string& text, std::shared_ptr<FileRegion> region)
+                    : TextPacket(text), region(std::move(region))
+            {
+            }
+
+            const FileRegion* get_file_region() override
+            {
+                return region.get();
+            }
+
+        private:
+            std::shared_ptr<FileRegion> region{};
+    };
+
+    struct FileProtocol
+    {
+        using packet_type = FilePacket;
+    };
+
+    const char* file_region_path = "/tmp/smooth_file_region_test.bin";
+
+    void write_file(std::size_t size)
+    {
+        auto* f = std::fopen(file_region_path, "wb");
+        REQUIRE(f != nullptr);
+        std::string content(size, 'f');
+        std::fwrite(content.data(), 1, content.size(), f);
+        std::fclose(f);
+    }
+}
+
+SCENARIO("Coalescing packets in a PacketSendBuffer")
+{
+    GIVEN("A buffer holding a header and a body")
+    {
+        Buffer buff{ BufferDepth{ 4, 4 } };
+        REQUIRE(buff.put(TextPacket{ "header" }));
+        REQUIRE(buff.put(TextPacket{ "body" }));
+
+        std::vector<uint8_t> staging{};
+        std::string written{};
+
+        auto writer = [&written](const uint8_t* data, int length) {
+                          written.assign(data, data + length);
+
+                          return length;
+                      };
+
+        WHEN("Sending with room for both")
+        {
+            auto res = buff.send_coalesced(staging, 100, 0, writer);
+
+            THEN("They are written at once")
+            {
+                REQUIRE(written == "headerbody");
+                REQUIRE(res.sent_count == 10);
+                REQUIRE(res.write_length == 10);
+                REQUIRE(res.packets_completed == 2);
+                REQUIRE(buff.is_empty());
+            }
+        }
+
+        WHEN("Sending with room for less than both")
+        {
+            auto res = buff.send_coalesced(staging, 8, 0, writer);
+
+            THEN("The write is limited to the max length")
+            {
+                REQUIRE(written == "headerbo");
+                REQUIRE(res.packets_completed == 1);
+                REQUIRE_FALSE(buff.is_empty());
+
+                res = buff.send_coalesced(staging, 8, 0, writer);
+                REQUIRE(written == "dy");
+                REQUIRE(res.packets_completed == 1);
+                REQUIRE(buff.is_empty());
+            }
+        }
+
+        WHEN("The writer asks for the write to be repeated")
+        {
+            auto res = buff.send_coalesced(staging, 8, 0, [](const uint8_t*, int) { return -1; });
+            REQUIRE(res.write_length == 8);
+            REQUIRE(res.packets_completed == 0);
+
+            // More data is queued in the meantime, the repeated write must still be of the same length.
+            REQUIRE(buff.put(TextPacket{ "more" }));
+            res = buff.send_coalesced(staging, 100, res.write_length, writer);
+
+            THEN("The same data is written again")
+            {
+                REQUIRE(written == "headerbo");
+                REQUIRE(res.packets_completed == 1);
+            }
+        }
+    }
+
+    GIVEN("A buffer holding a single large packet")
+    {
+        Buffer buff{ BufferDepth{ 4, 4 } };
+        REQUIRE(buff.put(TextPacket{ std::string(50, 'x') }));
+
+        std::vector<uint8_t> staging{};
+
+        WHEN("Sending")
+        {
+            const uint8_t* written = nullptr;
+            auto res = buff.send_coalesced(staging, 20, 0, [&written](const uint8_t* data, int length) {
+                                               written = data;
+
+                                               return length;
+                                           });
+
+            THEN("It is written from the packet itself")
+            {
+                REQUIRE(res.sent_count == 20);
+                REQUIRE(res.packets_completed == 0);
+                REQUIRE(staging.empty());
+                REQUIRE(written != nullptr);
+            }
+        }
+    }
+}
+
+SCENARIO("Sending file regions from a PacketSendBuffer")
+{
+    smooth::core::filesystem::FSLock::set_limit(2);
+    write_file(100);
+
+    GIVEN("A packet with a file region larger than 2 GiB")
+    {
+        const std::size_t region_length = 3ULL * 1024 * 1024 * 1024;
+        PacketSendBuffer<FileProtocol> buff{ BufferDepth{ 2, 2 } };
+        REQUIRE(buff.put(FilePacket{ "header", FileRegion::open(file_region_path, 0, region_length) }));
+        REQUIRE(buff.prepare_next_packet_if_idle());
+
+        auto writer = [](const uint8_t*, int length, bool) {
+                          return length;
+                      };
+
+        WHEN("Sending all of it")
+        {
+            std::size_t file_sent = 0;
+            auto file_writer = [&file_sent](const FileRegion&, std::size_t already_sent, std::size_t length) {
+                                   REQUIRE(already_sent == file_sent);
+                                   auto sent = std::min(length, std::size_t{ 1024 * 1024 * 1024 });
+                                   file_sent += sent;
+
+                                   return static_cast<int>(sent);
+                               };
+
+            auto res = buff.send(writer, file_writer);
+            REQUIRE(res.sent_count == 6);
+
+            for (int i = 0; i < 2; ++i)
+            {
+                res = buff.send(writer, file_writer);
+                REQUIRE_FALSE(res.packet_complete);
+            }
+
+            res = buff.send(writer, file_writer);
+
+            THEN("The offsets don't overflow and the packet completes")
+            {
+                REQUIRE(res.packet_complete);
+                REQUIRE(file_sent == region_length);
+                REQUIRE(buff.is_empty());
+            }
+        }
+    }
+
+    GIVEN("A file that has shrunk since the region was opened")
+    {
+        auto region = FileRegion::open(file_region_path, 0, 200);
+        REQUIRE(region);
+
+        int sockets[2]{};
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+
+        THEN("Sending past the end of the file fails instead of waiting for more data")
+        {
+            REQUIRE(region->send_to(sockets[0], 0, 200) == 100);
+            REQUIRE(region->send_to(sockets[0], 100, 100) == -1);
+        }
+
+        close(sockets[0]);
+        close(sockets[1]);
+    }
+
+    std::remove(file_region_path);
+}
+
+SCENARIO("Sending packets from a PacketSendBuffer in batches")
+{
+    GIVEN("A buffer holding more packets than fit in a batch")
+    {
+        Buffer buff{ BufferDepth{ 4, 4 } };
+        REQUIRE(buff.put(TextPacket{ "one" }));
+        REQUIRE(buff.put(TextPacket{ "two" }));
+        REQUIRE(buff.put(TextPacket{ "three" }));
+
+        std::vector<std::string> staged{};
+        auto stage = [&staged](TextPacket& packet) {
+                         staged.emplace_back(packet.get_data(), packet.get_data() + packet.get_send_length());
+                     };
+        auto flush = [&staged]() {
+                         return static_cast<int>(staged.size());
+                     };
+
+        WHEN("Sending the first batch")
+        {
+            auto res = buff.send_batch(2, stage, flush);
+
+            THEN("The buffer is not yet drained")
+            {
+                REQUIRE(res.sent_count == 2);
+                REQUIRE_FALSE(res.packet_complete);
+                REQUIRE_FALSE(buff.is_empty());
+            }
+            AND_WHEN("Sending the second batch")
+            {
+                staged.clear();
+                res = buff.send_batch(2, stage, flush);
+
+                THEN("The buffer is drained")
+                {
+                    REQUIRE(res.sent_count == 1);
+                    REQUIRE(staged.front() == "three");
+                    REQUIRE(res.packet_complete);
+                    REQUIRE(buff.is_empty());
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,195 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/FSLock.h"
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/responses/FileContentResponse.h"
+
+using namespace smooth::core::filesystem;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::utils;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::application::network::http::regular::responses;
+
+namespace
+{
+    std::vector<std::pair<std::size_t, std::size_t>> parse(std::string_view range, std::size_t size, bool& valid)
+    {
+        std::vector<ByteRange> ranges{};
+        valid = parse_byte_ranges(range, size, ranges);
+
+        std::vector<std::pair<std::size_t, std::size_t>> res{};
+
+        for (const auto& r : ranges)
+        {
+            res.emplace_back(r.first, r.last);
+        }
+
+        return res;
+    }
+
+    std::string send_all(FileContentResponse& response, std::size_t chunk_size)
+    {
+        std::string res{};
+        auto status = ResponseStatus::HasMoreData;
+
+        while (status == ResponseStatus::HasMoreData)
+        {
+            std::vector<uint8_t> data{};
+            status = response.get_data(chunk_size, data);
+            REQUIRE(status != ResponseStatus::Error);
+            REQUIRE(data.size() <= chunk_size);
+            res.append(data.begin(), data.end());
+            response.prepare_next(chunk_size);
+        }
+
+        return res;
+    }
+
+    using Ranges = std::vector<std::pair<std::size_t, std::size_t>>;
+}
+
+SCENARIO("Parsing Range headers")
+{
+    bool valid = false;
+
+    GIVEN("Well-formed byte ranges")
+    {
+        THEN("They are limited to the size")
+        {
+            REQUIRE(parse("bytes=0-99", 1000, valid) == Ranges{ { 0, 99 } });
+            REQUIRE(valid);
+            REQUIRE(parse("bytes=900-", 1000, valid) == Ranges{ { 900, 999 } });
+            REQUIRE(parse("bytes=-100", 1000, valid) == Ranges{ { 900, 999 } });
+            REQUIRE(parse("bytes=-2000", 1000, valid) == Ranges{ { 0, 999 } });
+            REQUIRE(parse("bytes=990-2000", 1000, valid) == Ranges{ { 990, 999 } });
+            REQUIRE(parse("Bytes=5-5", 1000, valid) == Ranges{ { 5, 5 } });
+            REQUIRE(parse("bytes=0-99999999999999999999999", 10, valid) == Ranges{ { 0, 9 } });
+            REQUIRE(valid);
+        }
+
+        AND_THEN("Multiple ranges are sorted, and merged where overlapping or adjacent")
+        {
+            REQUIRE(parse("bytes=500-599, 0-99", 1000, valid) == Ranges{ { 0, 99 }, { 500, 599 } });
+            REQUIRE(parse("bytes=0-99,100-199, 150-300,,-10", 1000, valid) == Ranges{ { 0, 300 }, { 990, 999 } });
+            REQUIRE(valid);
+        }
+
+        AND_THEN("Unsatisfiable ranges are left out")
+        {
+            REQUIRE(parse("bytes=1000-", 1000, valid).empty());
+            REQUIRE(valid);
+            REQUIRE(parse("bytes=-0", 1000, valid).empty());
+            REQUIRE(valid);
+            REQUIRE(parse("bytes=0-0", 0, valid).empty());
+            REQUIRE(valid);
+            REQUIRE(parse("bytes=2000-3000, 0-1", 1000, valid) == Ranges{ { 0, 1 } });
+        }
+    }
+
+    GIVEN("Malformed ranges")
+    {
+        THEN("The header is rejected")
+        {
+            for (const auto* range : { "", "bytes=", "bytes=,", "items=0-1", "bytes=1", "bytes=5-4", "bytes=a-b",
+                                       "bytes=0-1, x", "bytes= 0 - 1", "bytes=0-1,2-3,4-5,6-7,8-9,10-11,12-13,"
+                                       "14-15,16-17,18-19,20-21,22-23,24-25,26-27,28-29,30-31,32-33" })
+            {
+                REQUIRE(parse(range, 1000, valid).empty());
+                REQUIRE_FALSE(valid);
+            }
+        }
+    }
+}
+
+SCENARIO("Sending ranges of a file")
+{
+    GIVEN("A file")
+    {
+        FSLock::set_limit(2);
+        Path path{ "/tmp/smooth_range_request_test.txt" };
+        std::string content{};
+
+        for (std::size_t i = 0; i < 5000; ++i)
+        {
+            content.push_back(static_cast<char>('a' + i % 26));
+        }
+
+        REQUIRE(File{ path }.write(content));
+        auto file = CachedFile::stat(path);
+
+        WHEN("Sending a single range")
+        {
+            FileContentResponse response{ file, "text/plain", "", { ByteRange{ 1000, 2999 } } };
+
+            THEN("Only the range is sent, as partial content")
+            {
+                REQUIRE(response.get_response_code() == ResponseCode::Partial_Content);
+                REQUIRE(response.get_headers().at(CONTENT_RANGE) == "bytes 1000-2999/5000");
+                REQUIRE(response.get_headers().at(CONTENT_LENGTH) == "2000");
+                REQUIRE(response.get_headers().at(ACCEPT_RANGES) == "bytes");
+                REQUIRE(send_all(response, 512) == content.substr(1000, 2000));
+            }
+        }
+
+        AND_WHEN("Sending multiple ranges")
+        {
+            FileContentResponse response{ file, "text/plain", "", { ByteRange{ 0, 9 }, ByteRange{ 4000, 4999 } } };
+
+            THEN("The ranges are sent as multipart/byteranges")
+            {
+                const std::string boundary = "SMOOTH_BYTERANGES_2f9c81d4a6e5";
+                auto expected = "--" + boundary + "\r\n"
+                                + "Content-Type: text/plain\r\n"
+                                + "Content-Range: bytes 0-9/5000\r\n\r\n"
+                                + content.substr(0, 10)
+                                + "\r\n--" + boundary + "\r\n"
+                                + "Content-Type: text/plain\r\n"
+                                + "Content-Range: bytes 4000-4999/5000\r\n\r\n"
+                                + content.substr(4000)
+                                + "\r\n--" + boundary + "--\r\n";
+
+                REQUIRE(response.get_response_code() == ResponseCode::Partial_Content);
+                REQUIRE(response.get_headers().at(CONTENT_TYPE) == "multipart/byteranges; boundary=" + boundary);
+                REQUIRE(response.get_headers().at(CONTENT_LENGTH) == std::to_string(expected.size()));
+                REQUIRE(response.get_file_region() == nullptr);
+                REQUIRE(send_all(response, 100) == expected);
+            }
+        }
+
+        AND_WHEN("Sending no ranges")
+        {
+            FileContentResponse response{ file, "text/plain" };
+
+            THEN("The entire file is sent, announcing that ranges are accepted")
+            {
+                REQUIRE(response.get_response_code() == ResponseCode::OK);
+                REQUIRE(response.get_headers().count(CONTENT_RANGE) == 0);
+                REQUIRE(response.get_headers().at(ACCEPT_RANGES) == "bytes");
+                REQUIRE(send_all(response, 1024) == content);
+            }
+        }
+
+        std::remove(path);
+    }
+}
@@ -0,0 +1,172 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "smooth/application/network/http/ResponseBody.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "smooth/application/network/http/websocket/responses/WSResponse.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::application::network::http::regular::responses;
+using namespace smooth::application::network::http::websocket::responses;
+
+namespace
+{
+    std::string take_all(ResponseBody& body, std::size_t chunk_size)
+    {
+        std::string res{};
+        std::vector<uint8_t> chunk{};
+
+        while (body.remaining() > 0)
+        {
+            chunk.clear();
+            auto expected = std::min(chunk_size, body.remaining());
+            REQUIRE(body.take(chunk_size, chunk) == expected);
+            REQUIRE(chunk.size() <= chunk_size);
+            res.append(chunk.begin(), chunk.end());
+        }
+
+        return res;
+    }
+
+    std::string send_all(IResponseOperation& response, std::size_t chunk_size)
+    {
+        std::string res{};
+        auto status = ResponseStatus::HasMoreData;
+
+        while (status == ResponseStatus::HasMoreData)
+        {
+            std::vector<uint8_t> data{};
+            status = response.get_data(chunk_size, data);
+            REQUIRE(status != ResponseStatus::Error);
+            res.append(data.begin(), data.end());
+        }
+
+        return res;
+    }
+}
+
+SCENARIO("Taking a response body in chunks")
+{
+    GIVEN("Bodies of different storage")
+    {
+        const std::string text = "The quick brown fox jumps over the lazy dog";
+        auto shared = std::make_shared<const std::string>(text);
+        auto shared_binary = std::make_shared<const std::vector<uint8_t>>(text.begin(), text.end());
+
+        std::vector<ResponseBody> bodies{ ResponseBody{ text },
+                                          ResponseBody{ std::vector<uint8_t>(text.begin(), text.end()) },
+                                          ResponseBody{ shared },
+                                          ResponseBody{ shared_binary },
+                                          ResponseBody::from_static("The quick brown fox jumps over the lazy dog") };
+
+        THEN("All of each body is handed out, in order")
+        {
+            for (auto& body : bodies)
+            {
+                REQUIRE(body.size() == text.size());
+                REQUIRE(take_all(body, 5) == text);
+                REQUIRE(body.remaining() == 0);
+
+                body.rewind();
+                REQUIRE(take_all(body, 100) == text);
+            }
+        }
+
+        AND_THEN("Copies share the storage, each keeping its own position")
+        {
+            ResponseBody first{ shared };
+            std::vector<uint8_t> chunk{};
+            first.take(4, chunk);
+
+            auto owners = shared.use_count();
+            ResponseBody second = first;
+            REQUIRE(shared.use_count() == owners + 1);
+            REQUIRE(take_all(second, 3) == text.substr(4));
+            REQUIRE(first.remaining() == text.size() - 4);
+            REQUIRE(take_all(first, 1000) == text.substr(4));
+        }
+    }
+
+    GIVEN("An empty body")
+    {
+        ResponseBody body{};
+
+        THEN("Nothing is handed out")
+        {
+            std::vector<uint8_t> chunk{};
+            REQUIRE(body.take(10, chunk) == 0);
+            REQUIRE(chunk.empty());
+            REQUIRE(ResponseBody{ std::shared_ptr<const std::string>{} }.size() == 0);
+        }
+    }
+}
+
+SCENARIO("Sending a shared body to many clients")
+{
+    GIVEN("A body shared by several responses")
+    {
+        std::string text(10000, 'x');
+        auto shared = std::make_shared<const std::string>(text);
+
+        std::vector<std::unique_ptr<StringResponse>> responses{};
+
+        for (int i = 0; i < 3; ++i)
+        {
+            responses.emplace_back(std::make_unique<StringResponse>(ResponseCode::OK, ResponseBody{ shared },
+                                                                    "text/plain"));
+        }
+
+        THEN("Each response sends all of it")
+        {
+            for (auto& response : responses)
+            {
+                REQUIRE(response->get_headers().at(CONTENT_LENGTH) == "10000");
+                REQUIRE(response->get_headers().at(CONTENT_TYPE) == "text/plain");
+                REQUIRE(send_all(*response, 1024) == text);
+            }
+        }
+    }
+
+    GIVEN("A StringResponse made from a string")
+    {
+        StringResponse response{ ResponseCode::OK, "Hello" };
+
+        THEN("The string is surrounded by HTML")
+        {
+            REQUIRE(response.get_headers().at(CONTENT_LENGTH) == "31");
+            REQUIRE(send_all(response, 4) == "<html><body>Hello</body></html>");
+        }
+    }
+
+    GIVEN("A websocket response with a shared body")
+    {
+        auto shared = std::make_shared<const std::vector<uint8_t>>(std::vector<uint8_t>{ 'a', 'b', 'c' });
+        WSResponse response{ ResponseBody{ shared }, true, true, true };
+
+        THEN("It is sent as a single text frame")
+        {
+            REQUIRE(send_all(response, 1024) == std::string{ "\x81\x03" "abc" });
+        }
+    }
+}
@@ -0,0 +1,159 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <utility>
+#include <catch2/catch.hpp>
+#include "smooth/application/network/http/regular/Router.h"
+
+using namespace smooth::application::network::http::regular;
+
+SCENARIO("Routing static URLs")
+{
+    GIVEN("A router with static routes sharing prefixes")
+    {
+        Router<int> router{};
+        REQUIRE(router.empty());
+        REQUIRE(router.add("/", 1));
+        REQUIRE(router.add("/api/device", 2));
+        REQUIRE(router.add("/api/devices", 3));
+        REQUIRE(router.add("/api/dev", 4));
+        REQUIRE(router.add("/about.html", 5));
+        REQUIRE_FALSE(router.empty());
+
+        RouteParameters params{};
+
+        THEN("Each URL finds its own handler")
+        {
+            REQUIRE(*router.find("/", params) == 1);
+            REQUIRE(*router.find("/api/device", params) == 2);
+            REQUIRE(*router.find("/api/devices", params) == 3);
+            REQUIRE(*router.find("/api/dev", params) == 4);
+            REQUIRE(*router.find("/about.html", params) == 5);
+            REQUIRE(params.empty());
+        }
+        AND_THEN("Partial or unknown URLs find nothing")
+        {
+            REQUIRE(router.find("/api", params) == nullptr);
+            REQUIRE(router.find("/api/device/", params) == nullptr);
+            REQUIRE(router.find("/api/deviceX", params) == nullptr);
+            REQUIRE(router.find("/index.html", params) == nullptr);
+            REQUIRE(router.find("", params) == nullptr);
+        }
+        AND_THEN("Routes survive moving the router")
+        {
+            Router<int> moved{ std::move(router) };
+            REQUIRE(*moved.find("/api/devices", params) == 3);
+        }
+        AND_THEN("Adding a route again replaces the handler")
+        {
+            REQUIRE(router.add("/api/device", 6));
+            REQUIRE(*router.find("/api/device", params) == 6);
+        }
+    }
+}
+
+SCENARIO("Routing URLs with parameters")
+{
+    GIVEN("A router with parameter routes")
+    {
+        Router<int> router{};
+        REQUIRE(router.add("/api/device/:id", 1));
+        REQUIRE(router.add("/api/device/:id/sensor/:sensor", 2));
+        REQUIRE(router.add("/api/device/all", 3));
+
+        RouteParameters params{};
+
+        THEN("Parameters are extracted")
+        {
+            std::string url = "/api/device/42";
+            REQUIRE(*router.find(url, params) == 1);
+            REQUIRE(params.size() == 1);
+            REQUIRE(params.get("id") == "42");
+
+            // The value is a view into the URL
+            REQUIRE(params.get("id").data() == url.data() + 12);
+
+            REQUIRE(*router.find("/api/device/42/sensor/temp", params) == 2);
+            REQUIRE(params.size() == 2);
+            REQUIRE(params.get("id") == "42");
+            REQUIRE(params.get("sensor") == "temp");
+            REQUIRE_FALSE(params.contains("other"));
+            REQUIRE(params.get("other").empty());
+        }
+        AND_THEN("Static text is preferred over parameters")
+        {
+            REQUIRE(*router.find("/api/device/all", params) == 3);
+            REQUIRE(params.empty());
+            REQUIRE(*router.find("/api/device/alle", params) == 1);
+            REQUIRE(params.get("id") == "alle");
+        }
+        AND_THEN("Parameters don't match empty segments")
+        {
+            REQUIRE(router.find("/api/device/", params) == nullptr);
+            REQUIRE(router.find("/api/device//sensor/temp", params) == nullptr);
+            REQUIRE(params.empty());
+        }
+        AND_THEN("Parameters must have the same name at the same position")
+        {
+            REQUIRE_FALSE(router.add("/api/device/:name", 4));
+            REQUIRE_FALSE(router.add("/api/:", 4));
+        }
+    }
+}
+
+SCENARIO("Routing URLs with wildcards")
+{
+    GIVEN("A router with wildcard routes")
+    {
+        Router<int> router{};
+        REQUIRE(router.add("/static/*", 1));
+        REQUIRE(router.add("/static/special.css", 2));
+        REQUIRE(router.add("/files/:user/*path", 3));
+        REQUIRE(router.add("/*", 4));
+
+        RouteParameters params{};
+
+        THEN("The wildcard matches the remainder of the URL")
+        {
+            REQUIRE(*router.find("/static/css/site.css", params) == 1);
+            REQUIRE(params.get("*") == "css/site.css");
+            REQUIRE(*router.find("/static/", params) == 1);
+            REQUIRE(params.get("*").empty());
+            REQUIRE(params.contains("*"));
+
+            REQUIRE(*router.find("/files/bob/a/b.txt", params) == 3);
+            REQUIRE(params.get("user") == "bob");
+            REQUIRE(params.get("path") == "a/b.txt");
+        }
+        AND_THEN("More specific routes are preferred")
+        {
+            REQUIRE(*router.find("/static/special.css", params) == 2);
+            REQUIRE(*router.find("/static/special.cs", params) == 1);
+        }
+        AND_THEN("Falling back to a less specific route discards parameters of the failed attempt")
+        {
+            REQUIRE(*router.find("/files/bob", params) == 4);
+            REQUIRE(params.size() == 1);
+            REQUIRE(params.get("*") == "files/bob");
+        }
+        AND_THEN("Wildcards must be the last segment")
+        {
+            REQUIRE_FALSE(router.add("/a/*/b", 5));
+        }
+    }
+}
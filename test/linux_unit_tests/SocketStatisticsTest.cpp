@@ -0,0 +1,73 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include "smooth/core/network/SocketStatistics.h"
+
+using namespace smooth::core::network;
+
+SCENARIO("Socket counters")
+{
+    GIVEN("Counters with some traffic")
+    {
+        SocketCounters counters{};
+        counters.add_received(100);
+        counters.add_received(20);
+        counters.add_packet_received();
+        counters.add_sent(50);
+        counters.add_packet_sent();
+        counters.add_send_stall();
+        counters.add_tx_buffer_full();
+        counters.add_back_off();
+        counters.add_back_off();
+        counters.add_receive_call();
+        counters.add_send_call();
+        counters.add_send_call();
+
+        THEN("A snapshot holds the sums")
+        {
+            SocketStats stats{};
+            counters.copy_to(stats);
+
+            REQUIRE(stats.bytes_received == 120);
+            REQUIRE(stats.packets_received == 1);
+            REQUIRE(stats.bytes_sent == 50);
+            REQUIRE(stats.packets_sent == 1);
+            REQUIRE(stats.send_stalls == 1);
+            REQUIRE(stats.tx_buffer_full == 1);
+            REQUIRE(stats.back_offs == 2);
+            REQUIRE(stats.receive_calls == 1);
+            REQUIRE(stats.send_calls == 2);
+        }
+    }
+}
+
+SCENARIO("Dispatcher statistics")
+{
+    DispatcherStats stats{};
+
+    THEN("No wakeups means no ready sockets per wakeup")
+    {
+        REQUIRE(stats.ready_fds_per_wakeup() == Approx(0.0));
+    }
+
+    AND_THEN("Ready sockets are averaged over wakeups")
+    {
+        stats.wakeups = 4;
+        stats.ready_fds = 10;
+        REQUIRE(stats.ready_fds_per_wakeup() == Approx(2.5));
+    }
+}
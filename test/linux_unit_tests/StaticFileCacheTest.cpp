@@ -0,0 +1,220 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdio>
+#include <string>
+#include <catch2/catch.hpp>
+#include <fmt/core.h>
+#include "smooth/application/network/http/regular/StaticFileCache.h"
+#include "smooth/core/filesystem/File.h"
+
+using namespace smooth::application::network::http::regular;
+using namespace smooth::core::filesystem;
+using namespace std::chrono;
+
+namespace
+{
+    Path write_file(const std::string& name, const std::string& content)
+    {
+        Path path{ ("/tmp/smooth_static_file_cache_" + name).c_str() };
+        REQUIRE(File{ path }.write(content));
+
+        return path;
+    }
+
+    std::string content_of(const CachedFile& file)
+    {
+        return file.content ? std::string{ file.content->begin(), file.content->end() } : std::string{};
+    }
+}
+
+SCENARIO("Caching file information and content")
+{
+    GIVEN("A cache holding up to three files and 10 bytes of content")
+    {
+        FileCacheConfig config{};
+        config.max_entries = 3;
+        config.max_content_size = 10;
+        config.max_file_size = 8;
+        config.revalidate_after = hours{ 1 };
+        StaticFileCache cache{ config };
+
+        auto a = write_file("a.js", "aaaa");
+        auto b = write_file("b.css", "bbbbbbbb");
+        auto large = write_file("large.txt", "123456789");
+        Path missing{ "/tmp/smooth_static_file_cache_missing" };
+        std::remove(missing);
+
+        WHEN("Looking up files repeatedly")
+        {
+            auto first = cache.get(a);
+            auto second = cache.get(a);
+            auto not_found = cache.get(missing);
+            auto not_found_again = cache.get(missing);
+
+            THEN("The file system is only checked the first time")
+            {
+                REQUIRE(first == second);
+                REQUIRE(first->regular_file);
+                REQUIRE(first->size == 4);
+                REQUIRE(first->content_type == "text/javascript");
+                REQUIRE(first->etag == fmt::format("\"4-{:x}\"", first->last_modified));
+                REQUIRE_FALSE(first->content);
+
+                REQUIRE_FALSE(not_found->exists);
+                REQUIRE(not_found == not_found_again);
+
+                auto stats = cache.get_statistics();
+                REQUIRE(stats.misses == 2);
+                REQUIRE(stats.hits == 2);
+                REQUIRE(stats.entries == 2);
+                REQUIRE(stats.hit_rate() == Approx(0.5));
+            }
+        }
+
+        WHEN("Getting content")
+        {
+            auto first = cache.get(a, true);
+            auto second = cache.get(a, true);
+            auto too_large = cache.get(large, true);
+
+            THEN("Small files are held in memory")
+            {
+                REQUIRE(content_of(*first) == "aaaa");
+                REQUIRE(first->content == second->content);
+                REQUIRE_FALSE(too_large->content);
+
+                auto stats = cache.get_statistics();
+                REQUIRE(stats.content_misses == 1);
+                REQUIRE(stats.content_hits == 1);
+                REQUIRE(stats.content_size == 4);
+            }
+
+            AND_WHEN("Getting more content than allowed in total")
+            {
+                auto other = cache.get(b, true);
+
+                THEN("The content of the least recently used file is released, but stays valid while used")
+                {
+                    REQUIRE(content_of(*other) == "bbbbbbbb");
+                    REQUIRE(content_of(*first) == "aaaa");
+                    REQUIRE_FALSE(cache.get(a)->content);
+                    REQUIRE(cache.get_statistics().content_size == 8);
+                    REQUIRE(cache.get_statistics().evictions == 1);
+                }
+            }
+        }
+
+        WHEN("Looking up more files than the cache holds")
+        {
+            cache.get(a);
+            cache.get(b);
+            cache.get(large);
+            cache.get(a);
+            cache.get(missing);
+
+            THEN("The least recently used file is evicted")
+            {
+                auto stats = cache.get_statistics();
+                REQUIRE(stats.entries == 3);
+                REQUIRE(stats.evictions == 1);
+
+                cache.get(a);
+                REQUIRE(cache.get_statistics().hits == stats.hits + 1);
+                cache.get(b);
+                REQUIRE(cache.get_statistics().misses == stats.misses + 1);
+            }
+        }
+
+        WHEN("A file is invalidated")
+        {
+            cache.get(a, true);
+            cache.invalidate(a);
+
+            THEN("It is looked up again")
+            {
+                auto stats = cache.get_statistics();
+                REQUIRE(stats.entries == 0);
+                REQUIRE(stats.content_size == 0);
+                REQUIRE(stats.invalidations == 1);
+
+                cache.get(a);
+                REQUIRE(cache.get_statistics().misses == stats.misses + 1);
+            }
+        }
+
+        std::remove(a);
+        std::remove(b);
+        std::remove(large);
+    }
+
+    GIVEN("A cache that revalidates every lookup")
+    {
+        FileCacheConfig config{};
+        config.max_entries = 3;
+        config.max_content_size = 100;
+        config.max_file_size = 100;
+        config.revalidate_after = milliseconds{ 0 };
+        StaticFileCache cache{ config };
+
+        auto a = write_file("a.txt", "first");
+        REQUIRE(content_of(*cache.get(a, true)) == "first");
+
+        WHEN("The file changes")
+        {
+            write_file("a.txt", "second version");
+
+            THEN("The new content is read")
+            {
+                REQUIRE(content_of(*cache.get(a, true)) == "second version");
+
+                auto stats = cache.get_statistics();
+                REQUIRE(stats.invalidations == 1);
+                REQUIRE(stats.content_size == 14);
+            }
+        }
+
+        WHEN("The file is unchanged")
+        {
+            THEN("The cached content is used")
+            {
+                REQUIRE(content_of(*cache.get(a, true)) == "first");
+                REQUIRE(cache.get_statistics().revalidations == 1);
+                REQUIRE(cache.get_statistics().content_hits == 1);
+            }
+        }
+
+        std::remove(a);
+    }
+
+    GIVEN("A disabled cache")
+    {
+        StaticFileCache cache{ FileCacheConfig{} };
+        auto a = write_file("a.txt", "data");
+
+        THEN("Files are looked up every time, and their content isn't read")
+        {
+            auto first = cache.get(a, true);
+            REQUIRE(first->size == 4);
+            REQUIRE_FALSE(first->content);
+            REQUIRE(cache.get(a) != first);
+            REQUIRE(cache.get_statistics().entries == 0);
+        }
+
+        std::remove(a);
+    }
+}
@@ -16,12 +16,18 @@ limitations under the License.
 */
 
 #include <catch2/catch.hpp>
+#include <cstdio>
 #include <unordered_map>
 
 #define EXPOSE_PRIVATE_PARTS_FOR_TEST
 
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
 #include "smooth/application/network/http/regular/ITemplateDataRetriever.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/FSLock.h"
+
+using namespace smooth::core::filesystem;
+using namespace smooth::application::network::http;
 
 using namespace smooth::application::network::http::regular;
 
@@ -33,6 +39,11 @@ class DataRetriever
         {
             data.emplace("{{name}}", "Bob");
             data.emplace("{{food}}", "an ice cream");
+            data.emplace("{{title}}", "Status");
+            data.emplace("{{uptime}}", "3 days");
+            data.emplace("{{free_heap}}", "123456");
+            data.emplace("{{ip-address}}", "192.168.0.2");
+            data.emplace("{{firmware_version}}", "{{name}}");
         }
 
         std::string get(const std::string& key) const override
@@ -88,3 +99,171 @@ SCENARIO("Parsing a text with unknown tokens")
         }
     }
 }
+
+SCENARIO("Parsing texts with braces that aren't tokens")
+{
+    GIVEN("Texts")
+    {
+        THEN("Only complete tokens are replaced, and values are not parsed")
+        {
+            auto dr = std::make_shared<DataRetriever>();
+            TemplateProcessor tp({ ".html" }, dr);
+
+            for (const auto& [text, expected] : std::vector<std::pair<std::string, std::string>>{
+                     { "{{{name}}}", "{Bob}" },
+                     { "{{name}{{food}}", "{{name}an ice cream" },
+                     { "{{}}{{ name}}{{na me}}", "{{}}{{ name}}{{na me}}" },
+                     { "{{name{{food}}", "{{namean ice cream" },
+                     { "{name}}", "{name}}" },
+                     { "{{firmware_version}}", "{{name}}" },
+                     { "{{name}}{{name}}", "BobBob" },
+                     { "{{", "{{" },
+                     { "", "" } })
+            {
+                std::string data = text;
+                tp.process_template(data);
+                REQUIRE(data == expected);
+            }
+        }
+    }
+}
+
+SCENARIO("Rendering a template file")
+{
+    GIVEN("A template file")
+    {
+        FSLock::set_limit(2);
+        const auto source = Path{ "test_data" } / "template.html";
+        std::string text{};
+        REQUIRE(File{ source }.read(text));
+
+        Path path{ "/tmp/smooth_template_processor_test.html" };
+        REQUIRE(File{ path }.write(text));
+
+        auto dr = std::make_shared<DataRetriever>();
+        TemplateProcessor tp({ ".html" }, dr);
+
+        std::string expected = text;
+        tp.process_template(expected);
+
+        auto render = [&tp, &path](std::size_t chunk_size) {
+                          auto response = tp.process_template(path);
+                          REQUIRE(response);
+                          REQUIRE(response->get_response_code() == ResponseCode::OK);
+
+                          std::string res{};
+                          auto status = ResponseStatus::HasMoreData;
+
+                          while (status == ResponseStatus::HasMoreData)
+                          {
+                              std::vector<uint8_t> data{};
+                              status = response->get_data(chunk_size, data);
+                              REQUIRE(status != ResponseStatus::Error);
+                              REQUIRE(data.size() <= chunk_size);
+                              res.append(data.begin(), data.end());
+                          }
+
+                          REQUIRE(response->get_headers().at("content-length") == std::to_string(res.size()));
+
+                          return res;
+                      };
+
+        THEN("It is rendered in parts, with the same result as when rendered in memory")
+        {
+            REQUIRE(expected.find("Hello Bob, want an ice cream?") != std::string::npos);
+            REQUIRE(expected.find("{{{name}}}") == std::string::npos);
+
+            for (std::size_t chunk_size : { 1UL, 7UL, 100UL, 4096UL })
+            {
+                REQUIRE(render(chunk_size) == expected);
+            }
+        }
+
+        AND_WHEN("The file changes")
+        {
+            REQUIRE(render(100) == expected);
+            REQUIRE(File{ path }.write("Changed, {{name}}"));
+
+            THEN("It is parsed again")
+            {
+                REQUIRE(render(100) == "Changed, Bob");
+            }
+        }
+
+        AND_WHEN("The file changes after it has been looked up")
+        {
+            REQUIRE(render(100) == expected);
+            auto looked_up = CachedFile::stat(path);
+            REQUIRE(File{ path }.write(text + "more"));
+
+            THEN("The response fails rather than mixing the two versions")
+            {
+                auto response = tp.process_template(looked_up);
+                REQUIRE(response);
+
+                auto status = ResponseStatus::HasMoreData;
+
+                while (status == ResponseStatus::HasMoreData)
+                {
+                    std::vector<uint8_t> data{};
+                    status = response->get_data(100, data);
+                }
+
+                REQUIRE(status == ResponseStatus::Error);
+            }
+        }
+
+        AND_WHEN("A small template changes after it has been looked up")
+        {
+            REQUIRE(File{ path }.write("Small, {{name}}"));
+            auto looked_up = CachedFile::stat(path);
+            auto response = tp.process_template(looked_up);
+            REQUIRE(response);
+            REQUIRE(File{ path }.write("Other, {{name}}"));
+
+            THEN("The version that was parsed is sent")
+            {
+                std::vector<uint8_t> data{};
+                REQUIRE(response->get_data(100, data) == ResponseStatus::LastData);
+                REQUIRE(std::string(data.begin(), data.end()) == "Small, Bob");
+            }
+        }
+
+        AND_WHEN("More templates than are kept are rendered")
+        {
+            for (std::size_t i = 0; i <= TemplateProcessor::max_compiled; ++i)
+            {
+                Path other = Path{ "/tmp" } / ("smooth_template_processor_test_" + std::to_string(i) + ".html");
+                REQUIRE(File{ other }.write("{{name}}"));
+                REQUIRE(tp.process_template(other));
+                std::remove(other);
+            }
+
+            THEN("The least recently used are dropped")
+            {
+                REQUIRE(tp.compiled.size() == TemplateProcessor::max_compiled);
+                REQUIRE(tp.compiled.find("/tmp/smooth_template_processor_test_0.html") == tp.compiled.end());
+            }
+        }
+
+        AND_WHEN("The file is empty")
+        {
+            REQUIRE(File{ path }.write(""));
+
+            THEN("An error is returned")
+            {
+                REQUIRE(tp.process_template(path)->get_response_code() == ResponseCode::Internal_Server_Error);
+            }
+        }
+
+        AND_WHEN("The file is not a template file")
+        {
+            THEN("It isn't rendered")
+            {
+                REQUIRE_FALSE(tp.process_template(Path{ "/tmp/smooth_template_processor_test.txt" }));
+            }
+        }
+
+        std::remove(path);
+    }
+}